@@ -1,19 +1,49 @@
 #ifndef DIFFICULTYMANAGER_H_INCLUDED
 #define DIFFICULTYMANAGER_H_INCLUDED
-#pragma one
+#pragma once
+
+// Lịch tốc độ của một level: bắt đầu ở baseSpeed, mỗi interval frame tăng một nấc
+struct SpeedCurve {
+    float baseSpeed = 6.0f;
+    float increment = 0.5f;
+    int interval = 600;
+    float maxSpeed = 0.0f;   // 0: không có trần
+};
 
 class DifficultyManager {
 public:
     int survivalTime;
     float baseSpeed, currentSpeed, speedIncrement;
     int speedIncreaseInterval, nextSpeedIncrease;
+    float maxSpeed;   // > baseSpeed: tiến dần tới maxSpeed thay vì tăng mãi (endless)
+
+    static constexpr float ENDLESS_MAX_SPEED = 14.0f;
+
+    DifficultyManager() { setCurve(SpeedCurve()); reset(); }
 
-    DifficultyManager() : baseSpeed(6.0f), speedIncrement(0.5f), speedIncreaseInterval(600) { reset(); }
+    // Gọi trước reset()
+    void setCurve(const SpeedCurve& curve) {
+        baseSpeed = curve.baseSpeed;
+        speedIncrement = curve.increment;
+        speedIncreaseInterval = curve.interval;
+        maxSpeed = curve.maxSpeed;
+    }
+    // Endless luôn cần trần: giữ trần của level nếu cao hơn
+    void enableEndlessCap() {
+        if (maxSpeed < ENDLESS_MAX_SPEED) maxSpeed = ENDLESS_MAX_SPEED;
+    }
+
+    // Tốc độ sau một nấc: cộng đều, hoặc (có maxSpeed) đi một phần cố định của
+    // khoảng còn lại nên nấc đầu vẫn là speedIncrement rồi nhỏ dần
+    float stepSpeed(float speed) const {
+        if (maxSpeed <= baseSpeed) return speed + speedIncrement;
+        return speed + (maxSpeed - speed) * (speedIncrement / (maxSpeed - baseSpeed));
+    }
 
     void update() {
         survivalTime++;
         if (survivalTime >= nextSpeedIncrease) {
-            currentSpeed += speedIncrement;
+            currentSpeed = stepSpeed(currentSpeed);
             nextSpeedIncrease += speedIncreaseInterval;
         }
     }
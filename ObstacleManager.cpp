@@ -1,76 +1,145 @@
 #include "ObstacleManager.h"
-ObstacleManager::ObstacleManager(int ground, int gameSpeed, int width) {
+#include "entity_tables.h"
+// Thiên thạch rơi quá đây thì bỏ
+static const float METEOR_DEATH_Y = 500.0f;
+
+ObstacleManager::ObstacleManager(EntityRegistry* registry, int ground, const WorldScroll* scroll, int width) {
+    entities = registry;
     groundY = ground;
-    speed = gameSpeed;
+    world = scroll;
     screenWidth = width;
-    spawnTimer = 0;
+    timers = nullptr;
+    events = nullptr;
+    setSpawnWeights(nullptr);
+    reserve(DEFAULT_CAPACITY);
+    reset();
+    srand(time(NULL));
+}
+
+void ObstacleManager::reserve(int capacity) {
+    entities->reserve(ARCH_OBSTACLE, capacity);
+    int ids = entities->archetype(ARCH_OBSTACLE).capacity();
+    if ((int)shapes.size() < ids) {
+        int old = (int)shapes.size();
+        shapes.resize(ids);
+        for (int i = old; i < ids; i++) shapes[i].reserve(Obstacle::MAX_SHAPE_WIDTH, Obstacle::MAX_SHAPE_HEIGHT);
+    }
+    hitBatch.reserve(ids);
+    hitRows.reserve(ids);
+    hitMask.reserve(collisionMaskWords(ids));
+    renderList.reserve(ids);
+}
+
+void ObstacleManager::reset() {
     spawnInterval = 90;
-    meteorTimer = 0;
     meteorInterval = 300; // Thiên thạch ít xuất hiện hơn
-    srand(time(NULL));
+    autoSpawn = true;
+    clear();
+}
+
+void ObstacleManager::attach(TimerWheel* wheel, EventBus* eventBus) {
+    timers = wheel;
+    events = eventBus;
+    scheduleTimers();
+}
+
+void ObstacleManager::scheduleTimers() {
+    if (!timers) return;
+    timers->cancelAll(this);
+    spawnTimer = timers->schedule(spawnInterval, this, TIMER_SPAWN);
+    meteorTimer = timers->schedule(meteorInterval, this, TIMER_METEOR);
 }
 
 void ObstacleManager::update() {
-    for (auto& obs : obstacles) {
-        obs.update();
-    }
-    obstacles.erase(
-        std::remove_if(obstacles.begin(), obstacles.end(), [](const Obstacle& o) { return !o.active; }),
-        obstacles.end()
-    );
-
-    spawnTimer++;
-    if (spawnTimer >= spawnInterval) {
-        spawnObstacle();
-        spawnTimer = 0;
-        spawnInterval = 70 + (rand() % 50); // 70-120 frames
-    }
+    // Thiên thạch đổi worldX và có thể rơi khỏi màn hình
+    bool drifted = runMotionSystem(*entities, ARCH_OBSTACLE, METEOR_DEATH_Y);
+    runScrollSystem(*entities, ARCH_OBSTACLE, *world, drifted);
+}
 
-    meteorTimer++;
-    if (meteorTimer >= meteorInterval) {
+void ObstacleManager::onTimer(int timerId) {
+    if (timerId == TIMER_SPAWN) {
+        if (autoSpawn) spawnObstacle();
+        spawnInterval = 70 + (rand() % 50); // 70-120 frames
+        spawnTimer = timers->schedule(spawnInterval, this, TIMER_SPAWN);
+    } else if (timerId == TIMER_METEOR) {
         if (rand() % 100 < 30) { // 30% cơ hội spawn thiên thạch
             spawnMeteor();
         }
-        meteorTimer = 0;
         meteorInterval = 400 + (rand() % 200); // 400-600 frames
+        meteorTimer = timers->schedule(meteorInterval, this, TIMER_METEOR);
     }
 }
 
+void ObstacleManager::setSpawnWeights(const ObstacleWeights* weights) {
+    typePicker.build((weights ? *weights : DEFAULT_OBSTACLE_WEIGHTS).weights);
+}
+
 void ObstacleManager::spawnObstacle() {
-    int randVal = rand() % 100;
-    ObstacleType type;
-
-    if (randVal < 40) {
-        type = CACTUS_SMALL; // 40% xương rồng nhỏ
-    } else if (randVal < 65) {
-        type = CACTUS_MEDIUM; // 25% xương rồng trung
-    } else if (randVal < 80) {
-        type = CACTUS_LARGE; // 15% xương rồng lớn
-    } else if (randVal < 90) {
-        type = CACTUS_GROUP; // 10% nhóm xương rồng
-    } else if (randVal < 95) {
-        type = BIRD; // 5% chim
-    } else {
-        type = ROCK; // 5% đá
-    }
+    LibcRandom rng;
+    ObstacleType type = (ObstacleType)typePicker.sample(rng);
+    spawn(world->toWorld(screenWidth), rollObstacleSpec(type, rng), 0.0f);
+}
 
-    obstacles.emplace_back(screenWidth, groundY, speed, type);
+bool ObstacleManager::spawnAt(double worldX, const ObstacleSpec& spec) {
+    return spawn(worldX, spec, 0.0f);
 }
 
 void ObstacleManager::spawnMeteor() {
-    int meteorX = 100 + (rand() % (screenWidth - 200));
-    obstacles.emplace_back(meteorX, groundY, speed, METEOR);
+    LibcRandom rng;
+    int meteorX = rollMeteorX();
+    spawnMeteorAt(meteorX, rollObstacleSpec(METEOR, rng));
+}
+
+void ObstacleManager::spawnMeteorAt(int meteorX, const ObstacleSpec& spec) {
+    // Bay theo chiều cuộn với nửa tốc độ lúc xuất hiện: trên màn hình trôi bằng nửa nền
+    if (!spawn(world->toWorld(meteorX), spec, world->getSpeed() / 2)) return;
+    if (events) events->publish(GameEvent::meteorSpawned(meteorX));
+}
+
+// Chừa 100 px ở hai mép màn hình
+int ObstacleManager::rollMeteorX() const {
+    return 100 + (rand() % (screenWidth - 200));
+}
+
+bool ObstacleManager::spawn(double worldX, const ObstacleSpec& spec, float drift) {
+    int row = entities->create(ARCH_OBSTACLE, worldX);
+    if (row < 0) return false;
+    Archetype& arch = entities->archetype(ARCH_OBSTACLE);
+    Obstacle::spawn(arch, row, groundY, spec, drift);
+    entities->noteWidth(ARCH_OBSTACLE, arch.width(row));
+    Obstacle::bakeShape(shapes[arch.entity(row)], spec.type, arch.width(row), arch.height(row), arch.variant(row));
+    return true;
 }
 
 void ObstacleManager::render(SDL_Renderer* renderer) {
-    for (auto& obs : obstacles) {
-        obs.render(renderer);
-    }
+    buildRenderList(*entities, ARCH_OBSTACLE, *world, screenWidth, renderList);
+    for (const RenderItem& item : renderList) Obstacle::render(renderer, item);
 }
 
-bool ObstacleManager::checkCollisionWithPlayer(int px, int py, int pwidth, int pheight) {
-    for (auto& obs : obstacles) {
-        if (obs.checkCollision(px, py, pwidth, pheight)) {
+bool ObstacleManager::checkCollisionWithPlayer(int px, int py, int pwidth, int pheight,
+                                               const CollisionMask* playerMask) {
+    double left = world->toWorld(px);
+    entities->setCosmeticLine(ARCH_OBSTACLE, left);
+    gatherRects(*entities, ARCH_OBSTACLE, *world, left, left + pwidth, ENTITY_ALIVE, hitBatch, hitRows);
+    if (hitRows.empty()) return false;
+
+    hitMask.resize(collisionMaskWords(hitBatch.size()));
+    collideRects(hitBatch, CollisionRect::fromRect(px, py - pheight, pwidth, pheight), hitMask.data());
+    Archetype& arch = entities->archetype(ARCH_OBSTACLE);
+    for (int i = 0; i < (int)hitRows.size(); i++) {
+        if (!collisionMaskTest(hitMask.data(), i)) continue;
+        if (!playerMask) return true;
+
+        // Narrowphase: mask người chơi đặt góc trên trái ở (px, py - pheight);
+        // vị trí vật lấy từ lô (đã tính nhấp nhô)
+        int row = hitRows[i];
+        int x = (int)hitBatch.left[i];
+        int top = (int)hitBatch.top[i];
+        const CollisionMask& shape = shapes[arch.entity(row)];
+        if (shape.empty()) {
+            SDL_Rect box{ x, top, arch.width(row), arch.height(row) };
+            if (playerMask->overlapsRect(px, py - pheight, box)) return true;
+        } else if (CollisionMask::overlaps(*playerMask, px, py - pheight, shape, x, top)) {
             return true;
         }
     }
@@ -78,16 +147,6 @@ bool ObstacleManager::checkCollisionWithPlayer(int px, int py, int pwidth, int p
 }
 
 void ObstacleManager::clear() {
-    obstacles.clear();
-    spawnTimer = 0;
-    meteorTimer = 0;
-}
-
-void ObstacleManager::setSpeed(int newSpeed) {
-    speed = newSpeed;
-    for (auto& obs : obstacles) {
-        if (obs.type != METEOR) {
-            obs.speed = newSpeed;
-        }
-    }
+    entities->clear(ARCH_OBSTACLE);
+    scheduleTimers();
 }
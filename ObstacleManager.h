@@ -1,33 +1,74 @@
 #ifndef OBSTACLEMANAGER_H_INCLUDED
 #define OBSTACLEMANAGER_H_INCLUDED
 #include "obstacle.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
+#include "ecs.h"
+#include "collision_kernels.h"
+#include "alias_table.h"
 #include <vector>
 
-class ObstacleManager {
+// Mặt tiền của archetype ARCH_OBSTACLE: timer spawn, va chạm, vẽ
+class ObstacleManager : public TimerListener {
 public:
-    std::vector<Obstacle> obstacles;
-    int spawnTimer;
+    TimerHandle spawnTimer;
     int spawnInterval;
-    int meteorTimer;
+    TimerHandle meteorTimer;
     int meteorInterval;
     int groundY;
-    int speed;
     int screenWidth;
+    bool autoSpawn;       // false: vật cản thường do BeatScheduler gọi spawnObstacle()
 
     // Constructor
-    ObstacleManager(int ground, int gameSpeed, int width);
+    ObstacleManager(EntityRegistry* registry, int ground, const WorldScroll* scroll, int width);
+
+    // Hẹn timer spawn trên wheel (gọi lại sau mỗi lần tạo mới ObstacleManager)
+    void attach(TimerWheel* wheel, EventBus* eventBus);
+    // Sức chứa archetype và bộ đệm va chạm; chỉ tăng, gọi lúc vào level
+    void reserve(int capacity);
+    // Bảng trọng số loại vật cản của level (nullptr: mặc định)
+    void setSpawnWeights(const ObstacleWeights* weights);
 
     // Public methods
     void update();
     void render(SDL_Renderer* renderer);
-    bool checkCollisionWithPlayer(int px, int py, int pwidth, int pheight);
-    void clear();
-    void setSpeed(int newSpeed);
+    // playerMask (cỡ pwidth x pheight) != nullptr: AABB chạm rồi mới so từng pixel
+    bool checkCollisionWithPlayer(int px, int py, int pwidth, int pheight,
+                                  const CollisionMask* playerMask = nullptr);
+    void reset();   // Về khoảng spawn mặc định rồi clear()
+    void clear();   // Giữ sức chứa
+    void spawnObstacle();
+    // Vật cản đã chọn sẵn (LevelGenerator) ở worldX
+    bool spawnAt(double worldX, const ObstacleSpec& spec);
+    // Thiên thạch rơi chéo theo timer, ở x màn hình rollMeteorX()
+    void spawnMeteor();
+    // Thiên thạch đã chọn sẵn (kịch bản của level) ở x màn hình meteorX
+    void spawnMeteorAt(int meteorX, const ObstacleSpec& spec);
+    int rollMeteorX() const;
+    void onTimer(int timerId) override;
 
 private:
+    enum { TIMER_SPAWN, TIMER_METEOR };
+    static const int DEFAULT_CAPACITY = 16;
+
+    EntityRegistry* entities;
+    const WorldScroll* world;
+    TimerWheel* timers;
+    EventBus* events;
+    AliasTable<OBSTACLE_TYPE_COUNT> typePicker;
+
+    // Hình dạng theo chỉ số entity (nằm ngoài chunk vì cỡ thay đổi)
+    std::vector<CollisionMask> shapes;
+
+    // Bộ đệm kiểm tra va chạm và vẽ (giữ lại giữa các frame để khỏi cấp phát)
+    RectBatch hitBatch;
+    std::vector<int> hitRows;
+    std::vector<Uint32> hitMask;
+    std::vector<RenderItem> renderList;
+
     // Private helper methods
-    void spawnObstacle();
-    void spawnMeteor();
+    void scheduleTimers();
+    bool spawn(double worldX, const ObstacleSpec& spec, float drift);
 };
 
 
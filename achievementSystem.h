@@ -6,7 +6,11 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <algorithm>
+#include <unordered_map>
 #include "player.h"
+#include "timer_wheel.h"
+#include "content_db.h"
 
 enum class AchievementTab {
     ALL,
@@ -15,64 +19,60 @@ enum class AchievementTab {
     RARE
 };
 
+// Phần tĩnh nằm trong content DB (AchievementDef); ở đây chỉ có trạng thái mở khoá/tiến độ
 struct Achievement {
-    int id;
-    std::string name, description;
+    enum Type { SCORE, COINS, COMBO, LEVEL, TYPE_COUNT };
+
+    const AchievementDef* def;
     bool unlocked;
     bool rewardClaimed;
-    int reward;
-    enum Type { SCORE, COINS, COMBO, LEVEL } type;
-    int requirement;
     int currentProgress;
 
-    Achievement(int qid, const std::string& n, const std::string& desc, int coins, Type qtype, int req)
-        : id(qid), name(n), description(desc), unlocked(false), rewardClaimed(false),
-          reward(coins), type(qtype), requirement(req), currentProgress(0) {}
+    explicit Achievement(const AchievementDef& achievementDef)
+        : def(&achievementDef), unlocked(false), rewardClaimed(false), currentProgress(0) {}
 
-    Achievement() : id(0), name(""), description(""), unlocked(false), rewardClaimed(false),
-          reward(0), type(SCORE), requirement(0), currentProgress(0) {}
+    int id() const { return def->id; }
+    Type type() const { return (Type)def->type; }
+    int requirement() const { return def->requirement; }
+    int reward() const { return def->reward; }
+    const char* name() const { return gameContent().text(def->name); }
+    const char* description() const { return gameContent().text(def->description); }
 };
 
-class AchievementSystem {
+SDL_COMPILE_TIME_ASSERT(achievement_type_count, Achievement::TYPE_COUNT == CONTENT_ACHIEVEMENT_TYPES);
+
+class AchievementSystem : public TimerListener {
 public:
     std::vector<Achievement> achievements;
     std::vector<int> unlockedThisSession;
-    int notificationTimer, currentNotification;
+    TimerHandle notificationTimer;
+    int currentNotification;   // -1 khi không có thông báo
+    const bool persistent;     // false: không ghi achievements.dat (soak test)
 
-    AchievementSystem() {
-        notificationTimer = 0; currentNotification = -1;
+    // persistent đặt ngay từ đầu: loadProgress có thể mở khoá rồi lưu ngay trong constructor
+    explicit AchievementSystem(bool persist = true) : persistent(persist) {
+        timers = nullptr; currentNotification = -1;
         initializeAchievements();
         loadProgress();
     }
 
+    Achievement* findAchievement(int achievementId) {
+        auto it = indexById.find(achievementId);
+        return it == indexById.end() ? nullptr : &achievements[it->second];
+    }
+
     void initializeAchievements() {
-        achievements = {
-            {0, "First Steps", "Score 50 points", 20, Achievement::SCORE, 50},
-            {1, "Century", "Score 100 points", 50, Achievement::SCORE, 100},
-            {2, "High Scorer", "Score 200 points", 100, Achievement::SCORE, 200},
-            {3, "Pro Gamer", "Score 500 points", 250, Achievement::SCORE, 500},
-            {100, "Legendary", "Score 1000 points", 500, Achievement::SCORE, 1000},
-
-            {4, "Coin Collector", "Collect 50 coins", 30, Achievement::COINS, 50},
-            {5, "Getting Rich", "Collect 200 coins", 75, Achievement::COINS, 200},
-            {6, "Wealthy", "Collect 500 coins", 150, Achievement::COINS, 500},
-            {101, "Millionaire", "Collect 1000 coins", 500, Achievement::COINS, 1000},
-
-            {7, "Combo Starter", "Reach 10x combo", 50, Achievement::COMBO, 10},
-            {8, "Combo Master", "Reach 20x combo", 150, Achievement::COMBO, 20},
-            {102, "Untouchable", "Reach 30x combo", 500, Achievement::COMBO, 30},
-
-            {10, "Explorer", "Complete Level 2", 75, Achievement::LEVEL, 2},
-            {11, "Adventurer", "Complete Level 3", 100, Achievement::LEVEL, 3},
-            {12, "Conqueror", "Complete Level 5", 250, Achievement::LEVEL, 5},
-            {103, "World Wanderer", "Complete Level 10", 600, Achievement::LEVEL, 10}
-        };
+        const ContentDB& content = gameContent();
+        achievements.clear();
+        achievements.reserve(content.achievementCount());
+        for (int i = 0; i < content.achievementCount(); i++) achievements.push_back(Achievement(content.achievement(i)));
+        rebuildIndex();
     }
 
     std::vector<Achievement*> getDisplayAchievements(AchievementTab currentTab) {
         std::vector<Achievement*> displayList;
         auto isRare = [](const Achievement& ach) {
-            return ach.reward >= 500;
+            return ach.reward() >= 500;
         };
         auto matchesTab = [&](const Achievement& ach) {
             switch(currentTab) {
@@ -86,7 +86,7 @@ public:
 
 
         auto isAdded = [&](int achId) {
-            for(auto* p : displayList) if(p->id == achId) return true;
+            for(auto* p : displayList) if(p->id() == achId) return true;
             return false;
         };
 
@@ -94,77 +94,58 @@ public:
         for (auto& ach : achievements) {
             if (ach.unlocked && !ach.rewardClaimed && matchesTab(ach)) {
                 displayList.push_back(&ach);
-                if (displayList.size() >= 3) return displayList;
+                if (displayList.size() >= 3) break;
             }
         }
 
         for (auto& ach : achievements) {
-            if (!ach.unlocked && matchesTab(ach) && !isAdded(ach.id)) {
+            if (displayList.size() >= 3) break;
+            if (!ach.unlocked && matchesTab(ach) && !isAdded(ach.id())) {
                 displayList.push_back(&ach);
-                if (displayList.size() >= 3) return displayList;
             }
         }
 
 
         for (auto& ach : achievements) {
-            if (ach.unlocked && ach.rewardClaimed && matchesTab(ach) && !isAdded(ach.id)) {
+            if (displayList.size() >= 3) break;
+            if (ach.unlocked && ach.rewardClaimed && matchesTab(ach) && !isAdded(ach.id())) {
                 displayList.push_back(&ach);
-                if (displayList.size() >= 3) return displayList;
             }
         }
 
+        for (auto* ach : displayList) syncProgress(*ach);
         return displayList;
     }
 
     void claimReward(int achievementId, Player& player) {
-        for (auto& ach : achievements) {
-            if (ach.id == achievementId && ach.unlocked && !ach.rewardClaimed) {
-                player.totalCoins += ach.reward;
-                player.addXp(ach.reward);
-                ach.rewardClaimed = true;
-                saveProgress();
-                return;
-            }
+        Achievement* ach = findAchievement(achievementId);
+        if (ach && ach->unlocked && !ach->rewardClaimed) {
+            player.totalCoins += ach->reward();
+            player.addXp(ach->reward());
+            ach->rewardClaimed = true;
+            saveProgress();
         }
     }
 
     bool isRewardClaimed(int achievementId) {
-        for (const auto& ach : achievements) {
-            if (ach.id == achievementId) {
-                return ach.rewardClaimed;
-            }
-        }
-        return false;
+        Achievement* ach = findAchievement(achievementId);
+        return ach && ach->rewardClaimed;
     }
 
+    // Gọi mỗi frame; chỉ số nào không đổi thì không tốn gì
     void checkAchievements(int score, int coins, int maxCombo, int levelCompleted) {
-        for (auto& ach : achievements) {
-            if (ach.type == Achievement::SCORE) {
-                ach.currentProgress = std::max(ach.currentProgress, score);
-            } else if (ach.type == Achievement::COINS) {
-                ach.currentProgress = coins;
-            } else if (ach.type == Achievement::COMBO) {
-                ach.currentProgress = std::max(ach.currentProgress, maxCombo);
-            } else if (ach.type == Achievement::LEVEL) {
-                ach.currentProgress = std::max(ach.currentProgress, levelCompleted);
-            }
-
-            if (!ach.unlocked && ach.currentProgress >= ach.requirement) {
-                ach.unlocked = true;
-                unlockedThisSession.push_back(ach.id);
-                notificationTimer = 180;
-                currentNotification = ach.id;
-                saveProgress();
-            }
-        }
+        advanceMetric(Achievement::SCORE, score);
+        advanceMetric(Achievement::COINS, coins);
+        advanceMetric(Achievement::COMBO, maxCombo);
+        advanceMetric(Achievement::LEVEL, levelCompleted);
     }
 
-    void update() { if (notificationTimer > 0) notificationTimer--; }
+    void attach(TimerWheel* wheel) { timers = wheel; }
+    void onTimer(int timerId) override { currentNotification = -1; }
 
     void render(SDL_Renderer* renderer, TTF_Font* fontBig, TTF_Font* fontSmall, int screenWidth, int screenHeight) {
-        if (notificationTimer > 0 && currentNotification != -1) {
-             Achievement* ach = nullptr;
-             for(auto& a : achievements) if(a.id == currentNotification) ach = &a;
+        if (currentNotification != -1) {
+             Achievement* ach = findAchievement(currentNotification);
              if(!ach) return;
 
             int boxW = 400, boxH = 100, boxX = screenWidth/2-boxW/2, boxY = 50;
@@ -174,11 +155,13 @@ public:
     }
 
     void saveProgress() {
+        if (!persistent) return;
         std::ofstream file("achievements.dat");
         if (file.is_open()) {
+            for (auto& ach : achievements) syncProgress(ach);
             file << achievements.size() << "\n";
             for (const auto& ach : achievements) {
-                file << ach.id << " "
+                file << ach.id() << " "
                      << ach.unlocked << " "
                      << ach.rewardClaimed << " "
                      << ach.currentProgress << "\n";
@@ -205,20 +188,22 @@ public:
 
             file >> id >> unlocked >> rewardClaimed >> currentProgress;
             if (file.fail()) break;
-            for (auto& ach : achievements) {
-                if (ach.id == id) {
-                    ach.unlocked = unlocked;
-                    ach.rewardClaimed = rewardClaimed;
-                    ach.currentProgress = currentProgress;
-                    break;
-                }
+            Achievement* ach = findAchievement(id);
+            if (ach) {
+                ach->unlocked = unlocked;
+                ach->rewardClaimed = rewardClaimed;
+                ach->currentProgress = currentProgress;
             }
         }
         file.close();
+        rebuildIndex();
     }
     int getTotalRewardsEarned() {
         int total = 0;
-        for (int id : unlockedThisSession) for(const auto& a : achievements) if(a.id == id) total += a.reward;
+        for (int id : unlockedThisSession) {
+            Achievement* ach = findAchievement(id);
+            if (ach) total += ach->reward();
+        }
         return total;
     }
     void clearSessionRewards() { unlockedThisSession.clear(); }
@@ -226,6 +211,73 @@ public:
         initializeAchievements();
         saveProgress();
     }
+
+private:
+    // Mỗi chỉ số một danh sách chỉ số mảng xếp theo requirement tăng dần;
+    // cursor trỏ tới mục đầu tiên chưa vượt ngưỡng nên mỗi lần tăng chỉ số
+    // chỉ đi tiếp từ đó (O(1) khấu hao). metricBest là giá trị tốt nhất đã thấy
+    // (COINS là số xu hiện tại, như trước), currentProgress đồng bộ khi cần.
+    TimerWheel* timers;
+    std::unordered_map<int, int> indexById;
+    std::vector<int> byThreshold[Achievement::TYPE_COUNT];
+    size_t cursor[Achievement::TYPE_COUNT];
+    int metricBest[Achievement::TYPE_COUNT];
+
+    void rebuildIndex() {
+        indexById.clear();
+        for (int t = 0; t < Achievement::TYPE_COUNT; t++) {
+            byThreshold[t].clear();
+            cursor[t] = 0;
+            metricBest[t] = 0;
+        }
+        for (int i = 0; i < (int)achievements.size(); i++) {
+            const Achievement& ach = achievements[i];
+            indexById[ach.id()] = i;
+            byThreshold[ach.type()].push_back(i);
+            // Tiến độ đã lưu là giá trị chỉ số lần cuối, coi như đã thấy
+            if (ach.type() == Achievement::COINS || ach.currentProgress > metricBest[ach.type()]) {
+                metricBest[ach.type()] = ach.currentProgress;
+            }
+        }
+        for (int t = 0; t < Achievement::TYPE_COUNT; t++) {
+            std::stable_sort(byThreshold[t].begin(), byThreshold[t].end(), [this](int a, int b) {
+                return achievements[a].requirement() < achievements[b].requirement();
+            });
+            advanceCursor((Achievement::Type)t);
+        }
+    }
+
+    void advanceMetric(Achievement::Type type, int value) {
+        int next = type == Achievement::COINS ? value : std::max(metricBest[type], value);
+        if (next == metricBest[type]) return;
+        metricBest[type] = next;
+        advanceCursor(type);
+    }
+
+    void advanceCursor(Achievement::Type type) {
+        std::vector<int>& list = byThreshold[type];
+        size_t& at = cursor[type];
+        bool changed = false;
+        while (at < list.size() && achievements[list[at]].requirement() <= metricBest[type]) {
+            Achievement& ach = achievements[list[at++]];
+            if (ach.unlocked) continue;
+            syncProgress(ach);
+            ach.unlocked = true;
+            unlockedThisSession.push_back(ach.id());
+            if (timers) {
+                timers->cancel(notificationTimer);
+                notificationTimer = timers->schedule(180, this, 0);
+                currentNotification = ach.id();
+            }
+            changed = true;
+        }
+        if (changed) saveProgress();
+    }
+
+    void syncProgress(Achievement& ach) {
+        ach.currentProgress = ach.type() == Achievement::COINS ? metricBest[ach.type()]
+                                                               : std::max(ach.currentProgress, metricBest[ach.type()]);
+    }
 };
 
 
@@ -137,25 +137,25 @@ void AchievementScreen::renderAchievementList(SDL_Renderer* renderer, TTF_Font*
         const Achievement& ach = *ach_ptr;
 
         SDL_Rect rect = {50, currentY, screenW - 100, achHeight};
-        SDL_Color bgColor = ach.unlocked ? (ach.reward >= 500 ? (SDL_Color){255, 140, 0, 255} : (SDL_Color){0, 100, 0, 255}) : (SDL_Color){50, 50, 50, 255};
+        SDL_Color bgColor = ach.unlocked ? (ach.reward() >= 500 ? (SDL_Color){255, 140, 0, 255} : (SDL_Color){0, 100, 0, 255}) : (SDL_Color){50, 50, 50, 255};
 
         SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, 255);
         SDL_RenderFillRect(renderer, &rect);
 
-        renderText(renderer, fontMedium, ach.name, white, rect.x + 10, rect.y + 5);
+        renderText(renderer, fontMedium, ach.name(), white, rect.x + 10, rect.y + 5);
 
-        std::string progressText = ach.unlocked ? "Unlocked!" : ("Progress: " + std::to_string(ach.currentProgress) + "/" + std::to_string(ach.requirement));
+        std::string progressText = ach.unlocked ? "Unlocked!" : ("Progress: " + std::to_string(ach.currentProgress) + "/" + std::to_string(ach.requirement()));
         renderText(renderer, fontSmall, progressText, ach.unlocked ? gold : gray, rect.x + 10, rect.y + 35);
         std::stringstream ss;
-        ss << "+" << ach.reward << " COINS";
+        ss << "+" << ach.reward() << " COINS";
         renderText(renderer, fontMedium, ss.str(), gold, rect.x + rect.w - 150, rect.y + 15);
 
-        if (ach.unlocked && !achievementSystem.isRewardClaimed(ach.id)) {
+        if (ach.unlocked && !achievementSystem.isRewardClaimed(ach.id())) {
             SDL_Rect claimBtn = {rect.x + rect.w - 80, rect.y + 10, 70, 40};
             SDL_SetRenderDrawColor(renderer, 0, 200, 0, 255);
             SDL_RenderFillRect(renderer, &claimBtn);
             renderCenteredText(renderer, fontSmall, "CLAIM", white, claimBtn.y + 10, claimBtn.x + claimBtn.w / 2);
-        } else if (ach.unlocked && achievementSystem.isRewardClaimed(ach.id)) {
+        } else if (ach.unlocked && achievementSystem.isRewardClaimed(ach.id())) {
             renderCenteredText(renderer, fontSmall, "CLAIMED", gray, rect.y + 25, rect.x + rect.w - 45);
         }
 
@@ -210,15 +210,15 @@ bool AchievementScreen::handleInput(SDL_Event& e, int screenW, int screenH, Achi
 
             SDL_Rect rect = {50, currentY, screenW - 100, achHeight};
 
-            if (ach.unlocked && !achievementSystem.isRewardClaimed(ach.id)) {
+            if (ach.unlocked && !achievementSystem.isRewardClaimed(ach.id())) {
                 SDL_Rect claimBtn = {rect.x + rect.w - 80, rect.y + 10, 70, 40};
 
                 if (mx >= claimBtn.x && mx <= claimBtn.x + claimBtn.w && my >= claimBtn.y && my <= claimBtn.y + claimBtn.h) {
-                    achievementSystem.claimReward(ach.id, player);
+                    achievementSystem.claimReward(ach.id(), player);
 
                     triggerParticleBurst((float)claimBtn.x + claimBtn.w / 2, (float)claimBtn.y + claimBtn.h / 2, 20);
 
-                    std::cout << "Attempting to claim achievement: " << ach.name << std::endl;
+                    std::cout << "Attempting to claim achievement: " << ach.name() << std::endl;
                     return false;
                 }
             }
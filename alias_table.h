@@ -0,0 +1,72 @@
+#ifndef ALIAS_TABLE_H_INCLUDED
+#define ALIAS_TABLE_H_INCLUDED
+
+#include <cstdlib>
+#include <cstddef>
+#include "random_stream.h"
+
+// Mọi trọng số >= 0 và tổng dương, vừa với rand() (RAND_MAX có thể chỉ 32767)
+template <size_t N>
+constexpr bool weightsValid(const int (&weights)[N]) {
+    int total = 0;
+    for (size_t i = 0; i < N; i++) {
+        if (weights[i] < 0) return false;
+        total += weights[i];
+    }
+    return total > 0 && total <= 32767;
+}
+
+// Lấy mẫu theo trọng số O(1) (phương pháp alias của Vose). Bảng dùng số
+// nguyên: cột i được giữ với xác suất prob[i] / total, không thì trả về
+// alias[i], nên phân phối đúng bằng trọng số chừng nào rng.below() đều nhau
+// (LibcRandom và RandomStream đều loại lệch modulo). build() không cấp phát.
+template <int N>
+class AliasTable {
+public:
+    AliasTable() : total(0) {
+        for (int i = 0; i < N; i++) { prob[i] = 0; alias[i] = i; }
+    }
+
+    // weights phải thoả weightsValid
+    void build(const int (&weights)[N]) {
+        total = 0;
+        for (int i = 0; i < N; i++) total += weights[i];
+
+        int scaled[N], small[N], large[N];
+        int smallCount = 0, largeCount = 0;
+        for (int i = 0; i < N; i++) {
+            scaled[i] = weights[i] * N;   // So với total: cột đầy khi scaled == total
+            if (scaled[i] < total) small[smallCount++] = i;
+            else large[largeCount++] = i;
+        }
+        while (smallCount > 0 && largeCount > 0) {
+            int s = small[--smallCount], l = large[--largeCount];
+            prob[s] = scaled[s];
+            alias[s] = l;
+            scaled[l] -= total - scaled[s];
+            if (scaled[l] < total) small[smallCount++] = l;
+            else large[largeCount++] = l;
+        }
+        while (largeCount > 0) { int l = large[--largeCount]; prob[l] = total; alias[l] = l; }
+        while (smallCount > 0) { int s = small[--smallCount]; prob[s] = total; alias[s] = s; }
+    }
+
+    // rng: LibcRandom (main thread) hoặc RandomStream có seed
+    template <typename Rng>
+    int sample(Rng& rng) const {
+        int column = rng.below(N);
+        return rng.below(total) < prob[column] ? column : alias[column];
+    }
+
+    int sample() const {
+        LibcRandom rng;
+        return sample(rng);
+    }
+
+private:
+    int total;
+    int prob[N];
+    int alias[N];
+};
+
+#endif // ALIAS_TABLE_H_INCLUDED
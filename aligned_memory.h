@@ -0,0 +1,34 @@
+#ifndef ALIGNED_MEMORY_H_INCLUDED
+#define ALIGNED_MEMORY_H_INCLUDED
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Cấp phát căn lề không cần aligned new của C++17 (MinGW gcc 8 mặc định gnu++14).
+// alignment là luỹ thừa của 2 và bội của sizeof(void*). Ném std::bad_alloc khi hết bộ nhớ.
+inline void* alignedAlloc(size_t size, size_t alignment) {
+    if (size == 0) size = alignment;
+#ifdef _WIN32
+    void* p = _aligned_malloc(size, alignment);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, alignment, size) != 0) p = nullptr;
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+// Giải phóng vùng cấp bởi alignedAlloc (nullptr thì bỏ qua)
+inline void alignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+#endif // ALIGNED_MEMORY_H_INCLUDED
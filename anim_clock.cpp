@@ -0,0 +1,29 @@
+#include "anim_clock.h"
+#include <cmath>
+
+static const int SINE_TABLE_SIZE = 4096;   // Lũy thừa của 2: lấy chỉ số bằng phép AND
+static const double TWO_PI = 6.283185307179586;
+
+// Thêm một mẫu cuối (= mẫu đầu) để nội suy không phải quay vòng.
+// Dựng lần đầu được dùng (an toàn cả khi gọi trong khởi tạo tĩnh).
+struct SineTable {
+    float samples[SINE_TABLE_SIZE + 1];
+
+    SineTable() {
+        for (int i = 0; i <= SINE_TABLE_SIZE; i++) samples[i] = (float)std::sin(TWO_PI * i / SINE_TABLE_SIZE);
+    }
+};
+
+float lutSin(float radians) {
+    static const SineTable table;
+    const float* sineTable = table.samples;
+    double t = radians * (SINE_TABLE_SIZE / TWO_PI);
+    double whole = std::floor(t);
+    int i = (int)((long long)whole & (SINE_TABLE_SIZE - 1));
+    float frac = (float)(t - whole);
+    return sineTable[i] + (sineTable[i + 1] - sineTable[i]) * frac;
+}
+
+float lutCos(float radians) {
+    return lutSin(radians + (float)(TWO_PI / 4));
+}
@@ -0,0 +1,27 @@
+#ifndef ANIM_CLOCK_H_INCLUDED
+#define ANIM_CLOCK_H_INCLUDED
+
+#include <SDL2/SDL.h>
+
+// Đồng hồ hoạt ảnh chung: đếm frame PLAYING. Thực thể chỉ nhớ tick lúc sinh;
+// xoay, nhịp scale, quầng sáng, vỗ cánh, nhấp nhô đều tính từ tuổi
+// (now - birth) lúc vẽ nên update không đụng tới chúng, và cùng một tick
+// (kể cả khi phát lại) luôn cho cùng một hình.
+class AnimationClock {
+public:
+    AnimationClock() : tick(0) {}
+
+    void advance() { tick++; }
+    Uint32 now() const { return tick; }
+    // alpha: phần frame đã trôi tính từ tick hiện tại (0 nếu không nội suy)
+    float ageOf(Uint32 birth, float alpha = 0.0f) const { return (float)(tick - birth) + alpha; }
+
+private:
+    Uint32 tick;
+};
+
+// sin/cos tra bảng 4096 mẫu một chu kỳ, nội suy tuyến tính (sai số < 3e-7)
+float lutSin(float radians);
+float lutCos(float radians);
+
+#endif // ANIM_CLOCK_H_INCLUDED
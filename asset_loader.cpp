@@ -0,0 +1,209 @@
+#include "asset_loader.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+// ===================== ASSET LOADER IMPLEMENTATION =====================
+
+AssetLoader::AssetLoader()
+    : pack(nullptr), mutex(nullptr), wake(nullptr), stopping(false),
+      inFlight(0), requestedCount(0), finishedCount(0) {}
+
+AssetLoader::~AssetLoader() {
+    shutdown();
+}
+
+bool AssetLoader::start(int workerCount) {
+    if (!workers.empty()) return true;
+
+    if (workerCount <= 0) {
+        workerCount = std::max(1, std::min(4, SDL_GetCPUCount() - 1));
+    }
+
+    mutex = SDL_CreateMutex();
+    wake = SDL_CreateCond();
+    if (!mutex || !wake) {
+        std::cerr << "AssetLoader: " << SDL_GetError() << ". Loading synchronously." << std::endl;
+        return false;
+    }
+
+    stopping = false;
+    for (int i = 0; i < workerCount; i++) {
+        SDL_Thread* thread = SDL_CreateThread(workerMain, "AssetWorker", this);
+        if (!thread) {
+            std::cerr << "AssetLoader: SDL_CreateThread Error: " << SDL_GetError() << std::endl;
+            break;
+        }
+        workers.push_back(thread);
+    }
+    return !workers.empty();
+}
+
+void AssetLoader::shutdown() {
+    if (mutex) {
+        SDL_LockMutex(mutex);
+        stopping = true;
+        SDL_CondBroadcast(wake);
+        SDL_UnlockMutex(mutex);
+    }
+    for (SDL_Thread* thread : workers) {
+        SDL_WaitThread(thread, nullptr);
+    }
+    workers.clear();
+
+    // Job chưa kịp xử lý thì bỏ, surface đã decode thì giải phóng
+    for (AssetJob* job : pending) delete job;
+    for (AssetJob* job : completed) {
+        if (job->surface) SDL_FreeSurface(job->surface);
+        delete job;
+    }
+    pending.clear();
+    completed.clear();
+    inFlight = 0;
+
+    if (wake) { SDL_DestroyCond(wake); wake = nullptr; }
+    if (mutex) { SDL_DestroyMutex(mutex); mutex = nullptr; }
+}
+
+bool AssetLoader::hasAsset(const std::string& path) const {
+    if (pack && pack->find(path)) return true;
+    std::ifstream file(path, std::ios::binary);
+    return file.is_open();
+}
+
+void AssetLoader::requestImage(const std::string& path, std::function<void(SDL_Surface*)> onImage) {
+    AssetJob* job = new AssetJob();
+    job->kind = AssetKind::IMAGE;
+    job->path = path;
+    job->surface = nullptr;
+    job->onImage = onImage;
+    enqueue(job);
+}
+
+void AssetLoader::requestBytes(const std::string& path, std::function<void(AssetBlob&)> onBytes) {
+    AssetJob* job = new AssetJob();
+    job->kind = AssetKind::BYTES;
+    job->path = path;
+    job->surface = nullptr;
+    job->onBytes = onBytes;
+    enqueue(job);
+}
+
+void AssetLoader::enqueue(AssetJob* job) {
+    inFlight++;
+    requestedCount++;
+
+    // Không có worker thì nạp luôn trên main thread
+    if (workers.empty()) {
+        runJob(*job);
+        completed.push_back(job);
+        return;
+    }
+
+    SDL_LockMutex(mutex);
+    pending.push_back(job);
+    SDL_CondSignal(wake);
+    SDL_UnlockMutex(mutex);
+}
+
+int AssetLoader::workerMain(void* data) {
+    AssetLoader* loader = static_cast<AssetLoader*>(data);
+
+    while (true) {
+        SDL_LockMutex(loader->mutex);
+        while (loader->pending.empty() && !loader->stopping) {
+            SDL_CondWait(loader->wake, loader->mutex);
+        }
+        if (loader->stopping) {
+            SDL_UnlockMutex(loader->mutex);
+            return 0;
+        }
+        AssetJob* job = loader->pending.front();
+        loader->pending.pop_front();
+        SDL_UnlockMutex(loader->mutex);
+
+        loader->runJob(*job);
+
+        SDL_LockMutex(loader->mutex);
+        loader->completed.push_back(job);
+        SDL_UnlockMutex(loader->mutex);
+    }
+}
+
+void AssetLoader::runJob(AssetJob& job) {
+    const PackEntry* entry = pack ? pack->find(job.path) : nullptr;
+
+    if (job.kind == AssetKind::IMAGE) {
+        if (entry && entry->kind == PACK_RGBA) {
+            job.surface = pack->createSurface(*entry);
+        } else if (entry) {
+            job.surface = IMG_Load_RW(pack->openRW(*entry), 1);
+        } else {
+            job.surface = IMG_Load(job.path.c_str());
+        }
+        return;
+    }
+
+    if (entry) {
+        job.blob.data = pack->entryData(*entry);
+        job.blob.size = static_cast<size_t>(entry->size);
+        return;
+    }
+
+    std::ifstream file(job.path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return;
+    std::streamsize size = file.tellg();
+    if (size <= 0) return;
+    file.seekg(0, std::ios::beg);
+    job.blob.owned.resize(static_cast<size_t>(size));
+    if (!file.read(job.blob.owned.data(), size)) {
+        job.blob.owned.clear();
+        return;
+    }
+    job.blob.data = job.blob.owned.data();
+    job.blob.size = job.blob.owned.size();
+}
+
+int AssetLoader::pumpCompleted(int maxJobs) {
+    int processed = 0;
+    while (maxJobs < 0 || processed < maxJobs) {
+        AssetJob* job = nullptr;
+        if (mutex) SDL_LockMutex(mutex);
+        if (!completed.empty()) {
+            job = completed.front();
+            completed.pop_front();
+        }
+        if (mutex) SDL_UnlockMutex(mutex);
+        if (!job) break;
+
+        finishJob(job);
+        processed++;
+    }
+    return processed;
+}
+
+void AssetLoader::finishJob(AssetJob* job) {
+    if (job->kind == AssetKind::IMAGE) {
+        if (!job->surface) {
+            std::cerr << "AssetLoader: could not decode " << job->path << ": " << IMG_GetError() << std::endl;
+        }
+        if (job->onImage) {
+            job->onImage(job->surface);
+        } else if (job->surface) {
+            SDL_FreeSurface(job->surface);
+        }
+    } else {
+        if (job->blob.empty()) {
+            std::cerr << "AssetLoader: could not read " << job->path << std::endl;
+        }
+        if (job->onBytes) job->onBytes(job->blob);
+    }
+
+    delete job;
+    inFlight--;
+    finishedCount++;
+}
+
+bool AssetLoader::isIdle() const {
+    return inFlight == 0;
+}
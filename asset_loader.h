@@ -0,0 +1,91 @@
+#ifndef ASSET_LOADER_H_INCLUDED
+#define ASSET_LOADER_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include "asset_pack.h"
+
+// Loại tài nguyên nạp nền
+enum class AssetKind {
+    IMAGE,  // PNG -> SDL_Surface, decode trên worker thread
+    BYTES   // Đọc nguyên file vào bộ nhớ (font, nhạc)
+};
+
+// Nội dung một file: trỏ thẳng vào asset pack đã mmap, hoặc buffer tự
+// sở hữu khi đọc file rời. Chỉ move được (data trỏ vào owned).
+struct AssetBlob {
+    const char* data;
+    size_t size;
+    std::vector<char> owned;
+
+    AssetBlob() : data(nullptr), size(0) {}
+    AssetBlob(AssetBlob&&) = default;
+    AssetBlob& operator=(AssetBlob&&) = default;
+    AssetBlob(const AssetBlob&) = delete;
+    AssetBlob& operator=(const AssetBlob&) = delete;
+
+    bool empty() const { return size == 0; }
+    SDL_RWops* openRW() const { return SDL_RWFromConstMem(data, static_cast<int>(size)); }
+    void clear() { data = nullptr; size = 0; owned.clear(); }
+};
+
+struct AssetJob {
+    AssetKind kind;
+    std::string path;
+    SDL_Surface* surface;
+    AssetBlob blob;
+    std::function<void(SDL_Surface*)> onImage;
+    std::function<void(AssetBlob&)> onBytes;
+};
+
+// Worker pool nạp tài nguyên: đọc file + decode PNG trên thread phụ,
+// còn upload texture / mở font chạy trên main thread qua pumpCompleted().
+class AssetLoader {
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    bool start(int workerCount = 0);
+    void shutdown();
+
+    // Khi có pack, đường dẫn được tra trong pack trước, không có mới đọc file rời
+    void setPack(const AssetPack* assetPack) { pack = assetPack; }
+
+    // Có trong pack hoặc có file rời, dùng cho tài nguyên tuỳ chọn
+    bool hasAsset(const std::string& path) const;
+
+    // Callback chạy trên main thread. onImage nhận quyền sở hữu surface
+    // (nullptr nếu lỗi), onBytes nhận blob rỗng nếu lỗi.
+    void requestImage(const std::string& path, std::function<void(SDL_Surface*)> onImage);
+    void requestBytes(const std::string& path, std::function<void(AssetBlob&)> onBytes);
+
+    // Chạy callback của các job đã xong, tối đa maxJobs (< 0 = tất cả)
+    int pumpCompleted(int maxJobs = -1);
+
+    bool isIdle() const;
+    int getRequestedCount() const { return requestedCount; }
+    int getFinishedCount() const { return finishedCount; }
+
+private:
+    static int workerMain(void* data);
+    void enqueue(AssetJob* job);
+    void runJob(AssetJob& job);
+    void finishJob(AssetJob* job);
+
+    const AssetPack* pack;
+    std::vector<SDL_Thread*> workers;
+    std::deque<AssetJob*> pending;
+    std::deque<AssetJob*> completed;
+    SDL_mutex* mutex;
+    SDL_cond* wake;
+    bool stopping;
+    int inFlight;
+    int requestedCount;
+    int finishedCount;
+};
+
+#endif // ASSET_LOADER_H_INCLUDED
@@ -0,0 +1,90 @@
+#include "asset_pack.h"
+#include <iostream>
+#include <cstring>
+
+// ===================== ASSET PACK IMPLEMENTATION =====================
+
+AssetPack::AssetPack() : entries(nullptr), entryCount(0) {}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+
+    const char* base = file.data();
+    size_t size = file.size();
+
+    if (size < sizeof(PackHeader)) {
+        std::cerr << "AssetPack: " << path << " is too small" << std::endl;
+        close();
+        return false;
+    }
+
+    PackHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header.version != PACK_VERSION) {
+        std::cerr << "AssetPack: " << path << " has wrong magic/version" << std::endl;
+        close();
+        return false;
+    }
+
+    Uint64 tocEnd = (Uint64)header.tocOffset + (Uint64)header.entryCount * sizeof(PackEntry);
+    if (header.tocOffset % alignof(PackEntry) != 0 || tocEnd > size) {
+        std::cerr << "AssetPack: " << path << " has a corrupt table of contents" << std::endl;
+        close();
+        return false;
+    }
+
+    const PackEntry* toc = reinterpret_cast<const PackEntry*>(base + header.tocOffset);
+    for (Uint32 i = 0; i < header.entryCount; i++) {
+        const PackEntry& e = toc[i];
+        // offset/size lấy từ file: so từng vế để tổng không tràn qua 2^64
+        if (e.offset > size || e.size > size - e.offset || e.name[PACK_NAME_LENGTH - 1] != '\0' ||
+            (e.kind == PACK_RGBA && (Uint64)e.width * e.height * 4 != e.size)) {
+            std::cerr << "AssetPack: " << path << " entry " << i << " is out of bounds" << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    entries = toc;
+    entryCount = header.entryCount;
+    std::cout << "Asset pack " << path << ": " << entryCount << " entries, "
+              << size / 1024 << " KB mapped" << std::endl;
+    return true;
+}
+
+void AssetPack::close() {
+    file.close();
+    entries = nullptr;
+    entryCount = 0;
+}
+
+const PackEntry* AssetPack::find(const std::string& name) const {
+    // TOC đã được packer sắp xếp theo tên -> tìm nhị phân
+    int lo = 0, hi = (int)entryCount - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(entries[mid].name, name.c_str());
+        if (cmp == 0) return &entries[mid];
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return nullptr;
+}
+
+const char* AssetPack::entryData(const PackEntry& entry) const {
+    return file.data() + entry.offset;
+}
+
+SDL_RWops* AssetPack::openRW(const PackEntry& entry) const {
+    return SDL_RWFromConstMem(entryData(entry), static_cast<int>(entry.size));
+}
+
+SDL_Surface* AssetPack::createSurface(const PackEntry& entry) const {
+    if (entry.kind != PACK_RGBA) return nullptr;
+
+    // Mapping là PROT_READ: surface chỉ được đọc (upload texture), không được vẽ lên
+    void* pixels = const_cast<char*>(entryData(entry));
+    return SDL_CreateRGBSurfaceWithFormatFrom(pixels, (int)entry.width, (int)entry.height,
+                                              32, (int)entry.width * 4, SDL_PIXELFORMAT_RGBA32);
+}
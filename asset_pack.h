@@ -0,0 +1,67 @@
+#ifndef ASSET_PACK_H_INCLUDED
+#define ASSET_PACK_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <string>
+#include "mapped_file.h"
+
+// Định dạng assets.pak (little-endian), tạo bởi tools/asset_packer (bước
+// pre-build của Game.cbp đóng gói lại trước mỗi lần build):
+//   [PackHeader][PackEntry x entryCount, sắp xếp theo name][payload...]
+// Mỗi payload bắt đầu ở offset chia hết cho PACK_ALIGNMENT.
+static const char PACK_MAGIC[4] = { 'D', 'P', 'A', 'K' };
+static const Uint32 PACK_VERSION = 1;
+static const Uint32 PACK_ALIGNMENT = 64;
+static const int PACK_NAME_LENGTH = 56;
+
+enum PackEntryKind {
+    PACK_RAW = 0,   // Nguyên file (png, ttf, mp3...)
+    PACK_RGBA = 1   // Ảnh đã decode sẵn, RGBA32, pitch = width * 4
+};
+
+struct PackHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 entryCount;
+    Uint32 tocOffset;
+};
+
+struct PackEntry {
+    char name[PACK_NAME_LENGTH];  // Đường dẫn gốc, vd "image/dino_base.png"
+    Uint64 offset;
+    Uint64 size;
+    Uint32 kind;
+    Uint32 width;
+    Uint32 height;
+    Uint32 reserved;
+};
+
+SDL_COMPILE_TIME_ASSERT(pack_header_size, sizeof(PackHeader) == 16);
+SDL_COMPILE_TIME_ASSERT(pack_entry_size, sizeof(PackEntry) == 88);
+
+// Asset pack được mmap một lần; các entry trả về dạng SDL_RWops trỏ
+// thẳng vào vùng nhớ đã map nên không có thêm lần đọc file nào.
+class AssetPack {
+public:
+    AssetPack();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    const PackEntry* find(const std::string& name) const;
+    const char* entryData(const PackEntry& entry) const;
+
+    // SDL_RWops chỉ đọc trên vùng nhớ của entry, dùng với freesrc = 1
+    SDL_RWops* openRW(const PackEntry& entry) const;
+
+    // Ảnh RGBA decode sẵn -> surface dùng chung pixel với mapping (không copy)
+    SDL_Surface* createSurface(const PackEntry& entry) const;
+
+private:
+    MappedFile file;
+    const PackEntry* entries;
+    Uint32 entryCount;
+};
+
+#endif // ASSET_PACK_H_INCLUDED
@@ -0,0 +1,333 @@
+#include "audio_system.h"
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+// file, priority, minIntervalMs, maxVoices, volume
+const AudioSystem::SoundDef AudioSystem::SOUND_DEFS[SFX_COUNT] = {
+    { "sound/jump.wav",      2,  60, 2,  96 },
+    { "sound/coin.wav",      1,  45, 3,  80 },
+    { "sound/powerup.wav",   3, 100, 2, 110 },
+    { "sound/dash.wav",      3, 100, 1, 110 },
+    { "sound/collision.wav", 4, 200, 1, 128 },
+    { "sound/click.wav",     2,  40, 2,  90 }
+};
+
+// Hiệu ứng mẫu thay cho từng patch; SFX_COUNT = không có
+const SoundId AudioSystem::SYNTH_FALLBACK[PATCH_COUNT] = {
+    SFX_JUMP, SFX_COIN, SFX_POWERUP, SFX_COUNT
+};
+
+static const int SYNTH_RATE = 22050;
+
+static void writeLE(std::vector<Uint8>& out, Uint32 value, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((Uint8)(value >> (8 * i)));
+}
+
+// ===================== AUDIO SYSTEM IMPLEMENTATION =====================
+
+AudioSystem::AudioSystem()
+    : music(nullptr), musicStarted(false), musicClock(0.0), musicResumedAt(0), ready(false),
+      playedCount(0), throttledCount(0), stolenCount(0) {
+    for (int i = 0; i < SFX_COUNT; i++) {
+        chunks[i] = nullptr;
+        overridden[i] = false;
+        lastPlayed[i] = 0;
+    }
+    for (auto& voice : voices) {
+        voice.sound = -1;
+        voice.startTick = 0;
+    }
+}
+
+AudioSystem::~AudioSystem() {
+    cleanup();
+}
+
+void AudioSystem::initialize(AssetLoader& loader) {
+    int frequency, channels;
+    Uint16 format;
+    if (!Mix_QuerySpec(&frequency, &format, &channels)) {
+        std::cerr << "AudioSystem: audio device not open, sound effects disabled" << std::endl;
+        return;
+    }
+
+    Mix_AllocateChannels(VOICE_COUNT);
+    synth.start();
+    musicStreamer.start(&loader);
+    for (int i = 0; i < SFX_COUNT; i++) {
+        SoundId id = (SoundId)i;
+        chunks[i] = synthesize(id);
+        if (chunks[i]) Mix_VolumeChunk(chunks[i], SOUND_DEFS[i].volume);
+
+        if (loader.hasAsset(SOUND_DEFS[i].file)) {
+            loader.requestBytes(SOUND_DEFS[i].file, [this, id](AssetBlob& blob) { onSoundLoaded(id, blob); });
+        }
+    }
+    ready = true;
+}
+
+void AudioSystem::cleanup() {
+    synth.stop();
+    musicStreamer.stop();
+    if (ready) Mix_HaltChannel(-1);
+    for (auto& chunk : chunks) {
+        if (chunk) Mix_FreeChunk(chunk);
+        chunk = nullptr;
+    }
+    music = nullptr;
+    musicStarted = false;
+    musicClock = 0.0;
+    musicResumedAt = 0;
+    ready = false;
+}
+
+// Âm mặc định tổng hợp tại chỗ (PCM 16-bit mono trong một WAV nằm trong
+// bộ nhớ) để game có tiếng ngay cả khi không kèm file âm thanh nào
+Mix_Chunk* AudioSystem::synthesize(SoundId id) {
+    float duration = 0.1f;
+    switch (id) {
+        case SFX_JUMP:      duration = 0.12f; break;
+        case SFX_COIN:      duration = 0.20f; break;
+        case SFX_POWERUP:   duration = 0.30f; break;
+        case SFX_DASH:      duration = 0.15f; break;
+        case SFX_COLLISION: duration = 0.35f; break;
+        case SFX_UI_CLICK:  duration = 0.03f; break;
+        default: break;
+    }
+
+    int sampleCount = (int)(duration * SYNTH_RATE);
+    std::vector<Sint16> samples(sampleCount);
+    Uint32 noiseState = 0x12345678u + (Uint32)id;
+    float phase = 0.0f, filtered = 0.0f;
+
+    for (int i = 0; i < sampleCount; i++) {
+        float t = (float)i / SYNTH_RATE;
+        float k = t / duration;  // 0..1
+        noiseState = noiseState * 1664525u + 1013904223u;
+        float noise = (float)(noiseState >> 8) / (float)(1 << 23) - 1.0f;
+
+        float freq = 0.0f, value = 0.0f, env = 1.0f - k;
+        switch (id) {
+            case SFX_JUMP:
+                freq = 300.0f + 300.0f * k;
+                break;
+            case SFX_COIN:
+                freq = (t < 0.05f) ? 988.0f : 1319.0f;
+                env = (t < 0.05f) ? 1.0f : 1.0f - (t - 0.05f) / (duration - 0.05f);
+                break;
+            case SFX_POWERUP: {
+                static const float notes[] = { 523.0f, 659.0f, 784.0f, 1047.0f };
+                freq = notes[std::min(3, (int)(k * 4))];
+                env = 1.0f - 0.5f * k;
+                break;
+            }
+            case SFX_DASH:
+                filtered += (noise - filtered) * (0.5f * (1.0f - k) + 0.05f);
+                value = filtered;
+                break;
+            case SFX_COLLISION:
+                freq = 120.0f - 70.0f * k;
+                env = (1.0f - k) * (1.0f - k);
+                break;
+            case SFX_UI_CLICK:
+                freq = 1500.0f;
+                break;
+            default:
+                break;
+        }
+
+        if (freq > 0.0f) {
+            phase += freq / SYNTH_RATE;
+            if (phase >= 1.0f) phase -= 1.0f;
+            float wave = sinf(phase * 2.0f * (float)M_PI);
+            if (id == SFX_JUMP || id == SFX_POWERUP) wave = wave >= 0.0f ? 0.6f : -0.6f;  // Sóng vuông kiểu 8-bit
+            value = (id == SFX_COLLISION) ? 0.6f * wave + 0.4f * noise * (1.0f - k) : wave;
+        }
+        samples[i] = (Sint16)(value * env * 0.35f * 32767.0f);
+    }
+
+    std::vector<Uint8> wav;
+    Uint32 dataBytes = (Uint32)samples.size() * 2;
+    wav.insert(wav.end(), { 'R', 'I', 'F', 'F' });
+    writeLE(wav, 36 + dataBytes, 4);
+    wav.insert(wav.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    writeLE(wav, 16, 4);               // fmt chunk size
+    writeLE(wav, 1, 2);                // PCM
+    writeLE(wav, 1, 2);                // mono
+    writeLE(wav, SYNTH_RATE, 4);
+    writeLE(wav, SYNTH_RATE * 2, 4);   // byte rate
+    writeLE(wav, 2, 2);                // block align
+    writeLE(wav, 16, 2);               // bits per sample
+    wav.insert(wav.end(), { 'd', 'a', 't', 'a' });
+    writeLE(wav, dataBytes, 4);
+    for (Sint16 s : samples) writeLE(wav, (Uint16)s, 2);
+
+    // Mix_LoadWAV_RW chuyển về định dạng của thiết bị và giữ bản sao riêng
+    Mix_Chunk* chunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(wav.data(), (int)wav.size()), 1);
+    if (!chunk) {
+        std::cerr << "AudioSystem: could not build sound " << id << ": " << Mix_GetError() << std::endl;
+    }
+    return chunk;
+}
+
+void AudioSystem::onSoundLoaded(SoundId id, AssetBlob& blob) {
+    if (!ready || blob.empty()) return;
+
+    Mix_Chunk* chunk = Mix_LoadWAV_RW(blob.openRW(), 1);
+    if (!chunk) {
+        std::cerr << "AudioSystem: could not decode " << SOUND_DEFS[id].file << ": " << Mix_GetError() << std::endl;
+        return;
+    }
+    Mix_VolumeChunk(chunk, SOUND_DEFS[id].volume);
+    if (chunks[id]) Mix_FreeChunk(chunks[id]);  // Mixer tự dừng các kênh đang phát chunk cũ
+    chunks[id] = chunk;
+    overridden[id] = true;
+}
+
+int AudioSystem::pickVoice(SoundId id) {
+    const SoundDef& def = SOUND_DEFS[id];
+    int freeVoice = -1, oldestSame = -1, sameCount = 0, victim = -1;
+
+    for (int v = 0; v < VOICE_COUNT; v++) {
+        Voice& voice = voices[v];
+        if (voice.sound >= 0 && !Mix_Playing(v)) voice.sound = -1;
+
+        if (voice.sound < 0) {
+            if (freeVoice < 0) freeVoice = v;
+        } else if (voice.sound == id) {
+            sameCount++;
+            if (oldestSame < 0 || voice.startTick < voices[oldestSame].startTick) oldestSame = v;
+        } else if (SOUND_DEFS[voice.sound].priority < def.priority) {
+            // Cướp voice ưu tiên thấp nhất, cùng mức thì cũ nhất
+            if (victim < 0 ||
+                SOUND_DEFS[voice.sound].priority < SOUND_DEFS[voices[victim].sound].priority ||
+                (SOUND_DEFS[voice.sound].priority == SOUND_DEFS[voices[victim].sound].priority &&
+                 voice.startTick < voices[victim].startTick)) {
+                victim = v;
+            }
+        }
+    }
+
+    if (sameCount >= def.maxVoices) return oldestSame;
+    if (freeVoice >= 0) return freeVoice;
+    return victim;
+}
+
+void AudioSystem::play(SoundId id) {
+    if (!ready || id < 0 || id >= SFX_COUNT || !chunks[id]) return;
+
+    Uint32 now = SDL_GetTicks();
+    if (lastPlayed[id] != 0 && now - lastPlayed[id] < SOUND_DEFS[id].minIntervalMs) {
+        throttledCount++;
+        return;
+    }
+
+    int channel = pickVoice(id);
+    if (channel < 0) {
+        throttledCount++;
+        return;
+    }
+    if (voices[channel].sound >= 0) {
+        Mix_HaltChannel(channel);
+        stolenCount++;
+    }
+
+    if (Mix_PlayChannel(channel, chunks[id], 0) < 0) return;
+    voices[channel].sound = id;
+    voices[channel].startTick = now;
+    lastPlayed[id] = now;
+    playedCount++;
+}
+
+void AudioSystem::playSynth(SynthPatch patch, float pitch) {
+    if (!ready || patch < 0 || patch >= PATCH_COUNT) return;
+
+    SoundId fallback = SYNTH_FALLBACK[patch];
+    bool useSample = fallback != SFX_COUNT && (overridden[fallback] || !synth.isRunning());
+    if (useSample) {
+        play(fallback);
+    } else if (synth.isRunning() && !synth.trigger(patch, pitch)) {
+        throttledCount++;
+    }
+}
+
+void AudioSystem::playMusic(const std::string& path) {
+    musicStreamer.play(path);
+}
+
+void AudioSystem::onGameEvent(const GameEvent& event) {
+    switch (event.type) {
+        case EVENT_JUMP: playSynth(PATCH_JUMP); break;
+        case EVENT_DASH: play(SFX_DASH); break;
+        case EVENT_HIT: play(SFX_COLLISION); break;
+        case EVENT_METEOR_SPAWNED: playSynth(PATCH_METEOR); break;
+        case EVENT_COMBO:
+            // Tiếng xu cao dần theo combo, tối đa gấp đôi ở x25
+            playSynth(PATCH_COIN, 1.0f + 0.04f * std::min(event.combo.count, 25));
+            break;
+        case EVENT_POWERUP_COLLECTED:
+            if (event.powerUp.shield) playSynth(PATCH_SHIELD);
+            else play(SFX_POWERUP);
+            break;
+        default:
+            break;
+    }
+}
+
+void AudioSystem::setMusic(Mix_Music* newMusic, const std::string& path) {
+    music = newMusic;
+    musicPath = path;
+    musicStarted = false;
+    musicClock = 0.0;
+    musicResumedAt = 0;
+}
+
+void AudioSystem::setMusicActive(bool active) {
+    if (musicStreamer.isRunning()) {
+        musicStreamer.setPaused(!active);
+        return;
+    }
+    if (!music) return;
+
+    if (active) {
+        if (!musicStarted) {
+            Mix_PlayMusic(music, -1); // -1 để lặp vô tận
+            musicStarted = true;
+            musicResumedAt = SDL_GetPerformanceCounter();
+        } else if (Mix_PausedMusic()) {
+            Mix_ResumeMusic();
+            musicResumedAt = SDL_GetPerformanceCounter();
+        }
+    } else if (musicStarted && !Mix_PausedMusic()) {
+        Mix_PauseMusic();
+        musicClock = getMusicTime();
+        musicResumedAt = 0;
+    }
+}
+
+std::string AudioSystem::getMusicPath() const {
+    if (musicStreamer.isRunning()) return musicStreamer.getCurrentPath();
+    return music ? musicPath : std::string();
+}
+
+double AudioSystem::getMusicTime() const {
+    if (musicStreamer.isRunning()) return musicStreamer.getTrackTime();
+    if (musicResumedAt == 0) return musicClock;
+    return musicClock + (double)(SDL_GetPerformanceCounter() - musicResumedAt) / SDL_GetPerformanceFrequency();
+}
+
+void AudioSystem::logStats() const {
+    std::cout << "Audio: " << playedCount << " sounds played, " << throttledCount
+              << " throttled, " << stolenCount << " voices stolen" << std::endl;
+    if (synth.isRunning()) {
+        std::cout << "Synth: " << synth.getTriggeredCount() << " notes, " << synth.getDroppedCount()
+                  << " dropped, " << synth.getStolenCount() << " voices stolen" << std::endl;
+    }
+    if (musicStreamer.isRunning()) {
+        std::cout << "Music: " << musicStreamer.getCrossfadeCount() << " crossfades, "
+                  << musicStreamer.getUnderrunCount() << " buffer underruns, "
+                  << musicStreamer.getBufferedMs() << " ms buffered" << std::endl;
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef AUDIO_SYSTEM_H_INCLUDED
+#define AUDIO_SYSTEM_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <string>
+#include <vector>
+#include "asset_loader.h"
+#include "synth.h"
+#include "music_streamer.h"
+#include "event_bus.h"
+
+enum SoundId {
+    SFX_JUMP,
+    SFX_COIN,
+    SFX_POWERUP,
+    SFX_DASH,
+    SFX_COLLISION,
+    SFX_UI_CLICK,
+    SFX_COUNT
+};
+
+// Hiệu ứng âm thanh nạp sẵn một lần + điều khiển nhạc nền.
+// Mỗi âm có độ ưu tiên, khoảng cách tối thiểu giữa hai lần phát và số
+// voice tối đa, để chuỗi coin khi có COIN_MAGNET không chiếm hết kênh.
+class AudioSystem : public GameEventListener {
+public:
+    AudioSystem();
+    ~AudioSystem();
+
+    // Gọi sau Mix_OpenAudio. Âm tổng hợp sẵn dùng ngay; file sound/<tên>.wav
+    // (nếu có) nạp nền qua loader và thay thế khi xong.
+    void initialize(AssetLoader& loader);
+    void cleanup();
+
+    void play(SoundId id);
+
+    // Âm tổng hợp trong callback. Khi synth không chạy được, hoặc khi có file
+    // sound/*.wav thay thế, phát hiệu ứng mẫu tương ứng (nếu có)
+    void playSynth(SynthPatch patch, float pitch = 1.0f);
+
+    // Âm thanh gameplay phát theo sự kiện; tiếng xu theo EVENT_COMBO để pitch
+    // lấy từ combo mang trong sự kiện
+    void onGameEvent(const GameEvent& event) override;
+
+    // Nhạc nền stream (MusicStreamer): đổi bài bằng crossfade
+    bool isStreamingMusic() const { return musicStreamer.isRunning(); }
+    void playMusic(const std::string& path);
+
+    // Khi không stream được: một Mix_Music chỉ bắt đầu một lần, sau đó pause/resume
+    void setMusic(Mix_Music* music, const std::string& path);
+
+    void setMusicActive(bool active);
+
+    // Bài đang nghe và số giây đã phát của nó (không tính lúc pause),
+    // tăng liên tục qua các vòng lặp
+    std::string getMusicPath() const;
+    double getMusicTime() const;
+
+    int getPlayedCount() const { return playedCount; }
+    int getThrottledCount() const { return throttledCount; }
+    int getStolenCount() const { return stolenCount; }
+    void logStats() const;
+
+private:
+    struct SoundDef {
+        const char* file;
+        int priority;        // Cao hơn được cướp voice của âm thấp hơn
+        Uint32 minIntervalMs;
+        int maxVoices;
+        int volume;
+    };
+
+    struct Voice {
+        int sound;           // -1 nếu trống
+        Uint32 startTick;
+    };
+
+    static const int VOICE_COUNT = 12;
+    static const SoundDef SOUND_DEFS[SFX_COUNT];
+    static const SoundId SYNTH_FALLBACK[PATCH_COUNT];
+
+    Mix_Chunk* synthesize(SoundId id);
+    void onSoundLoaded(SoundId id, AssetBlob& blob);
+    int pickVoice(SoundId id);
+
+    Synth synth;
+    MusicStreamer musicStreamer;
+    Mix_Chunk* chunks[SFX_COUNT];
+    bool overridden[SFX_COUNT];  // Đã nạp file thay cho âm mặc định
+    Uint32 lastPlayed[SFX_COUNT];
+    Voice voices[VOICE_COUNT];
+    Mix_Music* music;
+    std::string musicPath;
+    bool musicStarted;
+    double musicClock;        // Giây đã phát tới lần pause gần nhất
+    Uint64 musicResumedAt;    // 0 khi đang pause
+    bool ready;
+    int playedCount;
+    int throttledCount;
+    int stolenCount;
+};
+
+#endif // AUDIO_SYSTEM_H_INCLUDED
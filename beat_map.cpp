@@ -0,0 +1,423 @@
+#include "beat_map.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "wav_pcm.h"
+
+static const char BEAT_MAP_MAGIC[4] = { 'B', 'M', 'A', 'P' };
+static const Uint32 BEAT_MAP_VERSION = 1;
+
+// Tham số phân tích
+static const int ANALYSIS_RATE = 11025;   // Đủ cho trống/bass, FFT rẻ
+static const int FFT_SIZE = 1024;         // ~93 ms
+static const int HOP_SIZE = 256;          // ~23 ms mỗi điểm onset
+static const int DECODE_BLOCK = 4096;     // Mẫu mono giữa hai lần kiểm tra budget
+static const float MIN_BPM = 70.0f;
+static const float MAX_BPM = 180.0f;
+static const float TIGHTNESS = 100.0f;    // Phạt lệch khỏi chu kỳ khi dò phách
+
+// Vật cản cách nhau ít nhất chừng này (xấp xỉ 70 frame cũ)
+static const double MIN_OBSTACLE_GAP = 1.15;
+
+Uint64 hashBytes(const char* data, size_t size) {
+    Uint64 hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (Uint8)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// ===================== BEAT MAP IMPLEMENTATION =====================
+
+bool BeatMap::load(const std::string& path, Uint64 expectedHash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[4];
+    Uint32 version = 0, count = 0;
+    Uint64 hash = 0;
+    file.read(magic, 4);
+    file.read((char*)&version, sizeof(version));
+    file.read((char*)&hash, sizeof(hash));
+    if (!file || memcmp(magic, BEAT_MAP_MAGIC, 4) != 0 || version != BEAT_MAP_VERSION || hash != expectedHash) {
+        return false;
+    }
+
+    file.read((char*)&tempo, sizeof(tempo));
+    file.read((char*)&duration, sizeof(duration));
+    file.read((char*)&count, sizeof(count));
+    if (!file || count > 100000) return false;
+
+    beats.resize(count);
+    if (count > 0) file.read((char*)beats.data(), count * sizeof(float));
+    if (!file) {
+        beats.clear();
+        return false;
+    }
+    sourceHash = hash;
+    return true;
+}
+
+bool BeatMap::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "BeatMap: cannot write " << path << std::endl;
+        return false;
+    }
+    Uint32 count = (Uint32)beats.size();
+    file.write(BEAT_MAP_MAGIC, 4);
+    file.write((const char*)&BEAT_MAP_VERSION, sizeof(BEAT_MAP_VERSION));
+    file.write((const char*)&sourceHash, sizeof(sourceHash));
+    file.write((const char*)&tempo, sizeof(tempo));
+    file.write((const char*)&duration, sizeof(duration));
+    file.write((const char*)&count, sizeof(count));
+    if (count > 0) file.write((const char*)beats.data(), count * sizeof(float));
+    return (bool)file;
+}
+
+// FFT phức radix-2 tại chỗ, n là luỹ thừa của 2
+static void fft(std::vector<float>& re, std::vector<float>& im) {
+    int n = (int)re.size();
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        float angle = -2.0f * (float)M_PI / len;
+        float wRe = cosf(angle), wIm = sinf(angle);
+        for (int i = 0; i < n; i += len) {
+            float curRe = 1.0f, curIm = 0.0f;
+            for (int k = 0; k < len / 2; k++) {
+                int a = i + k, b = i + k + len / 2;
+                float tRe = re[b] * curRe - im[b] * curIm;
+                float tIm = re[b] * curIm + im[b] * curRe;
+                re[b] = re[a] - tRe;
+                im[b] = im[a] - tIm;
+                re[a] += tRe;
+                im[a] += tIm;
+                float nextRe = curRe * wRe - curIm * wIm;
+                curIm = curRe * wIm + curIm * wRe;
+                curRe = nextRe;
+            }
+        }
+    }
+}
+
+// ===================== BEAT ANALYZER IMPLEMENTATION =====================
+
+BeatAnalyzer::BeatAnalyzer()
+    : thread(nullptr), sourceData(nullptr), sourceSize(0),
+      startTick(0), budgetMs(0), taken(false) {
+    SDL_AtomicSet(&finished, 0);
+}
+
+BeatAnalyzer::~BeatAnalyzer() {
+    wait();
+}
+
+bool BeatAnalyzer::start(const char* data, size_t size, const std::string& cacheFile, Uint32 budget) {
+    if (thread || !data || size == 0) return false;
+
+    sourceData = data;
+    sourceSize = size;
+    cachePath = cacheFile;
+    budgetMs = budget;
+    startTick = SDL_GetTicks();
+    taken = false;
+    result = BeatMap();
+    SDL_AtomicSet(&finished, 0);
+
+    thread = SDL_CreateThread(threadMain, "BeatAnalyzer", this);
+    if (!thread) {
+        std::cerr << "BeatAnalyzer: SDL_CreateThread Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void BeatAnalyzer::wait() {
+    if (!thread) return;
+    SDL_WaitThread(thread, nullptr);
+    thread = nullptr;
+}
+
+bool BeatAnalyzer::takeResult(BeatMap& out) {
+    if (taken || !thread || !SDL_AtomicGet(&finished)) return false;
+    wait();
+    taken = true;
+    if (result.empty()) return false;
+    out = result;
+    return true;
+}
+
+int BeatAnalyzer::threadMain(void* data) {
+    static_cast<BeatAnalyzer*>(data)->run();
+    return 0;
+}
+
+bool BeatAnalyzer::overBudget() const {
+    return SDL_GetTicks() - startTick > budgetMs;
+}
+
+void BeatAnalyzer::run() {
+    Uint64 hash = hashBytes(sourceData, sourceSize);
+    if (result.load(cachePath, hash)) {
+        std::cout << "Beat map: " << result.beats.size() << " beats at " << (int)result.tempo
+                  << " BPM (cached, " << (SDL_GetTicks() - startTick) << " ms)" << std::endl;
+        SDL_AtomicSet(&finished, 1);
+        return;
+    }
+
+    std::vector<float> mono;
+    int rate = 0;
+    if (decodeMono(mono, rate) && analyze(mono, rate)) {
+        result.sourceHash = hash;
+        result.duration = (float)mono.size() / rate;
+        result.save(cachePath);
+        std::cout << "Beat map: " << result.beats.size() << " beats at " << (int)result.tempo
+                  << " BPM (analyzed in " << (SDL_GetTicks() - startTick) << " ms)" << std::endl;
+    } else {
+        result = BeatMap();
+        std::cerr << "Beat map: analysis unavailable, using random spawn timing" << std::endl;
+    }
+    SDL_AtomicSet(&finished, 1);
+}
+
+// WAV PCM 16-bit được đọc thẳng từ blob theo từng block. Định dạng khác thì
+// SDL_mixer giải mã cả bài trong một lần gọi (ra định dạng thiết bị) nên
+// chỉ kiểm tra budget được sau lần gọi đó
+bool BeatAnalyzer::decodeMono(std::vector<float>& mono, int& rate) {
+    const char* data = nullptr;
+    Uint32 bytes = 0;
+    int frequency = 0, channels = 0;
+    if (findWavPcm16(sourceData, sourceSize, data, bytes, frequency, channels)) {
+        return downmix(reinterpret_cast<const Sint16*>(data), bytes / (sizeof(Sint16) * channels),
+                       channels, frequency, true, mono, rate);
+    }
+
+    Uint16 format;
+    if (!Mix_QuerySpec(&frequency, &format, &channels) || format != AUDIO_S16SYS) return false;
+
+    Mix_Chunk* chunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(sourceData, (int)sourceSize), 1);
+    if (!chunk) {
+        std::cerr << "BeatAnalyzer: cannot decode music: " << Mix_GetError() << std::endl;
+        return false;
+    }
+    bool ok = !overBudget() &&
+              downmix(reinterpret_cast<const Sint16*>(chunk->abuf), chunk->alen / (sizeof(Sint16) * channels),
+                      channels, frequency, false, mono, rate);
+    Mix_FreeChunk(chunk);
+    return ok;
+}
+
+// Trộn kênh và hạ tần số lấy mẫu về ~11 kHz bằng trung bình cộng, kiểm tra
+// budget sau mỗi DECODE_BLOCK mẫu ra. littleEndian: mẫu S16LE của file WAV,
+// ngược lại là S16 của thiết bị
+bool BeatAnalyzer::downmix(const Sint16* samples, size_t frames, int channels, int frequency,
+                           bool littleEndian, std::vector<float>& mono, int& rate) {
+    int decimate = std::max(1, frequency / ANALYSIS_RATE);
+    rate = frequency / decimate;
+    size_t outCount = frames / decimate;
+    float scale = 1.0f / (32768.0f * decimate * channels);
+
+    mono.resize(outCount);
+    for (size_t i = 0; i < outCount; i++) {
+        if (i % DECODE_BLOCK == 0 && overBudget()) return false;
+        const Sint16* src = samples + i * decimate * channels;
+        int sum = 0;
+        for (int k = 0; k < decimate * channels; k++) {
+            sum += littleEndian ? (Sint16)SDL_SwapLE16((Uint16)src[k]) : src[k];
+        }
+        mono[i] = sum * scale;
+    }
+    return outCount > (size_t)FFT_SIZE;
+}
+
+bool BeatAnalyzer::analyze(const std::vector<float>& mono, int rate) {
+    int frameCount = (int)((mono.size() - FFT_SIZE) / HOP_SIZE) + 1;
+    float framesPerSecond = (float)rate / HOP_SIZE;
+
+    // 1. Spectral flux: tổng phần tăng của log-magnitude giữa hai khung
+    std::vector<float> window(FFT_SIZE), re(FFT_SIZE), im(FFT_SIZE);
+    std::vector<float> prevMag(FFT_SIZE / 2 + 1, 0.0f);
+    std::vector<float> onset(frameCount, 0.0f);
+    for (int i = 0; i < FFT_SIZE; i++) {
+        window[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (FFT_SIZE - 1));
+    }
+
+    for (int f = 0; f < frameCount; f++) {
+        if ((f & 255) == 0 && overBudget()) return false;
+
+        const float* src = mono.data() + (size_t)f * HOP_SIZE;
+        for (int i = 0; i < FFT_SIZE; i++) {
+            re[i] = src[i] * window[i];
+            im[i] = 0.0f;
+        }
+        fft(re, im);
+
+        float flux = 0.0f;
+        for (int b = 0; b <= FFT_SIZE / 2; b++) {
+            float mag = logf(1.0f + 100.0f * sqrtf(re[b] * re[b] + im[b] * im[b]));
+            if (f > 0 && mag > prevMag[b]) flux += mag - prevMag[b];
+            prevMag[b] = mag;
+        }
+        onset[f] = flux;
+    }
+
+    // 2. Bỏ thành phần chậm (trừ trung bình trượt ~0.4 s), chỉ giữ phần dương,
+    // chuẩn hoá theo độ lệch chuẩn
+    const int meanRadius = 8;
+    std::vector<float> env(frameCount, 0.0f);
+    double running = 0.0;
+    int lo = 0, hi = 0;
+    double sumSq = 0.0;
+    for (int f = 0; f < frameCount; f++) {
+        while (hi < frameCount && hi <= f + meanRadius) running += onset[hi++];
+        while (lo < f - meanRadius) running -= onset[lo++];
+        env[f] = std::max(0.0f, onset[f] - (float)(running / (hi - lo)));
+        sumSq += env[f] * env[f];
+    }
+    float stdDev = (float)sqrt(sumSq / frameCount);
+    if (stdDev <= 0.0f) return false;
+    for (float& e : env) e /= stdDev;
+
+    // 3. Tempo: autocorrelation của đường onset, ưu tiên quanh 120 BPM
+    int lagMin = std::max(1, (int)(framesPerSecond * 60.0f / MAX_BPM));
+    int lagMax = std::min(frameCount - 1, (int)(framesPerSecond * 60.0f / MIN_BPM) + 1);
+    if (lagMax <= lagMin + 1) return false;
+
+    std::vector<float> acf(lagMax + 2, 0.0f);
+    for (int lag = lagMin - 1; lag <= lagMax + 1 && lag < frameCount; lag++) {
+        if (overBudget()) return false;
+        double sum = 0.0;
+        for (int t = lag; t < frameCount; t++) sum += env[t] * env[t - lag];
+        acf[lag] = (float)(sum / (frameCount - lag));
+    }
+
+    float lag120 = framesPerSecond * 0.5f;
+    int bestLag = lagMin;
+    float bestScore = -1.0f;
+    for (int lag = lagMin; lag <= lagMax; lag++) {
+        float octaves = log2f(lag / lag120);
+        float score = acf[lag] * expf(-0.5f * (octaves / 0.9f) * (octaves / 0.9f));
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+    // Nội suy parabol quanh đỉnh để chu kỳ không bị làm tròn theo khung
+    float period = (float)bestLag;
+    float a = acf[bestLag - 1], b = acf[bestLag], c = acf[bestLag + 1];
+    if (a - 2.0f * b + c < 0.0f) period += 0.5f * (a - c) / (a - 2.0f * b + c);
+
+    // 4. Dò phách bằng quy hoạch động: mỗi phách cộng độ mạnh onset, phạt
+    // khoảng cách lệch khỏi chu kỳ (kiểu Ellis 2007)
+    std::vector<float> score(env);
+    std::vector<int> back(frameCount, -1);
+    int searchMin = (int)roundf(period * 0.5f), searchMax = (int)roundf(period * 2.0f);
+    for (int t = 0; t < frameCount; t++) {
+        if ((t & 1023) == 0 && overBudget()) return false;
+
+        float best = 0.0f;
+        int bestPrev = -1;
+        for (int prev = t - searchMax; prev <= t - searchMin; prev++) {
+            if (prev < 0) continue;
+            float d = logf((t - prev) / period);
+            float candidate = score[prev] - TIGHTNESS * d * d;
+            if (bestPrev < 0 || candidate > best) {
+                best = candidate;
+                bestPrev = prev;
+            }
+        }
+        if (bestPrev >= 0 && best > 0.0f) {
+            score[t] = env[t] + best;
+            back[t] = bestPrev;
+        }
+    }
+
+    int last = frameCount - 1;
+    for (int t = std::max(0, frameCount - (int)period); t < frameCount; t++) {
+        if (score[t] > score[last]) last = t;
+    }
+
+    std::vector<float> beats;
+    float frameOffset = 0.5f * FFT_SIZE / rate;  // Giữa cửa sổ
+    for (int t = last; t >= 0; t = back[t]) {
+        beats.push_back(t / framesPerSecond + frameOffset);
+    }
+    std::reverse(beats.begin(), beats.end());
+    if (beats.size() < 4) return false;
+
+    result.tempo = 60.0f * framesPerSecond / period;
+    result.beats = beats;
+    return true;
+}
+
+// ===================== BEAT SCHEDULER IMPLEMENTATION =====================
+
+BeatScheduler::BeatScheduler()
+    : lastTime(-1.0), lastObstacleTime(-1e9), secondsPerFrame(1.0f / 60.0f), nextBeat(-1) {}
+
+void BeatScheduler::setBeatMap(const BeatMap& map) {
+    beatMap = map;
+    reset();
+}
+
+void BeatScheduler::reset() {
+    lastTime = -1.0;
+    lastObstacleTime = -1e9;
+    nextBeat = -1;
+}
+
+double BeatScheduler::beatTime(long index) const {
+    long count = (long)beatMap.beats.size();
+    return (double)(index / count) * beatMap.duration + beatMap.beats[index % count];
+}
+
+BeatScheduler::SpawnKind BeatScheduler::update(double musicTime, float travelPixels, float pixelsPerFrame) {
+    if (!isActive() || pixelsPerFrame <= 0.0f) return SPAWN_NONE;
+
+    // Bài được phát lại từ đầu (đổi nhạc rồi quay về): dò lại vị trí phách
+    if (musicTime < lastTime) nextBeat = -1;
+
+    double delta = musicTime - lastTime;
+    if (lastTime >= 0.0 && delta > 0.0 && delta < 0.1) {
+        secondsPerFrame = secondsPerFrame * 0.95f + (float)delta * 0.05f;
+    }
+    lastTime = musicTime;
+
+    double lead = (travelPixels / pixelsPerFrame) * secondsPerFrame;
+    double target = musicTime + lead;
+
+    // Lần đầu (hoặc sau reset): nhảy tới phách kế tiếp, không spawn bù
+    if (nextBeat < 0) {
+        long count = (long)beatMap.beats.size();
+        long loop = (long)(target / beatMap.duration);
+        nextBeat = loop * count;
+        while (beatTime(nextBeat) <= target) nextBeat++;
+        return SPAWN_NONE;
+    }
+
+    SpawnKind kind = SPAWN_NONE;
+    while (beatTime(nextBeat) <= target) {
+        double when = beatTime(nextBeat++);
+        if (kind != SPAWN_NONE || target - when > 0.25) continue;  // Một spawn/frame, bỏ phách đã lỡ
+
+        if (when - lastObstacleTime >= MIN_OBSTACLE_GAP && rand() % 100 < 75) {
+            lastObstacleTime = when;
+            kind = SPAWN_OBSTACLE;
+        } else if (rand() % 100 < 25) {
+            kind = SPAWN_COIN;
+        }
+    }
+    return kind;
+}
@@ -0,0 +1,89 @@
+#ifndef BEAT_MAP_H_INCLUDED
+#define BEAT_MAP_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <string>
+#include <vector>
+
+// Nhịp của bản nhạc nền, tính một lần rồi lưu đĩa
+struct BeatMap {
+    Uint64 sourceHash;         // FNV-1a của file nhạc, dùng làm khoá cache
+    float tempo;               // BPM
+    float duration;            // Giây, để quấn vòng khi nhạc lặp
+    std::vector<float> beats;  // Thời điểm các phách (giây), tăng dần
+
+    BeatMap() : sourceHash(0), tempo(0.0f), duration(0.0f) {}
+    bool empty() const { return beats.empty() || duration <= 0.0f; }
+
+    bool load(const std::string& path, Uint64 expectedHash);
+    bool save(const std::string& path) const;
+};
+
+Uint64 hashBytes(const char* data, size_t size);
+
+// Phân tích nhịp trên thread riêng: decode nhạc (WAV PCM đọc thẳng từng
+// block, định dạng khác qua Mix_LoadWAV_RW), trộn về mono 11 kHz, spectral
+// flux qua FFT làm đường onset, autocorrelation ra tempo rồi quy hoạch động
+// để đặt phách. Có cache trên đĩa theo hash file; vượt budget thời gian
+// thì bỏ, game quay về spawn ngẫu nhiên.
+class BeatAnalyzer {
+public:
+    BeatAnalyzer();
+    ~BeatAnalyzer();
+
+    // data phải sống tới khi wait() xong (Game giữ musicData)
+    bool start(const char* data, size_t size, const std::string& cachePath, Uint32 budgetMs);
+    void wait();
+
+    // Main thread: true đúng một lần khi có kết quả
+    bool takeResult(BeatMap& out);
+
+private:
+    static int threadMain(void* data);
+    void run();
+    bool decodeMono(std::vector<float>& mono, int& rate);
+    bool downmix(const Sint16* samples, size_t frames, int channels, int frequency,
+                 bool littleEndian, std::vector<float>& mono, int& rate);
+    bool analyze(const std::vector<float>& mono, int rate);
+    bool overBudget() const;
+
+    SDL_Thread* thread;
+    SDL_atomic_t finished;
+    const char* sourceData;
+    size_t sourceSize;
+    std::string cachePath;
+    Uint32 startTick;
+    Uint32 budgetMs;
+    bool taken;
+    BeatMap result;
+};
+
+// Chọn phách để spawn sao cho vật cản/xu tới chỗ người chơi đúng lúc phách
+// vang lên: sinh ra sớm hơn một khoảng bằng thời gian chạy từ mép phải màn
+// hình tới người chơi ở tốc độ hiện tại.
+class BeatScheduler {
+public:
+    enum SpawnKind { SPAWN_NONE, SPAWN_OBSTACLE, SPAWN_COIN };
+
+    BeatScheduler();
+
+    void setBeatMap(const BeatMap& map);
+    bool isActive() const { return !beatMap.empty(); }
+    void reset();
+
+    // Gọi mỗi frame với thời gian nhạc hiện tại và quãng đường (px) + tốc độ
+    // (px/frame) của vật mới sinh. Trả về loại spawn tới hạn (tối đa một/frame).
+    SpawnKind update(double musicTime, float travelPixels, float pixelsPerFrame);
+
+private:
+    double beatTime(long index) const;  // Chỉ số toàn cục: vòng lặp * số phách + phách
+
+    BeatMap beatMap;
+    double lastTime;
+    double lastObstacleTime;
+    float secondsPerFrame;    // Ước lượng từ nhịp tăng của đồng hồ nhạc
+    long nextBeat;            // -1: chưa dò vị trí
+};
+
+#endif // BEAT_MAP_H_INCLUDED
@@ -0,0 +1,322 @@
+#include "collision_kernels.h"
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COLLISION_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+struct RectArgs {
+    const float* left;
+    const float* top;
+    const float* right;
+    const float* bottom;
+    int count;
+};
+
+struct CircleArgs {
+    const float* x;
+    const float* y;
+    const float* radius;
+    int count;
+};
+
+// ===================== SCALAR REFERENCE =====================
+
+inline bool rectHit(float l, float t, float r, float b, const CollisionRect& p) {
+    return l < r && t < b && l < p.right && p.left < r && t < p.bottom && p.top < b;
+}
+
+inline bool circleHit(float cx, float cy, float radius, const CollisionRect& p) {
+    float closestX = std::max(p.left, std::min(cx, p.right));
+    float closestY = std::max(p.top, std::min(cy, p.bottom));
+    float dx = cx - closestX, dy = cy - closestY;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+inline bool centerHit(float cx, float cy, float x, float y, float radius) {
+    float dx = cx - x, dy = cy - y;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+void rectsScalar(const RectArgs& a, int from, const CollisionRect& p, Uint32* mask) {
+    for (int i = from; i < a.count; i++) {
+        if (rectHit(a.left[i], a.top[i], a.right[i], a.bottom[i], p)) mask[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+void circlesScalar(const CircleArgs& a, int from, const CollisionRect& p, Uint32* mask) {
+    for (int i = from; i < a.count; i++) {
+        if (circleHit(a.x[i], a.y[i], a.radius[i], p)) mask[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+void centersScalar(const CircleArgs& a, int from, float x, float y, float radius, Uint32* mask) {
+    for (int i = from; i < a.count; i++) {
+        if (centerHit(a.x[i], a.y[i], x, y, radius)) mask[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+void rectsRef(const RectArgs& a, const CollisionRect& p, Uint32* mask) { rectsScalar(a, 0, p, mask); }
+void circlesRef(const CircleArgs& a, const CollisionRect& p, Uint32* mask) { circlesScalar(a, 0, p, mask); }
+void centersRef(const CircleArgs& a, float x, float y, float radius, Uint32* mask) { centersScalar(a, 0, x, y, radius, mask); }
+
+#ifdef COLLISION_KERNELS_X86
+
+// ===================== SSE2 (4 lanes) =====================
+
+__attribute__((target("sse2")))
+void rectsSse2(const RectArgs& a, const CollisionRect& p, Uint32* mask) {
+    const __m128 pl = _mm_set1_ps(p.left), pt = _mm_set1_ps(p.top);
+    const __m128 pr = _mm_set1_ps(p.right), pb = _mm_set1_ps(p.bottom);
+    int i = 0;
+    for (; i + 4 <= a.count; i += 4) {
+        __m128 l = _mm_loadu_ps(a.left + i), t = _mm_loadu_ps(a.top + i);
+        __m128 r = _mm_loadu_ps(a.right + i), b = _mm_loadu_ps(a.bottom + i);
+        __m128 hit = _mm_and_ps(_mm_cmplt_ps(l, r), _mm_cmplt_ps(t, b));
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmplt_ps(l, pr), _mm_cmplt_ps(pl, r)));
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmplt_ps(t, pb), _mm_cmplt_ps(pt, b)));
+        mask[i >> 5] |= (Uint32)_mm_movemask_ps(hit) << (i & 31);
+    }
+    rectsScalar(a, i, p, mask);
+}
+
+__attribute__((target("sse2")))
+void circlesSse2(const CircleArgs& a, const CollisionRect& p, Uint32* mask) {
+    const __m128 pl = _mm_set1_ps(p.left), pt = _mm_set1_ps(p.top);
+    const __m128 pr = _mm_set1_ps(p.right), pb = _mm_set1_ps(p.bottom);
+    int i = 0;
+    for (; i + 4 <= a.count; i += 4) {
+        __m128 cx = _mm_loadu_ps(a.x + i), cy = _mm_loadu_ps(a.y + i), r = _mm_loadu_ps(a.radius + i);
+        __m128 dx = _mm_sub_ps(cx, _mm_max_ps(pl, _mm_min_ps(cx, pr)));
+        __m128 dy = _mm_sub_ps(cy, _mm_max_ps(pt, _mm_min_ps(cy, pb)));
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 hit = _mm_cmple_ps(d2, _mm_mul_ps(r, r));
+        mask[i >> 5] |= (Uint32)_mm_movemask_ps(hit) << (i & 31);
+    }
+    circlesScalar(a, i, p, mask);
+}
+
+__attribute__((target("sse2")))
+void centersSse2(const CircleArgs& a, float x, float y, float radius, Uint32* mask) {
+    const __m128 px = _mm_set1_ps(x), py = _mm_set1_ps(y), r2 = _mm_set1_ps(radius * radius);
+    int i = 0;
+    for (; i + 4 <= a.count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(a.x + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(a.y + i), py);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        mask[i >> 5] |= (Uint32)_mm_movemask_ps(_mm_cmple_ps(d2, r2)) << (i & 31);
+    }
+    centersScalar(a, i, x, y, radius, mask);
+}
+
+// ===================== AVX2 (8 lanes) =====================
+
+__attribute__((target("avx2")))
+void rectsAvx2(const RectArgs& a, const CollisionRect& p, Uint32* mask) {
+    const __m256 pl = _mm256_set1_ps(p.left), pt = _mm256_set1_ps(p.top);
+    const __m256 pr = _mm256_set1_ps(p.right), pb = _mm256_set1_ps(p.bottom);
+    int i = 0;
+    for (; i + 8 <= a.count; i += 8) {
+        __m256 l = _mm256_loadu_ps(a.left + i), t = _mm256_loadu_ps(a.top + i);
+        __m256 r = _mm256_loadu_ps(a.right + i), b = _mm256_loadu_ps(a.bottom + i);
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(l, r, _CMP_LT_OQ), _mm256_cmp_ps(t, b, _CMP_LT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(l, pr, _CMP_LT_OQ), _mm256_cmp_ps(pl, r, _CMP_LT_OQ)));
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(t, pb, _CMP_LT_OQ), _mm256_cmp_ps(pt, b, _CMP_LT_OQ)));
+        mask[i >> 5] |= (Uint32)_mm256_movemask_ps(hit) << (i & 31);
+    }
+    rectsScalar(a, i, p, mask);
+}
+
+__attribute__((target("avx2")))
+void circlesAvx2(const CircleArgs& a, const CollisionRect& p, Uint32* mask) {
+    const __m256 pl = _mm256_set1_ps(p.left), pt = _mm256_set1_ps(p.top);
+    const __m256 pr = _mm256_set1_ps(p.right), pb = _mm256_set1_ps(p.bottom);
+    int i = 0;
+    for (; i + 8 <= a.count; i += 8) {
+        __m256 cx = _mm256_loadu_ps(a.x + i), cy = _mm256_loadu_ps(a.y + i), r = _mm256_loadu_ps(a.radius + i);
+        __m256 dx = _mm256_sub_ps(cx, _mm256_max_ps(pl, _mm256_min_ps(cx, pr)));
+        __m256 dy = _mm256_sub_ps(cy, _mm256_max_ps(pt, _mm256_min_ps(cy, pb)));
+        // Không dùng FMA: giữ làm tròn giống hệt bản vô hướng
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 hit = _mm256_cmp_ps(d2, _mm256_mul_ps(r, r), _CMP_LE_OQ);
+        mask[i >> 5] |= (Uint32)_mm256_movemask_ps(hit) << (i & 31);
+    }
+    circlesScalar(a, i, p, mask);
+}
+
+__attribute__((target("avx2")))
+void centersAvx2(const CircleArgs& a, float x, float y, float radius, Uint32* mask) {
+    const __m256 px = _mm256_set1_ps(x), py = _mm256_set1_ps(y), r2 = _mm256_set1_ps(radius * radius);
+    int i = 0;
+    for (; i + 8 <= a.count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(a.x + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(a.y + i), py);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        mask[i >> 5] |= (Uint32)_mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LE_OQ)) << (i & 31);
+    }
+    centersScalar(a, i, x, y, radius, mask);
+}
+
+#endif // COLLISION_KERNELS_X86
+
+struct KernelTable {
+    const char* name;
+    void (*rects)(const RectArgs&, const CollisionRect&, Uint32*);
+    void (*circles)(const CircleArgs&, const CollisionRect&, Uint32*);
+    void (*centers)(const CircleArgs&, float, float, float, Uint32*);
+};
+
+const KernelTable SCALAR_KERNELS = { "scalar", rectsRef, circlesRef, centersRef };
+#ifdef COLLISION_KERNELS_X86
+const KernelTable SSE2_KERNELS = { "sse2", rectsSse2, circlesSse2, centersSse2 };
+const KernelTable AVX2_KERNELS = { "avx2", rectsAvx2, circlesAvx2, centersAvx2 };
+#endif
+
+// Các bản chạy được trên CPU này, tốt nhất đứng đầu
+std::vector<const KernelTable*> availableKernels() {
+    std::vector<const KernelTable*> list;
+#ifdef COLLISION_KERNELS_X86
+    if (SDL_HasAVX2()) list.push_back(&AVX2_KERNELS);
+    if (SDL_HasSSE2()) list.push_back(&SSE2_KERNELS);
+#endif
+    list.push_back(&SCALAR_KERNELS);
+    return list;
+}
+
+const KernelTable& activeKernels() {
+    static const KernelTable* active = availableKernels().front();
+    return *active;
+}
+
+RectArgs argsOf(const RectBatch& b) {
+    RectArgs a = { b.left.data(), b.top.data(), b.right.data(), b.bottom.data(), b.size() };
+    return a;
+}
+
+CircleArgs argsOf(const CircleBatch& b) {
+    CircleArgs a = { b.x.data(), b.y.data(), b.radius.data(), b.size() };
+    return a;
+}
+
+} // namespace
+
+// ===================== COLLISION KERNELS IMPLEMENTATION =====================
+
+void collideRects(const RectBatch& batch, const CollisionRect& player, Uint32* mask) {
+    std::memset(mask, 0, collisionMaskWords(batch.size()) * sizeof(Uint32));
+    if (!(player.left < player.right && player.top < player.bottom)) return;
+    activeKernels().rects(argsOf(batch), player, mask);
+}
+
+void collideCircles(const CircleBatch& batch, const CollisionRect& player, Uint32* mask) {
+    std::memset(mask, 0, collisionMaskWords(batch.size()) * sizeof(Uint32));
+    activeKernels().circles(argsOf(batch), player, mask);
+}
+
+void collideCentersInRadius(const CircleBatch& batch, float x, float y, float radius, Uint32* mask) {
+    std::memset(mask, 0, collisionMaskWords(batch.size()) * sizeof(Uint32));
+    activeKernels().centers(argsOf(batch), x, y, radius, mask);
+}
+
+const char* getCollisionKernelName() {
+    return activeKernels().name;
+}
+
+bool runCollisionSelfTest(int rounds) {
+    std::mt19937 rng(12345);
+    auto coord = [&rng](int lo, int hi) { return lo + (int)(rng() % (unsigned)(hi - lo + 1)); };
+    std::vector<const KernelTable*> kernels = availableKernels();
+    int mismatches = 0;
+    long long checked = 0;
+
+    RectBatch rects;
+    CircleBatch circles;
+    std::vector<Uint32> expected, got;
+
+    for (int round = 0; round < rounds; round++) {
+        int count = coord(0, 100);
+        int px = coord(0, 800), py = coord(0, 600), pw = coord(0, 60), ph = coord(0, 80);
+        SDL_Rect playerRect = { px, py - ph, pw, ph };
+        CollisionRect player = CollisionRect::fromRect(px, py - ph, pw, ph);
+        // Coin dùng biên phải/dưới tính vào: cùng số như fromRect
+        CollisionRect coinPlayer = { (float)px, (float)(py - ph), (float)(px + pw), (float)py };
+        int mx = coord(0, 800), my = coord(0, 600), radius = coord(0, 200);
+
+        rects.clear();
+        circles.clear();
+        std::vector<SDL_Rect> sdlRects;
+        std::vector<int> cx, cy, cr;
+        for (int i = 0; i < count; i++) {
+            SDL_Rect r = { coord(-50, 850), coord(-50, 650), coord(-2, 90), coord(-2, 120) };
+            sdlRects.push_back(r);
+            rects.push(CollisionRect::fromRect(r.x, r.y, r.w, r.h));
+            cx.push_back(coord(-50, 850));
+            cy.push_back(coord(-50, 650));
+            cr.push_back(coord(0, 20));
+            circles.push((float)cx.back(), (float)cy.back(), (float)cr.back());
+        }
+
+        int words = collisionMaskWords(count) + 1;
+        expected.assign(words, 0);
+        got.assign(words, 0);
+
+        // Bản vô hướng khớp cách tính cũ (SDL_HasIntersection, Coin::checkCollision, sqrt của nam châm)
+        bool playerEmpty = !(pw > 0 && ph > 0);
+        SCALAR_KERNELS.rects(argsOf(rects), player, expected.data());
+        for (int i = 0; i < count; i++) {
+            bool old = SDL_HasIntersection(&playerRect, &sdlRects[i]) == SDL_TRUE;
+            if (!playerEmpty && old != collisionMaskTest(expected.data(), i)) mismatches++;
+        }
+        std::fill(expected.begin(), expected.end(), 0);
+        SCALAR_KERNELS.circles(argsOf(circles), coinPlayer, expected.data());
+        for (int i = 0; i < count; i++) {
+            int closestX = std::max(px, std::min(cx[i], px + pw));
+            int closestY = std::max(py - ph, std::min(cy[i], py));
+            int dx = cx[i] - closestX, dy = cy[i] - closestY;
+            if ((dx * dx + dy * dy <= cr[i] * cr[i]) != collisionMaskTest(expected.data(), i)) mismatches++;
+        }
+        std::fill(expected.begin(), expected.end(), 0);
+        SCALAR_KERNELS.centers(argsOf(circles), (float)mx, (float)my, (float)radius, expected.data());
+        for (int i = 0; i < count; i++) {
+            int dx = cx[i] - mx, dy = cy[i] - my;
+            if ((std::sqrt((float)(dx * dx + dy * dy)) <= radius) != collisionMaskTest(expected.data(), i)) mismatches++;
+        }
+        checked += 3 * count;
+
+        // Mọi bản SIMD khớp từng bit với bản vô hướng
+        for (const KernelTable* k : kernels) {
+            for (int kernel = 0; kernel < 3; kernel++) {
+                std::fill(expected.begin(), expected.end(), 0);
+                std::fill(got.begin(), got.end(), 0);
+                if (kernel == 0) {
+                    SCALAR_KERNELS.rects(argsOf(rects), player, expected.data());
+                    k->rects(argsOf(rects), player, got.data());
+                } else if (kernel == 1) {
+                    SCALAR_KERNELS.circles(argsOf(circles), coinPlayer, expected.data());
+                    k->circles(argsOf(circles), coinPlayer, got.data());
+                } else {
+                    SCALAR_KERNELS.centers(argsOf(circles), (float)mx, (float)my, (float)radius, expected.data());
+                    k->centers(argsOf(circles), (float)mx, (float)my, (float)radius, got.data());
+                }
+                if (expected != got) {
+                    mismatches++;
+                    std::cerr << "Collision self-test: " << k->name << " kernel " << kernel
+                              << " differs from scalar (round " << round << ", " << count << " entities)" << std::endl;
+                }
+            }
+        }
+    }
+
+    std::cout << "Collision self-test: " << rounds << " rounds, " << checked << " reference checks, kernels:";
+    for (const KernelTable* k : kernels) std::cout << " " << k->name;
+    std::cout << " (active " << getCollisionKernelName() << ") -> "
+              << (mismatches == 0 ? "OK" : "FAILED") << " (" << mismatches << " mismatches)" << std::endl;
+    return mismatches == 0;
+}
@@ -0,0 +1,60 @@
+#ifndef COLLISION_KERNELS_H_INCLUDED
+#define COLLISION_KERNELS_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Kiểm tra va chạm theo lô: dữ liệu SoA (mỗi trường một mảng) để SSE2/AVX2
+// nạp liền 4/8 thực thể, kết quả là bitmask: bit (i & 31) của mask[i / 32]
+// bật khi thực thể i chạm. mask cần ít nhất collisionMaskWords(count) word.
+// Toạ độ là số nguyên pixel lưu dạng float (chính xác tới 2^24), chỉ dùng
+// bình phương khoảng cách nên kết quả trùng khớp bản vô hướng.
+// Bản dùng được chọn một lần lúc chạy: AVX2 > SSE2 > vô hướng.
+
+// Biên trái/trên tính vào, phải/dưới = x + w, y + h
+struct CollisionRect {
+    float left, top, right, bottom;
+
+    static CollisionRect fromRect(int x, int y, int w, int h) {
+        CollisionRect r = { (float)x, (float)y, (float)(x + w), (float)(y + h) };
+        return r;
+    }
+};
+
+struct RectBatch {
+    std::vector<float> left, top, right, bottom;
+
+    void clear() { left.clear(); top.clear(); right.clear(); bottom.clear(); }
+    void reserve(int n) { left.reserve(n); top.reserve(n); right.reserve(n); bottom.reserve(n); }
+    void push(const CollisionRect& r) {
+        left.push_back(r.left); top.push_back(r.top); right.push_back(r.right); bottom.push_back(r.bottom);
+    }
+    int size() const { return (int)left.size(); }
+};
+
+struct CircleBatch {
+    std::vector<float> x, y, radius;
+
+    void clear() { x.clear(); y.clear(); radius.clear(); }
+    void reserve(int n) { x.reserve(n); y.reserve(n); radius.reserve(n); }
+    void push(float cx, float cy, float r) { x.push_back(cx); y.push_back(cy); radius.push_back(r); }
+    int size() const { return (int)x.size(); }
+};
+
+inline int collisionMaskWords(int count) { return (count + 31) / 32; }
+inline bool collisionMaskTest(const Uint32* mask, int i) { return (mask[i >> 5] >> (i & 31)) & 1u; }
+
+// Hình chữ nhật giao nhau (như SDL_HasIntersection, rỗng thì không chạm)
+void collideRects(const RectBatch& batch, const CollisionRect& player, Uint32* mask);
+// Hình tròn chạm hình chữ nhật (điểm gần nhất, biên phải/dưới tính vào như Coin)
+void collideCircles(const CircleBatch& batch, const CollisionRect& player, Uint32* mask);
+// Tâm hình tròn nằm trong bán kính `radius` quanh (x, y); bỏ qua batch.radius
+void collideCentersInRadius(const CircleBatch& batch, float x, float y, float radius, Uint32* mask);
+
+const char* getCollisionKernelName();
+
+// So mọi bản SIMD có trên máy với bản vô hướng (và bản vô hướng với cách
+// tính cũ) trên dữ liệu ngẫu nhiên. In kết quả, trả về false nếu lệch.
+bool runCollisionSelfTest(int rounds);
+
+#endif // COLLISION_KERNELS_H_INCLUDED
@@ -0,0 +1,174 @@
+#include "collision_mask.h"
+#include <iostream>
+#include <random>
+#include <algorithm>
+
+// ===================== COLLISION MASK IMPLEMENTATION =====================
+
+void CollisionMask::reset(int w, int h) {
+    width = std::max(0, w);
+    height = std::max(0, h);
+    wordsPerRow = (width + 63) / 64;
+    words.assign((size_t)wordsPerRow * height, 0);
+}
+
+void CollisionMask::fillRect(int x, int y, int w, int h) {
+    int left = std::max(0, x), right = std::min(width, x + w);
+    int top = std::max(0, y), bottom = std::min(height, y + h);
+    for (int py = top; py < bottom; py++) {
+        Uint64* r = &words[(size_t)py * wordsPerRow];
+        for (int px = left; px < right; px++) r[px >> 6] |= 1ull << (px & 63);
+    }
+}
+
+CollisionMask CollisionMask::fromAlpha(SDL_Surface* surface, int w, int h, Uint8 threshold) {
+    CollisionMask mask;
+    if (!surface || w <= 0 || h <= 0) return mask;
+
+    SDL_Surface* src = surface;
+    if (surface->format->format != SDL_PIXELFORMAT_RGBA32) {
+        src = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+        if (!src) {
+            std::cerr << "CollisionMask: cannot convert surface: " << SDL_GetError() << std::endl;
+            return mask;
+        }
+    }
+
+    mask.reset(w, h);
+    SDL_LockSurface(src);
+    for (int y = 0; y < h; y++) {
+        int sy = (2 * y + 1) * src->h / (2 * h);
+        const Uint8* srcRow = static_cast<const Uint8*>(src->pixels) + sy * src->pitch;
+        Uint64* r = &mask.words[(size_t)y * mask.wordsPerRow];
+        for (int x = 0; x < w; x++) {
+            int sx = (2 * x + 1) * src->w / (2 * w);
+            if (srcRow[sx * 4 + 3] >= threshold) r[x >> 6] |= 1ull << (x & 63);
+        }
+    }
+    SDL_UnlockSurface(src);
+
+    if (src != surface) SDL_FreeSurface(src);
+    return mask;
+}
+
+bool CollisionMask::test(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return false;
+    return (row(y)[x >> 6] >> (x & 63)) & 1;
+}
+
+int CollisionMask::countSet() const {
+    int count = 0;
+    for (Uint64 w : words) count += __builtin_popcountll(w);
+    return count;
+}
+
+bool CollisionMask::overlaps(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by) {
+    int left = std::max(ax, bx), right = std::min(ax + a.width, bx + b.width);
+    int top = std::max(ay, by), bottom = std::min(ay + a.height, by + b.height);
+    if (left >= right || top >= bottom) return false;
+
+    // Duyệt theo word của a; 64 bit tương ứng của b luôn nằm ở cùng cặp word
+    // và cùng độ dịch trên mọi hàng nên tính một lần cho mỗi cột word
+    int firstWord = (left - ax) >> 6, lastWord = (right - 1 - ax) >> 6;
+    const Uint64* baseA = &a.words[(size_t)(top - ay) * a.wordsPerRow];
+    const Uint64* baseB = &b.words[(size_t)(top - by) * b.wordsPerRow];
+    int rows = bottom - top;
+    for (int w = firstWord; w <= lastWord; w++) {
+        int start = ax + w * 64 - bx;
+        if (start >= b.width || start <= -64) continue;
+        const Uint64* pa = baseA + w;
+        if (start < 0) {
+            int shift = -start;
+            for (int y = 0; y < rows; y++) {
+                if (pa[y * a.wordsPerRow] & (baseB[y * b.wordsPerRow] << shift)) return true;
+            }
+            continue;
+        }
+        int wb = start >> 6, shift = start & 63;
+        const Uint64* pb = baseB + wb;
+        if (shift == 0) {
+            for (int y = 0; y < rows; y++) {
+                if (pa[y * a.wordsPerRow] & pb[y * b.wordsPerRow]) return true;
+            }
+        } else if (wb + 1 < b.wordsPerRow) {
+            for (int y = 0; y < rows; y++) {
+                const Uint64* r = pb + y * b.wordsPerRow;
+                if (pa[y * a.wordsPerRow] & ((r[0] >> shift) | (r[1] << (64 - shift)))) return true;
+            }
+        } else {
+            for (int y = 0; y < rows; y++) {
+                if (pa[y * a.wordsPerRow] & (pb[y * b.wordsPerRow] >> shift)) return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool CollisionMask::overlapsRect(int mx, int my, const SDL_Rect& rect) const {
+    int left = std::max(mx, rect.x) - mx, right = std::min(mx + width, rect.x + rect.w) - mx;
+    int top = std::max(my, rect.y) - my, bottom = std::min(my + height, rect.y + rect.h) - my;
+    if (left >= right || top >= bottom) return false;
+
+    int firstWord = left >> 6, lastWord = (right - 1) >> 6;
+    for (int y = top; y < bottom; y++) {
+        const Uint64* r = row(y);
+        for (int w = firstWord; w <= lastWord; w++) {
+            Uint64 span = ~0ull;
+            if (w == firstWord) span &= ~0ull << (left & 63);
+            if (w == lastWord && (right & 63)) span &= ~0ull >> (64 - (right & 63));
+            if (r[w] & span) return true;
+        }
+    }
+    return false;
+}
+
+bool runCollisionMaskSelfTest(int rounds) {
+    std::mt19937 rng(54321);
+    auto coord = [&rng](int lo, int hi) { return lo + (int)(rng() % (unsigned)(hi - lo + 1)); };
+    auto randomMask = [&](int w, int h) {
+        CollisionMask m;
+        m.reset(w, h);
+        int rects = coord(0, 6);
+        for (int i = 0; i < rects; i++) m.fillRect(coord(-10, w), coord(-10, h), coord(1, w), coord(1, h));
+        return m;
+    };
+
+    int mismatches = 0;
+    for (int round = 0; round < rounds; round++) {
+        CollisionMask a = randomMask(coord(1, 140), coord(1, 120));
+        CollisionMask b = randomMask(coord(1, 140), coord(1, 120));
+        int ax = coord(0, 200), ay = coord(0, 200), bx = coord(-20, 320), by = coord(-20, 320);
+        SDL_Rect rect = { coord(-20, 320), coord(-20, 320), coord(0, 90), coord(0, 90) };
+
+        bool expected = false, expectedRect = false;
+        for (int y = 0; y < a.getHeight(); y++) {
+            for (int x = 0; x < a.getWidth(); x++) {
+                if (!a.test(x, y)) continue;
+                if (b.test(ax + x - bx, ay + y - by)) expected = true;
+                int sx = ax + x, sy = ay + y;
+                if (sx >= rect.x && sx < rect.x + rect.w && sy >= rect.y && sy < rect.y + rect.h) expectedRect = true;
+            }
+        }
+        if (CollisionMask::overlaps(a, ax, ay, b, bx, by) != expected) mismatches++;
+        if (CollisionMask::overlaps(b, bx, by, a, ax, ay) != expected) mismatches++;
+        if (a.overlapsRect(ax, ay, rect) != expectedRect) mismatches++;
+    }
+
+    // Trường hợp xấu nhất: người chơi 100x100 đặc, vật cản không chạm pixel nào
+    CollisionMask player, obstacle;
+    player.reset(100, 100);
+    player.fillRect(0, 0, 100, 100);
+    obstacle.reset(80, 100);
+    const int PAIRS = 200000;
+    int hits = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < PAIRS; i++) {
+        hits += CollisionMask::overlaps(player, 50, 300, obstacle, 50 + (i & 15), 300) ? 1 : 0;
+    }
+    double ns = (double)(SDL_GetPerformanceCounter() - start) * 1e9 / SDL_GetPerformanceFrequency() / PAIRS;
+
+    std::cout << "Collision mask self-test: " << rounds << " rounds, worst case " << ns
+              << " ns/pair (" << hits << " hits) -> "
+              << (mismatches == 0 ? "OK" : "FAILED") << " (" << mismatches << " mismatches)" << std::endl;
+    return mismatches == 0;
+}
@@ -0,0 +1,64 @@
+#ifndef COLLISION_MASK_H_INCLUDED
+#define COLLISION_MASK_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstddef>
+#include "aligned_memory.h"
+
+// Cấp phát căn theo cache line để mỗi mask bắt đầu ở đầu một line
+template <typename T>
+struct CacheAlignedAllocator {
+    typedef T value_type;
+    static const size_t ALIGNMENT = 64;
+
+    CacheAlignedAllocator() {}
+    template <typename U> CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(alignedAlloc(n * sizeof(T), ALIGNMENT)); }
+    void deallocate(T* p, size_t) { alignedFree(p); }
+
+    template <typename U> bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+// Mask va chạm 1 bit/pixel: mỗi hàng là wordsPerRow word 64 bit liền nhau,
+// bit j của word w là cột w * 64 + j. Bit thừa cuối hàng luôn là 0 nên phép
+// AND hai mask lệch nhau không cần cắt thêm. Chỉ dùng sau khi AABB đã chạm.
+class CollisionMask {
+public:
+    CollisionMask() : width(0), height(0), wordsPerRow(0) {}
+
+    // Mask trống cỡ w x h
+    void reset(int w, int h);
+    // Giữ sẵn bộ nhớ cho mask tới cỡ w x h (reset về sau không cấp phát)
+    void reserve(int w, int h) { words.reserve((size_t)((w + 63) / 64) * h); }
+    // Bật mọi pixel trong hình chữ nhật (toạ độ trong mask, tự cắt biên)
+    void fillRect(int x, int y, int w, int h);
+    // Pixel có alpha >= threshold, lấy mẫu gần nhất khi co giãn về w x h
+    static CollisionMask fromAlpha(SDL_Surface* surface, int w, int h, Uint8 threshold = 128);
+
+    bool empty() const { return width == 0 || height == 0; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    bool test(int x, int y) const;
+    int countSet() const;
+    size_t getBytes() const { return words.size() * sizeof(Uint64); }
+
+    // Mask a đặt góc trên trái ở (ax, ay), b ở (bx, by): có pixel nào trùng không
+    static bool overlaps(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by);
+    // Mask đặt ở (mx, my) có pixel nào trong rect (toạ độ màn hình)
+    bool overlapsRect(int mx, int my, const SDL_Rect& rect) const;
+
+private:
+    const Uint64* row(int y) const { return &words[(size_t)y * wordsPerRow]; }
+
+    int width, height, wordsPerRow;
+    std::vector<Uint64, CacheAlignedAllocator<Uint64> > words;
+};
+
+// So narrowphase với phép thử từng pixel trên dữ liệu ngẫu nhiên và đo thời
+// gian trung bình mỗi cặp 100x100 vs vật cản. In kết quả, false nếu lệch.
+bool runCollisionMaskSelfTest(int rounds);
+
+#endif // COLLISION_MASK_H_INCLUDED
@@ -1,36 +1,56 @@
 #ifndef COMBOSYSTEM_H_INCLUDED
 #define COMBOSYSTEM_H_INCLUDED
 #pragma one
+#include "event_bus.h"
+#include "timer_wheel.h"
 
-class ComboSystem {
+class ComboSystem : public GameEventListener, public TimerListener {
 public:
-    int currentCombo, maxCombo, comboTimer, comboTimeout, comboPopTimer;
-    float comboMultiplier, comboScale;
+    int currentCombo, maxCombo, comboTimeout;
+    float comboMultiplier;
+    TimerHandle comboTimer, comboPopTimer;
+    static const int POP_TICKS = 30;
 
-    ComboSystem() { reset(); comboTimeout = 120; }
+    ComboSystem() : timers(nullptr), events(nullptr) { reset(); comboTimeout = 120; }
+
+    void attach(TimerWheel* wheel, EventBus* bus) { timers = wheel; events = bus; }
 
     void reset() {
-        currentCombo = 0; maxCombo = 0; comboTimer = 0;
-        comboMultiplier = 1.0f; comboPopTimer = 0; comboScale = 1.0f;
+        currentCombo = 0; maxCombo = 0;
+        comboMultiplier = 1.0f;
+        if (timers) { timers->cancel(comboTimer); timers->cancel(comboPopTimer); }
     }
 
     void addCombo() {
         currentCombo++;
-        comboTimer = comboTimeout;
         if (currentCombo > maxCombo) maxCombo = currentCombo;
         comboMultiplier = 1.0f + (currentCombo / 5) * 0.5f;
-        comboPopTimer = 30; comboScale = 1.5f;
+        if (timers) {
+            timers->cancel(comboTimer);
+            comboTimer = timers->schedule(comboTimeout, this, TIMER_TIMEOUT);
+            timers->cancel(comboPopTimer);
+            comboPopTimer = timers->schedule(POP_TICKS, this, TIMER_POP);
+        }
     }
 
-    void update() {
-        if (currentCombo > 0 && --comboTimer <= 0) {
-            currentCombo = 0; comboMultiplier = 1.0f;
-        }
-        if (comboPopTimer > 0) {
-            comboPopTimer--;
-            comboScale = 1.5f - (30 - comboPopTimer) * 0.017f;
-            if (comboScale < 1.0f) comboScale = 1.0f;
-        }
+    // Hết comboTimeout frame không nhặt thêm xu thì mất combo
+    void onTimer(int timerId) override {
+        if (timerId == TIMER_TIMEOUT) { currentCombo = 0; comboMultiplier = 1.0f; }
+    }
+
+    // Phóng to 1.5x khi vừa tăng combo rồi thu dần về 1x
+    float getComboScale() const {
+        if (!timers || !timers->isPending(comboPopTimer)) return 1.0f;
+        float scale = 1.5f - (POP_TICKS - (int)timers->getRemaining(comboPopTimer)) * 0.017f;
+        return scale < 1.0f ? 1.0f : scale;
+    }
+
+    // Mỗi xu nhặt được tăng combo một lần; combo mới được giao ngay trong
+    // lượt dispatch này (audio lấy pitch xu từ đây)
+    void onGameEvent(const GameEvent& event) override {
+        if (event.type != EVENT_COIN_COLLECTED) return;
+        addCombo();
+        if (events) events->publish(GameEvent::comboIncreased(currentCombo));
     }
 
     void render(SDL_Renderer* renderer, TTF_Font* font, int screenWidth) {
@@ -40,6 +60,7 @@ public:
         SDL_Surface* surface = TTF_RenderUTF8_Blended(font, comboText.c_str(), color);
         if (surface) {
             SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+            float comboScale = getComboScale();
             int w = (int)(surface->w * comboScale), h = (int)(surface->h * comboScale);
             SDL_Rect dst = {screenWidth / 2 - w / 2, 100, w, h};
             SDL_RenderCopy(renderer, texture, nullptr, &dst);
@@ -49,6 +70,12 @@ public:
     }
 
     int getMaxCombo() const { return maxCombo; }
+
+private:
+    enum { TIMER_TIMEOUT, TIMER_POP };
+
+    TimerWheel* timers;
+    EventBus* events;
 };
 
 #endif // COMBOSYSTEM_H_INCLUDED
@@ -0,0 +1,133 @@
+#include "content_db.h"
+#include <iostream>
+
+// Có content.db cạnh file chạy thì dùng (mod), không thì bản nhúng. Cả hai
+// sinh từ content/main.txt ở bước pre-build
+static const char* CONTENT_DB_PATH = "content.db";
+
+// CONTENT_BUILTIN: sinh bởi tools/content_compiler (xem Game.cbp)
+#include "content_builtin.inc"
+
+// ===================== CONTENT DB IMPLEMENTATION =====================
+
+ContentDB::ContentDB()
+    : base(nullptr), quests(nullptr), achievements(nullptr), shopItems(nullptr), strings(nullptr) {
+    memset(&header, 0, sizeof(header));
+}
+
+bool ContentDB::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    if (!attach(file.data(), file.size(), path.c_str())) {
+        close();
+        return false;
+    }
+    std::cout << "Content " << path << ": " << questCount() << " quests, " << achievementCount()
+              << " achievements, " << shopItemCount() << " shop items" << std::endl;
+    return true;
+}
+
+bool ContentDB::openBuiltin() {
+    close();
+    if (!attach(reinterpret_cast<const char*>(CONTENT_BUILTIN), sizeof(CONTENT_BUILTIN), "built-in content")) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ContentDB::close() {
+    file.close();
+    base = nullptr;
+    memset(&header, 0, sizeof(header));
+    quests = nullptr;
+    achievements = nullptr;
+    shopItems = nullptr;
+    strings = nullptr;
+}
+
+// true nếu id của def thứ index đã xuất hiện ở trước nó. So tuần tự để
+// không cấp phát; bảng chỉ vài chục def
+template <typename Def>
+static bool duplicateId(const Def* table, Uint32 index) {
+    for (Uint32 i = 0; i < index; i++) {
+        if (table[i].id == table[index].id) return true;
+    }
+    return false;
+}
+
+bool ContentDB::attach(const char* data, size_t size, const char* source) {
+    if (size < sizeof(ContentHeader)) {
+        std::cerr << "ContentDB: " << source << " is too small" << std::endl;
+        return false;
+    }
+
+    ContentHeader h;
+    memcpy(&h, data, sizeof(h));
+    if (memcmp(h.magic, CONTENT_MAGIC, sizeof(CONTENT_MAGIC)) != 0 || h.version != CONTENT_VERSION) {
+        std::cerr << "ContentDB: " << source << " has wrong magic/version" << std::endl;
+        return false;
+    }
+
+    auto tableFits = [size](Uint32 offset, Uint32 count, size_t itemSize) {
+        return offset % 4 == 0 && (Uint64)offset + (Uint64)count * itemSize <= size;
+    };
+    if (!tableFits(h.questOffset, h.questCount, sizeof(QuestDef)) ||
+        !tableFits(h.achievementOffset, h.achievementCount, sizeof(AchievementDef)) ||
+        !tableFits(h.shopItemOffset, h.shopItemCount, sizeof(ShopItemDef)) ||
+        h.stringSize == 0 || (Uint64)h.stringOffset + h.stringSize > size ||
+        data[h.stringOffset + h.stringSize - 1] != '\0') {
+        std::cerr << "ContentDB: " << source << " has a corrupt table" << std::endl;
+        return false;
+    }
+    // Skin 0 là skin mặc định, luôn được sở hữu
+    if (h.shopItemCount == 0) {
+        std::cerr << "ContentDB: " << source << " has no shop items" << std::endl;
+        return false;
+    }
+
+    // Kiểm tra một lần ở đây để code dùng def không phải kiểm tra lại
+    const QuestDef* questTable = reinterpret_cast<const QuestDef*>(data + h.questOffset);
+    const AchievementDef* achievementTable = reinterpret_cast<const AchievementDef*>(data + h.achievementOffset);
+    const ShopItemDef* shopTable = reinterpret_cast<const ShopItemDef*>(data + h.shopItemOffset);
+
+    for (Uint32 i = 0; i < h.questCount; i++) {
+        const QuestDef& q = questTable[i];
+        if (q.title >= h.stringSize || q.description >= h.stringSize || q.type >= CONTENT_QUEST_TYPES ||
+            q.pool >= QUEST_POOL_COUNT || q.requirement <= 0 || q.coinReward < 0 || q.xpReward < 0 ||
+            duplicateId(questTable, i)) {
+            std::cerr << "ContentDB: " << source << " quest " << i << " is invalid" << std::endl;
+            return false;
+        }
+    }
+    for (Uint32 i = 0; i < h.achievementCount; i++) {
+        const AchievementDef& a = achievementTable[i];
+        if (a.name >= h.stringSize || a.description >= h.stringSize || a.type >= CONTENT_ACHIEVEMENT_TYPES ||
+            a.requirement <= 0 || a.reward < 0 || duplicateId(achievementTable, i)) {
+            std::cerr << "ContentDB: " << source << " achievement " << i << " is invalid" << std::endl;
+            return false;
+        }
+    }
+    for (Uint32 i = 0; i < h.shopItemCount; i++) {
+        const ShopItemDef& s = shopTable[i];
+        if (s.name >= h.stringSize || s.description >= h.stringSize || s.baseSprite >= h.stringSize || s.price < 0) {
+            std::cerr << "ContentDB: " << source << " shop item " << i << " is invalid" << std::endl;
+            return false;
+        }
+    }
+
+    base = data;
+    header = h;
+    quests = questTable;
+    achievements = achievementTable;
+    shopItems = shopTable;
+    strings = data + h.stringOffset;
+    return true;
+}
+
+const ContentDB& gameContent() {
+    static ContentDB content;
+    static bool opened = content.open(CONTENT_DB_PATH) || content.openBuiltin();
+    (void)opened;
+    return content;
+}
@@ -0,0 +1,104 @@
+#ifndef CONTENT_DB_H_INCLUDED
+#define CONTENT_DB_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <cstring>
+#include "mapped_file.h"
+
+// Định dạng content.db (little-endian), tạo bởi tools/content_compiler từ file text:
+//   [ContentHeader][QuestDef x questCount][AchievementDef x achievementCount]
+//   [ShopItemDef x shopItemCount][bảng chuỗi UTF-8, mỗi chuỗi kết thúc bằng '\0']
+// Nội dung tĩnh (tên, mô tả, ngưỡng, thưởng) chỉ nằm trong vùng map; các struct
+// lúc chạy (Quest, Achievement, ShopItem) giữ con trỏ tới def cùng tiến độ.
+// Chuỗi lưu dưới dạng offset trong bảng chuỗi, đọc qua ContentDB::text().
+static const char CONTENT_MAGIC[4] = { 'D', 'C', 'D', 'B' };
+static const Uint32 CONTENT_VERSION = 1;
+static const Uint32 CONTENT_QUEST_TYPES = 8;        // Quest::TYPE_COUNT
+static const Uint32 CONTENT_ACHIEVEMENT_TYPES = 4;  // Achievement::TYPE_COUNT
+static const int CONTENT_PALETTE_KEYS = 5;          // SKIN_PALETTE_KEYS
+
+enum QuestPool {
+    QUEST_POOL_DAILY,
+    QUEST_POOL_MAIN,
+    QUEST_POOL_COUNT
+};
+
+struct ContentHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 questCount, questOffset;
+    Uint32 achievementCount, achievementOffset;
+    Uint32 shopItemCount, shopItemOffset;
+    Uint32 stringOffset, stringSize;
+};
+
+struct QuestDef {
+    Sint32 id;
+    Uint32 title, description;      // Offset trong bảng chuỗi
+    Uint8 type;                     // Quest::Type
+    Uint8 pool;                     // QuestPool
+    Uint8 accumulative;             // 1: tiến độ theo tổng tích luỹ của player
+    Uint8 reserved;
+    Sint32 requirement, coinReward, xpReward;
+};
+
+struct AchievementDef {
+    Sint32 id;
+    Uint32 name, description;
+    Uint32 type;                    // Achievement::Type
+    Sint32 requirement, reward;
+};
+
+struct ShopItemDef {
+    Sint32 id;
+    Uint32 name, description, baseSprite;
+    Sint32 price;
+    SDL_Color palette[CONTENT_PALETTE_KEYS];
+};
+
+SDL_COMPILE_TIME_ASSERT(content_header_size, sizeof(ContentHeader) == 40);
+SDL_COMPILE_TIME_ASSERT(quest_def_size, sizeof(QuestDef) == 28);
+SDL_COMPILE_TIME_ASSERT(achievement_def_size, sizeof(AchievementDef) == 24);
+SDL_COMPILE_TIME_ASSERT(shop_item_def_size, sizeof(ShopItemDef) == 40);
+
+// Content DB chỉ đọc: mmap content.db, hoặc image nhúng lúc build (content_builtin.inc).
+// Khi mở, toàn bộ bảng được kiểm tra một lần; sau đó đọc thẳng không kiểm tra.
+class ContentDB {
+public:
+    ContentDB();
+
+    bool open(const std::string& path);
+    bool openBuiltin();
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    int questCount() const { return (int)header.questCount; }
+    const QuestDef& quest(int index) const { return quests[index]; }
+    int achievementCount() const { return (int)header.achievementCount; }
+    const AchievementDef& achievement(int index) const { return achievements[index]; }
+    int shopItemCount() const { return (int)header.shopItemCount; }
+    const ShopItemDef& shopItem(int index) const { return shopItems[index]; }
+
+    const char* text(Uint32 offset) const { return strings + offset; }
+
+private:
+    ContentDB(const ContentDB&);
+    ContentDB& operator=(const ContentDB&);
+
+    bool attach(const char* data, size_t size, const char* source);
+
+    MappedFile file;
+    const char* base;
+    ContentHeader header;
+    const QuestDef* quests;
+    const AchievementDef* achievements;
+    const ShopItemDef* shopItems;
+    const char* strings;
+};
+
+// Content DB của game: content.db nếu có và hợp lệ, không thì nội dung có sẵn.
+// Mở ở lần gọi đầu tiên và sống tới khi thoát.
+const ContentDB& gameContent();
+
+#endif // CONTENT_DB_H_INCLUDED
@@ -0,0 +1,525 @@
+#include "ecs.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include "aligned_memory.h"
+
+// Chim: như cộng sin(tuổi * tần số) * bước vào y mỗi frame
+static const float BOB_FREQUENCY = 0.1f;
+static const float BOB_STEP = 2.0f;
+
+static const size_t CHUNK_ALIGNMENT = 64;
+
+// Định nghĩa ngoài lớp cho C++14: std::min nhận tham chiếu tới ROWS
+constexpr int ArchetypeChunk::ROWS;
+
+// ===================== ARCHETYPE IMPLEMENTATION =====================
+
+Archetype::Archetype()
+    : components(0), blockBytes(0), rows(0), maxWidth(0), cosmeticLine(-1e300), highWater(0),
+      spawned(0), evicted(0), dropped(0), queries(0), candidates(0) {}
+
+Archetype::~Archetype() {
+    for (auto& c : chunks) alignedFree(c.block);
+}
+
+void Archetype::init(Uint32 componentMask) {
+    components = componentMask | COMP_POSITION | COMP_FLAGS;
+}
+
+void Archetype::addChunk() {
+    const int N = ArchetypeChunk::ROWS;
+    // Mỗi mảng bắt đầu ở đầu một cache line
+    size_t offset = 0;
+    auto take = [&offset](size_t bytes) {
+        size_t at = offset;
+        offset += (bytes + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT;
+        return at;
+    };
+    size_t worldXAt = take(N * sizeof(double));
+    size_t yAt = take(N * sizeof(float));
+    size_t vxAt = has(COMP_VELOCITY) ? take(N * sizeof(float)) : 0;
+    size_t vyAt = has(COMP_VELOCITY) ? take(N * sizeof(float)) : 0;
+    size_t widthAt = has(COMP_BOUNDS) ? take(N * sizeof(Sint16)) : 0;
+    size_t heightAt = has(COMP_BOUNDS) ? take(N * sizeof(Sint16)) : 0;
+    size_t kindAt = has(COMP_TAG) ? take(N) : 0;
+    size_t variantAt = has(COMP_TAG) ? take(N) : 0;
+    size_t birthAt = has(COMP_ANIMATION) ? take(N * sizeof(Uint32)) : 0;
+    size_t flagsAt = take(N);
+    size_t entityAt = take(N * sizeof(int));
+
+    blockBytes = offset;
+    char* block = static_cast<char*>(alignedAlloc(offset, CHUNK_ALIGNMENT));
+    ArchetypeChunk c;
+    c.block = block;
+    c.worldX = reinterpret_cast<double*>(block + worldXAt);
+    c.y = reinterpret_cast<float*>(block + yAt);
+    c.vx = has(COMP_VELOCITY) ? reinterpret_cast<float*>(block + vxAt) : nullptr;
+    c.vy = has(COMP_VELOCITY) ? reinterpret_cast<float*>(block + vyAt) : nullptr;
+    c.width = has(COMP_BOUNDS) ? reinterpret_cast<Sint16*>(block + widthAt) : nullptr;
+    c.height = has(COMP_BOUNDS) ? reinterpret_cast<Sint16*>(block + heightAt) : nullptr;
+    c.kind = has(COMP_TAG) ? reinterpret_cast<Uint8*>(block + kindAt) : nullptr;
+    c.variant = has(COMP_TAG) ? reinterpret_cast<Uint8*>(block + variantAt) : nullptr;
+    c.birth = has(COMP_ANIMATION) ? reinterpret_cast<Uint32*>(block + birthAt) : nullptr;
+    c.flags = reinterpret_cast<Uint8*>(block + flagsAt);
+    c.entity = reinterpret_cast<int*>(block + entityAt);
+    chunks.push_back(c);
+}
+
+size_t Archetype::reservedBytes() const {
+    return chunks.size() * blockBytes + chunks.capacity() * sizeof(ArchetypeChunk)
+         + entityRow.capacity() * sizeof(int) + generations.capacity() * sizeof(Uint32)
+         + freeIds.capacity() * sizeof(int);
+}
+
+void Archetype::copyRow(int from, int to) {
+    const ArchetypeChunk& a = chunks[from >> 6];
+    ArchetypeChunk& b = chunks[to >> 6];
+    int i = from & 63, j = to & 63;
+    b.worldX[j] = a.worldX[i];
+    b.y[j] = a.y[i];
+    if (b.vx) { b.vx[j] = a.vx[i]; b.vy[j] = a.vy[i]; }
+    if (b.width) { b.width[j] = a.width[i]; b.height[j] = a.height[i]; }
+    if (b.kind) { b.kind[j] = a.kind[i]; b.variant[j] = a.variant[i]; }
+    if (b.birth) b.birth[j] = a.birth[i];
+    b.flags[j] = a.flags[i];
+    b.entity[j] = a.entity[i];
+    entityRow[b.entity[j]] = to;
+}
+
+void Archetype::swapRows(int first, int second) {
+    ArchetypeChunk& a = chunks[first >> 6];
+    ArchetypeChunk& b = chunks[second >> 6];
+    int i = first & 63, j = second & 63;
+    std::swap(a.worldX[i], b.worldX[j]);
+    std::swap(a.y[i], b.y[j]);
+    if (a.vx) { std::swap(a.vx[i], b.vx[j]); std::swap(a.vy[i], b.vy[j]); }
+    if (a.width) { std::swap(a.width[i], b.width[j]); std::swap(a.height[i], b.height[j]); }
+    if (a.kind) { std::swap(a.kind[i], b.kind[j]); std::swap(a.variant[i], b.variant[j]); }
+    if (a.birth) std::swap(a.birth[i], b.birth[j]);
+    std::swap(a.flags[i], b.flags[j]);
+    std::swap(a.entity[i], b.entity[j]);
+    entityRow[a.entity[i]] = first;
+    entityRow[b.entity[j]] = second;
+}
+
+void Archetype::releaseRow(int row) {
+    int id = entity(row);
+    entityRow[id] = -1;
+    generations[id]++;
+    freeIds.push_back(id);
+}
+
+// ===================== ENTITY REGISTRY IMPLEMENTATION =====================
+
+EntityRegistry::EntityRegistry(const AnimationClock* clock) : clock(clock) {
+    const Uint32 common = COMP_POSITION | COMP_BOUNDS | COMP_TAG | COMP_ANIMATION | COMP_FLAGS;
+    archetypes[ARCH_OBSTACLE].init(common | COMP_VELOCITY);
+    archetypes[ARCH_COIN].init(common);
+    archetypes[ARCH_POWERUP].init(common);
+}
+
+void EntityRegistry::reserve(ArchetypeId arch, int capacity) {
+    Archetype& a = archetypes[arch];
+    int oldIds = a.capacity();
+    while (a.capacity() < capacity) a.addChunk();
+    if (a.capacity() == oldIds) return;
+
+    a.entityRow.resize(a.capacity(), -1);
+    a.generations.resize(a.capacity(), 1);
+    a.freeIds.reserve(a.capacity());
+    for (int i = a.capacity() - 1; i >= oldIds; i--) a.freeIds.push_back(i);
+}
+
+void EntityRegistry::clear(ArchetypeId arch) {
+    Archetype& a = archetypes[arch];
+    for (int row = a.rows - 1; row >= 0; row--) a.releaseRow(row);
+    a.rows = 0;
+}
+
+int EntityRegistry::create(ArchetypeId arch, double worldX) {
+    Archetype& a = archetypes[arch];
+    if (a.rows == a.capacity()) {
+        // Đầy: vật đầu dãy đã qua người chơi chỉ còn để nhìn, nhường chỗ
+        if (a.rows > 0 && a.worldX(0) + a.width(0) < a.cosmeticLine) {
+            a.releaseRow(0);
+            for (int row = 1; row < a.rows; row++) a.copyRow(row, row - 1);
+            a.rows--;
+            a.evicted++;
+        } else {
+            a.dropped++;
+            return -1;
+        }
+    }
+    int id = a.freeIds.back();
+    a.freeIds.pop_back();
+    int row = a.rows++;
+    ArchetypeChunk& c = a.chunks[row >> 6];
+    int i = row & 63;
+    c.worldX[i] = worldX;
+    c.y[i] = 0.0f;
+    if (c.vx) { c.vx[i] = 0.0f; c.vy[i] = 0.0f; }
+    if (c.width) { c.width[i] = 0; c.height[i] = 0; }
+    if (c.kind) { c.kind[i] = 0; c.variant[i] = 0; }
+    if (c.birth) c.birth[i] = clock->now();
+    c.flags[i] = ENTITY_ALIVE;
+    c.entity[i] = id;
+    a.entityRow[id] = row;
+
+    // Sinh ở mép phải nên thường đã đúng chỗ; thiên thạch sinh giữa màn hình thì lùi về
+    while (row > 0 && a.worldX(row) < a.worldX(row - 1)) {
+        a.swapRows(row, row - 1);
+        row--;
+    }
+
+    a.spawned++;
+    if (a.rows > a.highWater) a.highWater = a.rows;
+    return row;
+}
+
+void EntityRegistry::noteWidth(ArchetypeId arch, int width) {
+    Archetype& a = archetypes[arch];
+    if (width > a.maxWidth) a.maxWidth = width;
+}
+
+EntityId EntityRegistry::idOf(ArchetypeId arch, int row) const {
+    EntityId id;
+    const Archetype& a = archetypes[arch];
+    if (row < 0 || row >= a.rows) return id;
+    id.arch = arch;
+    id.index = a.entity(row);
+    id.generation = a.generations[id.index];
+    return id;
+}
+
+int EntityRegistry::rowOf(const EntityId& id) const {
+    if (id.arch < 0 || id.arch >= ARCH_COUNT) return -1;
+    const Archetype& a = archetypes[id.arch];
+    if (id.index < 0 || id.index >= (int)a.entityRow.size()) return -1;
+    if (a.generations[id.index] != id.generation) return -1;
+    return a.entityRow[id.index];
+}
+
+void EntityRegistry::removeDead(ArchetypeId arch) {
+    Archetype& a = archetypes[arch];
+    int kept = 0;
+    for (int row = 0; row < a.rows; row++) {
+        if (!(a.flags(row) & ENTITY_ALIVE)) {
+            a.releaseRow(row);
+            continue;
+        }
+        if (kept != row) a.copyRow(row, kept);
+        kept++;
+    }
+    a.rows = kept;
+}
+
+void EntityRegistry::cullBehind(ArchetypeId arch, const WorldScroll& world) {
+    Archetype& a = archetypes[arch];
+    int n = 0;
+    while (n < a.rows && world.isBehind(a.worldX(n), a.width(n))) {
+        a.releaseRow(n);
+        n++;
+    }
+    if (n == 0) return;
+    for (int row = n; row < a.rows; row++) a.copyRow(row, row - n);
+    a.rows -= n;
+}
+
+void EntityRegistry::resort(ArchetypeId arch) {
+    Archetype& a = archetypes[arch];
+    for (int i = 1; i < a.rows; i++) {
+        for (int j = i; j > 0 && a.worldX(j) < a.worldX(j - 1); j--) a.swapRows(j, j - 1);
+    }
+}
+
+void EntityRegistry::rebase(double shift) {
+    for (int arch = 0; arch < ARCH_COUNT; arch++) {
+        Archetype& a = archetypes[arch];
+        for (int c = 0; c < a.chunkCount(); c++) {
+            ArchetypeChunk& chunk = a.chunks[c];
+            int n = a.chunkSize(c);
+            for (int i = 0; i < n; i++) chunk.worldX[i] -= shift;
+        }
+        a.cosmeticLine -= shift;
+    }
+}
+
+int EntityRegistry::lowerBound(Archetype& a, double worldX) {
+    int lo = 0, hi = a.rows;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (a.worldX(mid) < worldX) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void EntityRegistry::logStats(ArchetypeId arch, const char* name) const {
+    const Archetype& a = archetypes[arch];
+    std::cout << "Entities " << name << ": " << a.highWater << "/" << a.capacity()
+              << " high-water in " << a.chunks.size() << " chunk(s), " << a.spawned << " spawned, "
+              << a.evicted << " evicted, " << a.dropped << " dropped, "
+              << a.candidates << " candidates in " << a.queries << " window queries" << std::endl;
+}
+
+// ===================== SYSTEMS IMPLEMENTATION =====================
+
+bool runMotionSystem(EntityRegistry& registry, ArchetypeId arch, float deathY) {
+    Archetype& a = registry.archetype(arch);
+    if (!a.has(COMP_VELOCITY)) return false;
+
+    bool movedX = false;
+    for (int c = 0; c < a.chunkCount(); c++) {
+        ArchetypeChunk& k = a.chunk(c);
+        int n = a.chunkSize(c);
+        for (int i = 0; i < n; i++) {
+            Uint8 f = k.flags[i];
+            if (!(f & ENTITY_ALIVE)) continue;
+            k.worldX[i] += k.vx[i];
+            k.y[i] += k.vy[i];
+            if (k.vx[i] != 0.0f) movedX = true;
+            if (f & ENTITY_FALLING) {
+                if (k.vy[i] < FALL_MAX_SPEED) k.vy[i] += FALL_ACCELERATION;
+                if (k.y[i] > deathY) k.flags[i] = f & ~ENTITY_ALIVE;
+            }
+        }
+    }
+    return movedX;
+}
+
+// Tổng sin(k * f) * bước với k = 0..age-1 viết gọn:
+// sin(age * f / 2) * sin((age - 1) * f / 2) / sin(f / 2)
+float bobOffset(Uint32 age) {
+    static const float HALF = BOB_FREQUENCY * 0.5f;
+    static const float SCALE = BOB_STEP / std::sin(HALF);
+    float n = (float)age;
+    return SCALE * lutSin(n * HALF) * lutSin((n - 1.0f) * HALF);
+}
+
+// y dùng cho va chạm và vẽ (y gốc cộng nhấp nhô)
+static float effectiveY(Archetype& a, const AnimationClock& clock, int row) {
+    if (!(a.flags(row) & ENTITY_BOBBING)) return a.y(row);
+    return a.y(row) + bobOffset(clock.now() - a.birth(row));
+}
+
+void runScrollSystem(EntityRegistry& registry, ArchetypeId arch, const WorldScroll& world, bool resort) {
+    Archetype& a = registry.archetype(arch);
+    bool anyDead = false;
+    for (int c = 0; c < a.chunkCount() && !anyDead; c++) {
+        ArchetypeChunk& k = a.chunk(c);
+        int n = a.chunkSize(c);
+        for (int i = 0; i < n; i++) {
+            if (!(k.flags[i] & ENTITY_ALIVE)) { anyDead = true; break; }
+        }
+    }
+    if (anyDead) registry.removeDead(arch);
+    if (resort) registry.resort(arch);
+    registry.cullBehind(arch, world);
+}
+
+void gatherRects(EntityRegistry& registry, ArchetypeId arch, const WorldScroll& world,
+                 double minX, double maxX, Uint8 requireFlags, RectBatch& batch, std::vector<int>& rows) {
+    Archetype& a = registry.archetype(arch);
+    batch.clear();
+    rows.clear();
+    registry.forEachInWindow(arch, minX, maxX, [&](int row) {
+        if ((a.flags(row) & requireFlags) != requireFlags || (a.flags(row) & ENTITY_COLLECTED)) return;
+        int h = a.height(row);
+        int y = (int)effectiveY(a, registry.getClock(), row);
+        batch.push(CollisionRect::fromRect(world.toScreen(a.worldX(row)), y - h, a.width(row), h));
+        rows.push_back(row);
+    });
+}
+
+void gatherCircles(EntityRegistry& registry, ArchetypeId arch, const WorldScroll& world,
+                   double minX, double maxX, Uint8 requireFlags, CircleBatch& batch, std::vector<int>& rows) {
+    Archetype& a = registry.archetype(arch);
+    batch.clear();
+    rows.clear();
+    registry.forEachInWindow(arch, minX, maxX, [&](int row) {
+        if ((a.flags(row) & requireFlags) != requireFlags || (a.flags(row) & ENTITY_COLLECTED)) return;
+        int w = a.width(row), h = a.height(row);
+        int y = (int)effectiveY(a, registry.getClock(), row);
+        batch.push((float)(world.toScreen(a.worldX(row)) + w/2), (float)(y - h/2), (float)(w/2));
+        rows.push_back(row);
+    });
+}
+
+void buildRenderList(EntityRegistry& registry, ArchetypeId arch, const WorldScroll& world,
+                     int screenWidth, std::vector<RenderItem>& out) {
+    Archetype& a = registry.archetype(arch);
+    const AnimationClock& clock = registry.getClock();
+    out.clear();
+    for (int c = 0; c < a.chunkCount(); c++) {
+        ArchetypeChunk& k = a.chunk(c);
+        int n = a.chunkSize(c);
+        for (int i = 0; i < n; i++) {
+            if ((k.flags[i] & (ENTITY_ALIVE | ENTITY_COLLECTED)) != ENTITY_ALIVE) continue;
+            int x = world.toScreen(k.worldX[i]);
+            int w = k.width[i];
+            // Phần vẽ thêm (nhánh xương rồng, đầu chim) thò ra tối đa một lần bề rộng
+            if (x + 2 * w < 0 || x - w >= screenWidth) continue;
+            Uint32 age = clock.now() - k.birth[i];
+            float y = k.y[i];
+            if (k.flags[i] & ENTITY_BOBBING) y += bobOffset(age);
+            RenderItem item;
+            item.entity = k.entity[i];
+            item.x = x;
+            item.y = (int)y;
+            item.width = w;
+            item.height = k.height[i];
+            item.kind = k.kind[i];
+            item.variant = k.variant[i];
+            item.age = (float)age;
+            out.push_back(item);
+        }
+    }
+}
+
+// ===================== SELF TEST =====================
+
+namespace {
+
+struct RefEntity {
+    EntityId id;
+    double worldX;
+    int width;
+};
+
+bool byWorldX(const RefEntity& a, const RefEntity& b) { return a.worldX < b.worldX; }
+
+}
+
+bool runEntitySelfTest(int frames) {
+    static const int CAPACITY[ARCH_COUNT] = { 128, 64, 64 };
+    static const int STALE_HANDLES = 64;
+    std::mt19937 rng(24680);
+    auto chance = [&rng](int percent) { return (int)(rng() % 100u) < percent; };
+    auto coord = [&rng](int lo, int hi) { return lo + (int)(rng() % (unsigned)(hi - lo + 1)); };
+
+    AnimationClock clock;
+    WorldScroll world;
+    world.setSpeed(6.0f);
+    EntityRegistry registry(&clock);
+    std::vector<RefEntity> expected[ARCH_COUNT];
+    std::vector<EntityId> stale;
+    size_t reserved[ARCH_COUNT];
+    for (int arch = 0; arch < ARCH_COUNT; arch++) {
+        registry.reserve((ArchetypeId)arch, CAPACITY[arch]);
+        reserved[arch] = registry.archetype((ArchetypeId)arch).reservedBytes();
+        expected[arch].reserve(CAPACITY[arch]);
+    }
+    stale.reserve(STALE_HANDLES);
+
+    int mismatches = 0, allocations = 0, rebases = 0;
+    Uint64 spawned = 0, evicted = 0, dropped = 0, checked = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        clock.advance();
+        world.advance();
+        if (world.needsRebase()) {
+            double shift = std::floor(world.getOffset());
+            world.rebase(shift);
+            registry.rebase(shift);
+            for (auto& ref : expected) {
+                for (auto& e : ref) e.worldX -= shift;
+            }
+            rebases++;
+        }
+
+        for (int arch = 0; arch < ARCH_COUNT; arch++) {
+            ArchetypeId id = (ArchetypeId)arch;
+            Archetype& a = registry.archetype(id);
+            std::vector<RefEntity>& ref = expected[arch];
+            double left = world.getOffset() + 100.0;
+            registry.setCosmeticLine(id, left);
+
+            // Sinh ở mép phải, thỉnh thoảng giữa màn hình như thiên thạch
+            int spawns = chance(60) ? coord(1, 2) : 0;
+            for (int s = 0; s < spawns; s++) {
+                double worldX = world.getOffset() + (chance(10) ? coord(0, 800) : coord(800, 1000)) + coord(0, 999) / 1000.0;
+                int width = coord(10, 80);
+                bool full = (int)ref.size() == a.capacity();
+                bool evicts = full && ref.front().worldX + ref.front().width < left;
+                int row = registry.create(id, worldX);
+                if (full && !evicts) {
+                    if (row != -1) mismatches++;
+                    dropped++;
+                    continue;
+                }
+                if (row < 0) { mismatches++; continue; }
+                if (evicts) {
+                    if ((int)stale.size() < STALE_HANDLES) stale.push_back(ref.front().id);
+                    ref.erase(ref.begin());
+                    evicted++;
+                }
+                spawned++;
+                a.width(row) = (Sint16)width;
+                registry.noteWidth(id, width);
+                RefEntity e = { registry.idOf(id, row), worldX, width };
+                ref.insert(std::upper_bound(ref.begin(), ref.end(), e, byWorldX), e);
+            }
+
+            // Giết vài hàng, dời vài hàng (vật tự di chuyển) rồi dọn như runScrollSystem
+            bool moved = false;
+            for (auto& e : ref) {
+                int row = registry.rowOf(e.id);
+                if (row < 0) { mismatches++; continue; }
+                if (chance(2)) {
+                    a.flags(row) &= ~ENTITY_ALIVE;
+                } else if (arch == ARCH_OBSTACLE && chance(5)) {
+                    e.worldX += coord(-8, 2);
+                    a.worldX(row) = e.worldX;
+                    moved = true;
+                }
+            }
+            for (size_t i = 0; i < ref.size(); ) {
+                int row = registry.rowOf(ref[i].id);
+                if (row >= 0 && !(a.flags(row) & ENTITY_ALIVE)) {
+                    if ((int)stale.size() < STALE_HANDLES) stale.push_back(ref[i].id);
+                    ref.erase(ref.begin() + i);
+                } else {
+                    i++;
+                }
+            }
+            registry.removeDead(id);
+            if (moved) {
+                registry.resort(id);
+                std::stable_sort(ref.begin(), ref.end(), byWorldX);
+            }
+            registry.cullBehind(id, world);
+            while (!ref.empty() && world.isBehind(ref.front().worldX, ref.front().width)) {
+                if ((int)stale.size() < STALE_HANDLES) stale.push_back(ref.front().id);
+                ref.erase(ref.begin());
+            }
+
+            // Cùng thứ tự, mỗi handle trỏ đúng hàng của nó
+            if (a.size() != (int)ref.size()) {
+                mismatches++;
+                continue;
+            }
+            for (int row = 0; row < a.size(); row++) {
+                if (registry.rowOf(ref[row].id) != row || a.worldX(row) != ref[row].worldX) mismatches++;
+                if (row > 0 && a.worldX(row) < a.worldX(row - 1)) mismatches++;
+            }
+            checked += a.size();
+            if (a.reservedBytes() != reserved[arch]) {
+                allocations++;
+                reserved[arch] = a.reservedBytes();
+            }
+        }
+
+        for (const EntityId& e : stale) {
+            if (registry.rowOf(e) != -1) mismatches++;
+        }
+        stale.clear();
+    }
+
+    bool ok = mismatches == 0 && allocations == 0;
+    std::cout << "Entity self-test: " << frames << " frames, " << spawned << " spawned, "
+              << evicted << " evicted, " << dropped << " dropped, " << rebases << " rebases, "
+              << checked << " rows checked -> " << (ok ? "OK" : "FAILED") << " ("
+              << mismatches << " mismatches, " << allocations << " allocations)" << std::endl;
+    return ok;
+}
@@ -0,0 +1,227 @@
+#ifndef ECS_H_INCLUDED
+#define ECS_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <algorithm>
+#include "world_scroll.h"
+#include "collision_kernels.h"
+#include "anim_clock.h"
+
+// ECS nhỏ cho mọi thực thể cuộn theo màn hình (vật cản, xu, power-up).
+// Mỗi archetype là một dãy chunk 64 hàng; trong chunk mỗi component là một
+// mảng liền (SoA) nên các system chỉ chạy vòng lặp phẳng trên mảng.
+// Hàng trong archetype luôn xếp theo worldX tăng dần (như sweep-and-prune):
+// tìm cửa sổ va chạm bằng tìm nhị phân, bỏ vật trôi qua mép trái chỉ cần cắt
+// đầu dãy. Sức chứa đặt trước bằng reserve(); sau đó không cấp phát nữa.
+
+enum ArchetypeId {
+    ARCH_OBSTACLE,
+    ARCH_COIN,
+    ARCH_POWERUP,
+    ARCH_COUNT
+};
+
+enum ComponentBit {
+    COMP_POSITION  = 1 << 0,   // worldX (double), y (đáy, toạ độ màn hình)
+    COMP_VELOCITY  = 1 << 1,   // vx (trong thế giới), vy (px/frame)
+    COMP_BOUNDS    = 1 << 2,   // width, height
+    COMP_TAG       = 1 << 3,   // kind (loại trong archetype), variant
+    COMP_ANIMATION = 1 << 4,   // birth (tick AnimationClock lúc sinh)
+    COMP_FLAGS     = 1 << 5    // ENTITY_*
+};
+
+enum EntityFlag {
+    ENTITY_ALIVE       = 1 << 0,
+    ENTITY_COLLECTIBLE = 1 << 1,   // Người chơi nhặt được (xu, power-up)
+    ENTITY_COLLECTED   = 1 << 2,
+    ENTITY_FALLING     = 1 << 3,   // Rơi nhanh dần, chết khi chạm đất (thiên thạch)
+    ENTITY_BOBBING     = 1 << 4    // Nhấp nhô theo tuổi (chim); y là độ cao gốc
+};
+
+// Chỉ số entity riêng cho từng archetype (0..capacity-1), dùng để gắn dữ liệu
+// ngoài chunk (như mask hình dạng vật cản) vào thực thể
+struct EntityId {
+    int arch;
+    int index;
+    Uint32 generation;
+
+    EntityId() : arch(-1), index(-1), generation(0) {}
+    bool valid() const { return index >= 0; }
+};
+
+// 64 hàng của một archetype; component không có trong archetype là nullptr
+struct ArchetypeChunk {
+    static constexpr int ROWS = 64;
+
+    double* worldX;
+    float* y;
+    float* vx;
+    float* vy;
+    Sint16* width;
+    Sint16* height;
+    Uint8* kind;
+    Uint8* variant;
+    Uint32* birth;
+    Uint8* flags;
+    int* entity;     // Hàng -> chỉ số entity
+    void* block;     // Một khối cấp phát căn 64 byte chứa mọi mảng
+};
+
+// Một hàng đã chiếu ra màn hình, đủ để vẽ
+struct RenderItem {
+    int entity;
+    int x, y;             // x màn hình, y đáy (đã cộng nhấp nhô)
+    int width, height;
+    Uint8 kind, variant;
+    float age;            // Frame kể từ lúc sinh, cho hiệu ứng
+};
+
+class EntityRegistry;
+
+class Archetype {
+public:
+    Archetype();
+    ~Archetype();
+
+    Uint32 getComponents() const { return components; }
+    bool has(Uint32 component) const { return (components & component) != 0; }
+    int size() const { return rows; }
+    int capacity() const { return (int)chunks.size() * ArchetypeChunk::ROWS; }
+    int chunkCount() const { return (int)chunks.size(); }
+    // Byte đã cấp cho chunk và các bảng entity; chỉ reserve làm nó đổi
+    size_t reservedBytes() const;
+    // Số hàng đang dùng trong chunk c (các chunk trước luôn đầy)
+    int chunkSize(int c) const { return std::min(ArchetypeChunk::ROWS, rows - c * ArchetypeChunk::ROWS); }
+    ArchetypeChunk& chunk(int c) { return chunks[c]; }
+
+    // Truy cập theo hàng toàn cục (chậm hơn duyệt chunk, dùng cho truy vấn lẻ)
+    double& worldX(int row) { return chunks[row >> 6].worldX[row & 63]; }
+    float& y(int row) { return chunks[row >> 6].y[row & 63]; }
+    float& vx(int row) { return chunks[row >> 6].vx[row & 63]; }
+    float& vy(int row) { return chunks[row >> 6].vy[row & 63]; }
+    Sint16& width(int row) { return chunks[row >> 6].width[row & 63]; }
+    Sint16& height(int row) { return chunks[row >> 6].height[row & 63]; }
+    Uint8& kind(int row) { return chunks[row >> 6].kind[row & 63]; }
+    Uint8& variant(int row) { return chunks[row >> 6].variant[row & 63]; }
+    Uint32& birth(int row) { return chunks[row >> 6].birth[row & 63]; }
+    Uint8& flags(int row) { return chunks[row >> 6].flags[row & 63]; }
+    int entity(int row) const { return chunks[row >> 6].entity[row & 63]; }
+
+private:
+    friend class EntityRegistry;
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    void init(Uint32 componentMask);
+    void addChunk();
+    // Dời/đổi dữ liệu hàng và cập nhật entityRow theo
+    void copyRow(int from, int to);
+    void swapRows(int first, int second);
+    void releaseRow(int row);
+
+    Uint32 components;
+    std::vector<ArchetypeChunk> chunks;
+    size_t blockBytes;     // Cỡ một khối chunk
+    int rows;
+    std::vector<int> entityRow;          // Entity -> hàng, -1 nếu không dùng
+    std::vector<Uint32> generations;
+    std::vector<int> freeIds;
+    int maxWidth;          // Rộng nhất từng gặp: cửa sổ tìm phải lùi thêm chừng này
+    double cosmeticLine;   // Vật có mép phải trước đây đã qua người chơi
+    int highWater;
+    Uint64 spawned, evicted, dropped;
+    Uint64 queries, candidates;
+};
+
+class EntityRegistry {
+public:
+    // clock: đồng hồ hoạt ảnh ghi vào birth khi tạo thực thể
+    explicit EntityRegistry(const AnimationClock* clock);
+
+    // Chỉ tăng sức chứa; đây là chỗ duy nhất cấp phát
+    void reserve(ArchetypeId arch, int capacity);
+    // Bỏ mọi thực thể của archetype, giữ sức chứa
+    void clear(ArchetypeId arch);
+
+    // Thêm thực thể ở worldX, trả về hàng để ghi component (birth = bây giờ,
+    // các component khác được đặt về 0, flags = ENTITY_ALIVE). Đầy thì bỏ vật đầu dãy nếu
+    // nó đã qua người chơi, không thì trả -1 (bỏ vật mới).
+    int create(ArchetypeId arch, double worldX);
+    // Gọi sau khi ghi xong width (cửa sổ tìm cần biết vật rộng nhất)
+    void noteWidth(ArchetypeId arch, int width);
+
+    EntityId idOf(ArchetypeId arch, int row) const;
+    // Hàng hiện tại của thực thể, -1 nếu đã bị bỏ
+    int rowOf(const EntityId& id) const;
+
+    Archetype& archetype(ArchetypeId arch) { return archetypes[arch]; }
+    const AnimationClock& getClock() const { return *clock; }
+    void setCosmeticLine(ArchetypeId arch, double worldX) { archetypes[arch].cosmeticLine = worldX; }
+
+    // Bỏ các hàng không còn ENTITY_ALIVE, giữ thứ tự
+    void removeDead(ArchetypeId arch);
+    // Bỏ các hàng đầu dãy đã trôi qua mép trái
+    void cullBehind(ArchetypeId arch, const WorldScroll& world);
+    // Xếp lại sau khi có hàng đổi worldX
+    void resort(ArchetypeId arch);
+    // Trừ shift khỏi mọi worldX (đi cùng WorldScroll::rebase); thứ tự không đổi
+    void rebase(double shift);
+
+    // Gọi fn(row) cho mọi hàng có [worldX, worldX + width] chạm [minX, maxX]
+    template <typename Fn>
+    void forEachInWindow(ArchetypeId arch, double minX, double maxX, Fn fn) {
+        Archetype& a = archetypes[arch];
+        a.queries++;
+        int row = lowerBound(a, minX - a.maxWidth);
+        for (; row < a.rows && a.worldX(row) <= maxX; row++) {
+            if (a.worldX(row) + a.width(row) < minX) continue;
+            a.candidates++;
+            fn(row);
+        }
+    }
+
+    void logStats(ArchetypeId arch, const char* name) const;
+
+private:
+    EntityRegistry(const EntityRegistry&) = delete;
+    EntityRegistry& operator=(const EntityRegistry&) = delete;
+
+    int lowerBound(Archetype& a, double worldX);
+
+    const AnimationClock* clock;
+    Archetype archetypes[ARCH_COUNT];
+};
+
+// ===================== SYSTEMS =====================
+
+// Hàng ENTITY_FALLING (thiên thạch): gia tốc rơi và vận tốc tối đa (px/frame)
+static const float FALL_ACCELERATION = 0.1f;
+static const float FALL_MAX_SPEED = 12.0f;
+
+// Vận tốc, rơi nhanh dần (chết khi quá deathY).
+// Trả true nếu có hàng đổi worldX (cần xếp lại).
+bool runMotionSystem(EntityRegistry& registry, ArchetypeId arch, float deathY);
+// Độ lệch nhấp nhô của hàng ENTITY_BOBBING ở tuổi age (cộng vào y gốc)
+float bobOffset(Uint32 age);
+// Bỏ hàng đã chết và hàng đã trôi qua mép trái; xếp lại nếu có vật tự di chuyển
+void runScrollSystem(EntityRegistry& registry, ArchetypeId arch, const WorldScroll& world, bool resort);
+
+// Gom hàng (có đủ requireFlags) trong cửa sổ [minX, maxX] thành lô cho kernel
+// va chạm; rows nhận chỉ số hàng theo cùng thứ tự với lô.
+void gatherRects(EntityRegistry& registry, ArchetypeId arch, const WorldScroll& world,
+                 double minX, double maxX, Uint8 requireFlags, RectBatch& batch, std::vector<int>& rows);
+// Tâm (giữa hàng) và bán kính width / 2 của từng hàng
+void gatherCircles(EntityRegistry& registry, ArchetypeId arch, const WorldScroll& world,
+                   double minX, double maxX, Uint8 requireFlags, CircleBatch& batch, std::vector<int>& rows);
+
+// Các hàng còn sống có phần nằm trong [0, screenWidth) theo thứ tự worldX
+void buildRenderList(EntityRegistry& registry, ArchetypeId arch, const WorldScroll& world,
+                     int screenWidth, std::vector<RenderItem>& out);
+
+// Sinh/bỏ/cuộn ngẫu nhiên frames frame trên registry đã reserve, so với bản
+// tham chiếu (thứ tự worldX, hàng của từng handle, handle cũ phải hỏng) và
+// kiểm tra bộ nhớ không cấp thêm sau reserve. In kết quả, trả về false nếu lệch.
+bool runEntitySelfTest(int frames);
+
+#endif // ECS_H_INCLUDED
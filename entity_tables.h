@@ -0,0 +1,102 @@
+#ifndef ENTITY_TABLES_H_INCLUDED
+#define ENTITY_TABLES_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <cstddef>
+#include "ecs.h"
+#include "alias_table.h"
+#include "obstacle.h"
+#include "score.h"
+
+// Tham số từng loại vật cản/xu dạng bảng constexpr, theo thứ tự enum: thêm
+// loại mới là thêm một dòng. Trọng số sinh được kiểm tra lúc biên dịch, lúc
+// chạy chọn loại bằng bảng alias nên mỗi lần sinh là O(1).
+
+// min + rng.below(range) (range 0: luôn là min)
+struct IntRange {
+    int min, range;
+    template <typename Rng>
+    int roll(Rng& rng) const { return range > 0 ? min + rng.below(range) : min; }
+};
+
+struct ObstacleParams {
+    int weight;          // Trọng số sinh theo timer/nhạc; 0 = chỉ sinh riêng (thiên thạch)
+    IntRange width, height;
+    int lanes[4];        // Độ cao đáy trên mặt đất, chọn ngẫu nhiên một làn
+    int laneCount;       // 0: sinh trên trời ở skyY và rơi với fallSpeed
+    IntRange skyY, fallSpeed;
+    Uint8 flags;         // ENTITY_* thêm vào ENTITY_ALIVE
+};
+
+constexpr ObstacleParams OBSTACLE_TYPES[] = {
+    // weight  width     height    lanes               n  skyY        fallSpeed  flags
+    { 40, { 15, 10 }, { 40, 20 }, { 0 },              1, { 0, 0 },    { 0, 0 },  0 },               // CACTUS_SMALL
+    { 25, { 20, 15 }, { 60, 25 }, { 0 },              1, { 0, 0 },    { 0, 0 },  0 },               // CACTUS_MEDIUM
+    { 15, { 25, 20 }, { 80, 30 }, { 0 },              1, { 0, 0 },    { 0, 0 },  0 },               // CACTUS_LARGE
+    { 10, { 50, 30 }, { 60, 40 }, { 0 },              1, { 0, 0 },    { 0, 0 },  0 },               // CACTUS_GROUP
+    {  5, { 35, 20 }, { 25, 15 }, { 60, 100, 140, 180 }, 4, { 0, 0 }, { 0, 0 },  ENTITY_BOBBING },  // BIRD
+    {  0, { 30, 25 }, { 30, 25 }, { 0 },              0, { -149, 100 }, { 3, 4 }, ENTITY_FALLING }, // METEOR
+    {  5, { 25, 20 }, { 20, 15 }, { 0 },              1, { 0, 0 },    { 0, 0 },  0 },               // ROCK
+};
+
+struct CoinParams {
+    int weight;
+    int size;            // Đường kính
+    int value, xpValue;
+    int lanes[3];
+    int laneCount;
+    SDL_Color glow, base, highlight, shadow;
+};
+
+constexpr CoinParams COIN_TYPES[] = {
+    // weight size value xp  lanes              n
+    { 45, 20, 10,  0, { 70, 100, 120 }, 3,      // NORMAL_COIN
+      { 255, 220, 100, 255 }, { 255, 200, 0, 255 }, { 255, 255, 100, 255 }, { 205, 150, 0, 255 } },
+    { 25, 22,  5,  0, { 60 },           1,      // SILVER_COIN
+      { 200, 200, 255, 255 }, { 192, 192, 192, 255 }, { 240, 240, 240, 255 }, { 150, 150, 150, 255 } },
+    { 15, 28, 20,  0, { 130 },          1,      // GOLD_COIN
+      { 255, 255, 100, 255 }, { 255, 215, 0, 255 }, { 255, 255, 150, 255 }, { 205, 175, 0, 255 } },
+    { 15, 24,  0, 25, { 90 },           1,      // XP_COIN: violet / orchid / indigo
+      { 200, 100, 255, 255 }, { 138, 43, 226, 255 }, { 186, 85, 211, 255 }, { 75, 0, 130, 255 } },
+};
+
+static_assert(sizeof(OBSTACLE_TYPES) / sizeof(OBSTACLE_TYPES[0]) == OBSTACLE_TYPE_COUNT,
+              "OBSTACLE_TYPES needs one row per ObstacleType");
+static_assert(sizeof(COIN_TYPES) / sizeof(COIN_TYPES[0]) == COIN_TYPE_COUNT,
+              "COIN_TYPES needs one row per CoinType");
+
+template <typename Weights, typename Params, size_t N>
+constexpr Weights weightsOf(const Params (&table)[N]) {
+    Weights w = {};
+    for (size_t i = 0; i < N; i++) w.weights[i] = table[i].weight;
+    return w;
+}
+
+constexpr ObstacleWeights DEFAULT_OBSTACLE_WEIGHTS = weightsOf<ObstacleWeights>(OBSTACLE_TYPES);
+constexpr CoinWeights DEFAULT_COIN_WEIGHTS = weightsOf<CoinWeights>(COIN_TYPES);
+static_assert(weightsValid(DEFAULT_OBSTACLE_WEIGHTS.weights), "invalid obstacle spawn weights");
+static_assert(weightsValid(DEFAULT_COIN_WEIGHTS.weights), "invalid coin spawn weights");
+
+// Chọn kích thước, làn và biến thể cho một vật cản (thiên thạch: lift bỏ qua)
+template <typename Rng>
+ObstacleSpec rollObstacleSpec(ObstacleType type, Rng& rng) {
+    const ObstacleParams& p = OBSTACLE_TYPES[type];
+    ObstacleSpec spec;
+    spec.type = type;
+    spec.width = p.width.roll(rng);
+    spec.height = p.height.roll(rng);
+    spec.lift = p.laneCount > 0 ? p.lanes[rng.below(p.laneCount)] : 0;
+    spec.variant = rng.below(3);   // 3 biến thể cho mỗi loại
+    spec.skyY = p.laneCount > 0 ? 0 : p.skyY.roll(rng);
+    spec.fallSpeed = p.laneCount > 0 ? 0 : p.fallSpeed.roll(rng);
+    return spec;
+}
+
+template <typename Rng>
+int rollCoinLift(CoinType type, Rng& rng) {
+    const CoinParams& p = COIN_TYPES[type];
+    return p.laneCount > 1 ? p.lanes[rng.below(p.laneCount)] : p.lanes[0];
+}
+
+#endif // ENTITY_TABLES_H_INCLUDED
@@ -0,0 +1,66 @@
+#include "event_bus.h"
+#include <iostream>
+
+static const char* EVENT_NAMES[EVENT_TYPE_COUNT] = {
+    "coin", "powerup", "jump", "dash", "hit", "level", "meteor", "combo"
+};
+
+// ===================== EVENT BUS IMPLEMENTATION =====================
+
+EventBus::EventBus()
+    : count(0), listenerCount(0), delivered(0), dispatchCounter(0), dropped(0), peakBatch(0) {
+    for (int i = 0; i < EVENT_TYPE_COUNT; i++) published[i] = 0;
+}
+
+bool EventBus::subscribe(GameEventListener* listener, Uint32 typeMask) {
+    if (listenerCount >= MAX_LISTENERS) {
+        std::cerr << "EventBus: too many listeners" << std::endl;
+        return false;
+    }
+    listeners[listenerCount].listener = listener;
+    listeners[listenerCount].mask = typeMask;
+    listenerCount++;
+    return true;
+}
+
+bool EventBus::publish(const GameEvent& event) {
+    if (count >= CAPACITY) {
+        dropped++;
+        return false;
+    }
+    queue[count++] = event;
+    published[event.type]++;
+    return true;
+}
+
+void EventBus::dispatch() {
+    if (count == 0) return;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    // Listener có thể publish thêm trong lúc dispatch; giao luôn trong lượt này
+    for (int i = 0; i < count; i++) {
+        const GameEvent event = queue[i];
+        Uint32 bit = eventMask(event.type);
+        for (int l = 0; l < listenerCount; l++) {
+            if (listeners[l].mask & bit) {
+                listeners[l].listener->onGameEvent(event);
+                delivered++;
+            }
+        }
+    }
+    if (count > peakBatch) peakBatch = count;
+    count = 0;
+    dispatchCounter += SDL_GetPerformanceCounter() - start;
+}
+
+void EventBus::logStats() const {
+    Uint64 total = 0;
+    std::cout << "Events:";
+    for (int i = 0; i < EVENT_TYPE_COUNT; i++) {
+        std::cout << " " << EVENT_NAMES[i] << "=" << published[i];
+        total += published[i];
+    }
+    double ms = (double)dispatchCounter * 1000.0 / SDL_GetPerformanceFrequency();
+    std::cout << " | " << total << " published, " << delivered << " deliveries, peak "
+              << peakBatch << "/frame, " << dropped << " dropped, " << ms << " ms dispatching" << std::endl;
+}
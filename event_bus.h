@@ -0,0 +1,97 @@
+#ifndef EVENT_BUS_H_INCLUDED
+#define EVENT_BUS_H_INCLUDED
+
+#include <SDL2/SDL.h>
+
+enum GameEventType {
+    EVENT_COIN_COLLECTED,
+    EVENT_POWERUP_COLLECTED,
+    EVENT_JUMP,
+    EVENT_DASH,
+    EVENT_HIT,
+    EVENT_LEVEL_COMPLETE,
+    EVENT_METEOR_SPAWNED,
+    EVENT_COMBO,            // ComboSystem publish sau mỗi xu, kèm combo mới
+    EVENT_TYPE_COUNT
+};
+
+// Sự kiện gameplay, cỡ cố định để nằm gọn trong hàng đợi.
+// Tạo bằng các hàm static bên dưới để dữ liệu luôn khớp với type.
+struct GameEvent {
+    GameEventType type;
+    union {
+        struct { int coinType; int value; } coin;   // CoinType
+        struct { int powerUpType; bool shield; } powerUp;  // PowerUpType
+        struct { int level; int score; } level;
+        struct { int x; } meteor;
+        struct { int count; } combo;
+    };
+
+    static GameEvent coinCollected(int coinType, int value) {
+        GameEvent e; e.type = EVENT_COIN_COLLECTED; e.coin.coinType = coinType; e.coin.value = value; return e;
+    }
+    static GameEvent powerUpCollected(int powerUpType, bool shield) {
+        GameEvent e; e.type = EVENT_POWERUP_COLLECTED; e.powerUp.powerUpType = powerUpType; e.powerUp.shield = shield; return e;
+    }
+    static GameEvent jump() { GameEvent e; e.type = EVENT_JUMP; return e; }
+    static GameEvent dash() { GameEvent e; e.type = EVENT_DASH; return e; }
+    static GameEvent hit() { GameEvent e; e.type = EVENT_HIT; return e; }
+    static GameEvent levelComplete(int level, int score) {
+        GameEvent e; e.type = EVENT_LEVEL_COMPLETE; e.level.level = level; e.level.score = score; return e;
+    }
+    static GameEvent meteorSpawned(int x) {
+        GameEvent e; e.type = EVENT_METEOR_SPAWNED; e.meteor.x = x; return e;
+    }
+    static GameEvent comboIncreased(int count) {
+        GameEvent e; e.type = EVENT_COMBO; e.combo.count = count; return e;
+    }
+};
+
+class GameEventListener {
+public:
+    virtual ~GameEventListener() {}
+    virtual void onGameEvent(const GameEvent& event) = 0;
+};
+
+inline Uint32 eventMask(GameEventType type) { return 1u << type; }
+
+// Hàng đợi sự kiện trong một frame: code va chạm/spawn publish đúng một lần,
+// dispatch() giao cho các listener đã đăng ký theo thứ tự đăng ký rồi xoá
+// hàng đợi. Mảng cố định, không cấp phát. Đếm số sự kiện và thời gian
+// dispatch để đo throughput ở một chỗ.
+class EventBus {
+public:
+    static const int CAPACITY = 256;
+    static const int MAX_LISTENERS = 16;
+
+    EventBus();
+
+    bool subscribe(GameEventListener* listener, Uint32 typeMask);
+    bool publish(const GameEvent& event);   // false khi đầy (sự kiện bị bỏ)
+    void dispatch();
+
+    Uint64 getPublishedCount(GameEventType type) const { return published[type]; }
+    Uint64 getDeliveredCount() const { return delivered; }
+    int getDroppedCount() const { return dropped; }
+    int getPeakBatch() const { return peakBatch; }
+    void logStats() const;
+
+private:
+    struct Subscription {
+        GameEventListener* listener;
+        Uint32 mask;
+    };
+
+    GameEvent queue[CAPACITY];
+    int count;
+    Subscription listeners[MAX_LISTENERS];
+    int listenerCount;
+
+    Uint64 published[EVENT_TYPE_COUNT];
+    Uint64 delivered;
+    Uint64 dispatchCounter;   // Tổng thời gian dispatch (performance counter)
+    int dropped;
+    int peakBatch;
+};
+
+#endif // EVENT_BUS_H_INCLUDED
@@ -1,22 +1,51 @@
 #include "game.h"
+#include "entity_tables.h"
 #include <iostream>
 #include <fstream>
+#include <ctime>
+#include <cmath>
+
+// Số job hoàn tất (upload texture, mở font...) xử lý mỗi frame để không giật hình
+static const int ASSET_UPLOADS_PER_FRAME = 2;
+
+// Tổng dung lượng texture skin được giữ cùng lúc (thumbnail + bản đầy đủ)
+static const size_t SKIN_TEXTURE_BUDGET = 1024 * 1024;
+
+// Phân tích nhịp nhạc chạy nền; quá thời gian này thì bỏ và spawn ngẫu nhiên như cũ
+static const char* DEFAULT_MUSIC = "image/music.mp3";
+static const char* BEAT_MAP_CACHE = "beatmap.dat";
+static const Uint32 BEAT_ANALYSIS_BUDGET_MS = 4000;
+
+// Màn chọn level phân trang: pack có thể có hàng trăm level
+static const int LEVELS_PER_PAGE = 6;
 
 // ===================== Game Class Implementation =====================
 
-Game::Game(int width, int height)
+Game::Game(int width, int height, bool headlessMode)
     : SCREEN_WIDTH(width), SCREEN_HEIGHT(height), GROUND_Y(380),
       window(nullptr), renderer(nullptr),
       fontBig(nullptr), fontMedium(nullptr), fontSmall(nullptr), fontTiny(nullptr),
-      backgroundMusic(nullptr), uiRenderer(nullptr),
-      obstacleManager(GROUND_Y, 6, SCREEN_WIDTH),
-      scoreManager(GROUND_Y, 6, SCREEN_WIDTH),
-      powerUpManager(GROUND_Y, 6, SCREEN_WIDTH),
+      backgroundMusic(nullptr),
+      initStartCounter(0), firstFramePresented(false),
+      entities(&animClock),
+      uiRenderer(nullptr),
+      obstacleManager(&entities, GROUND_Y, &world, SCREEN_WIDTH),
+      scoreManager(&entities, GROUND_Y, &world, SCREEN_WIDTH),
+      powerUpManager(&entities, GROUND_Y, &world, SCREEN_WIDTH),
+      achievementSystem(!headlessMode),
       mapTheme(GRASSLAND),
       dayNightCycle(0.0008f),
-      state(GameState::MENU),
+      musicNight(false),
+      state(GameState::LOADING),
       running(true),
-      gameOver(false), musicPlaying(false) {
+      gameOver(false),
+      endlessMode(false),
+      nextLevelEvent(0), nextScriptedHazard(0),
+      levelPage(0),
+      headless(headlessMode),
+      invulnerable(false),
+      ignoredHits(0),
+      statsLog(false) {
 
     player.groundY = GROUND_Y;
     player.y = GROUND_Y;
@@ -28,11 +57,15 @@ Game::~Game() {
 }
 
 bool Game::initialize() {
+    initStartCounter = SDL_GetPerformanceCounter();
+
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
         std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
         return false;
     }
 
+    std::cout << "Collision kernels: " << getCollisionKernelName() << std::endl;
+
     if (TTF_Init() != 0) {
         std::cerr << "TTF_Init Error: " << TTF_GetError() << std::endl;
         SDL_Quit();
@@ -85,24 +118,14 @@ bool Game::initialize() {
         return false;
     }
 
-    fontBig = TTF_OpenFont("NotoSans-Regular.ttf", 48);
-    fontMedium = TTF_OpenFont("NotoSans-Regular.ttf", 32);
-    fontSmall = TTF_OpenFont("NotoSans-Regular.ttf", 24);
-    fontTiny = TTF_OpenFont("NotoSans-Regular.ttf", 18);
-
-    if (!fontBig || !fontSmall || !fontMedium || !fontTiny) {
-        std::cerr << "Failed to load font! Error: " << TTF_GetError() << std::endl;
-        cleanup();
-        return false;
-    }
-
-    backgroundMusic = Mix_LoadMUS("image/music.mp3");
-    if (!backgroundMusic) {
-        std::cerr << "Failed to load music (music.mp3)! Error: " << Mix_GetError() << std::endl;
-    }
-
     uiRenderer = UIRenderer(renderer);
-    shop.initialize(renderer);
+    if (textureAtlas.initialize(renderer)) {
+        Coin::bakeSprites(textureAtlas, coinSprites);
+        PowerUpManager::bakeIcons(textureAtlas, powerUpIcons);
+    }
+    scoreManager.setSprites(&textureAtlas, &coinSprites);
+    powerUpManager.setIcons(&textureAtlas, &powerUpIcons);
+    shop.initialize(renderer, &textureAtlas, &assetLoader, SKIN_TEXTURE_BUDGET);
     loadProgress();
 
     if (dailyResetSystem.shouldResetDaily()) {
@@ -112,26 +135,144 @@ bool Game::initialize() {
         saveProgress();
     }
 
+    // Font, nhạc và skin nạp nền; màn hình LOADING hiện ngay frame đầu.
+    // Có assets.pak thì đọc từ pack, không thì đọc các file rời như cũ.
+    if (assetPack.open("assets.pak")) {
+        assetLoader.setPack(&assetPack);
+    }
+    assetLoader.start();
+    audio.initialize(assetLoader);
+    attachSystems();
+
+    requestAssets();
+    updateMusicTrack();
+
     return true;
 }
 
+// Chỉ các hệ thống gameplay cho soak test: không SDL video/audio, không đọc/ghi
+// save (achievement vẫn mở khoá nhưng không lưu). update() chạy như khi chơi,
+// audio chưa initialize nên mọi âm thanh/nhạc là no-op, không có gì được vẽ
+bool Game::initializeHeadless() {
+    if (!headless) {
+        std::cerr << "Game: initializeHeadless needs a Game constructed with headlessMode" << std::endl;
+        return false;
+    }
+    initStartCounter = SDL_GetPerformanceCounter();
+    attachSystems();
+    state = GameState::MENU;
+    return true;
+}
+
+// Nối các hệ thống qua EventBus và TimerWheel (chung cho initialize và initializeHeadless)
+void Game::attachSystems() {
+    // Thứ tự đăng ký = thứ tự nhận
+    events.subscribe(&comboSystem, eventMask(EVENT_COIN_COLLECTED));
+    events.subscribe(&questSystem, eventMask(EVENT_COIN_COLLECTED) | eventMask(EVENT_POWERUP_COLLECTED) |
+                                   eventMask(EVENT_JUMP) | eventMask(EVENT_HIT) | eventMask(EVENT_LEVEL_COMPLETE));
+    events.subscribe(&audio, eventMask(EVENT_JUMP) | eventMask(EVENT_DASH) | eventMask(EVENT_HIT) |
+                             eventMask(EVENT_METEOR_SPAWNED) | eventMask(EVENT_COMBO) |
+                             eventMask(EVENT_POWERUP_COLLECTED));
+    events.subscribe(this, eventMask(EVENT_POWERUP_COLLECTED));
+
+    sizeEntityPools(levelManager.getCurrentLevelInfo());
+    obstacleManager.attach(&timers, &events);
+    scoreManager.attach(&timers);
+    powerUpManager.attach(&timers);
+    comboSystem.attach(&timers, &events);
+    questSystem.attach(&timers);
+    achievementSystem.attach(&timers);
+}
+
+void Game::requestAssets() {
+    assetLoader.requestBytes("NotoSans-Regular.ttf", [this](AssetBlob& blob) { onFontLoaded(blob); });
+    assetLoader.requestBytes(DEFAULT_MUSIC, [this](AssetBlob& blob) { onMusicLoaded(blob); });
+    shop.requestEquippedSkin(player.equippedSkinIndex);
+}
+
+void Game::onFontLoaded(AssetBlob& blob) {
+    fontData = std::move(blob);
+
+    // Cả 4 cỡ chữ dùng chung một buffer, file chỉ đọc từ đĩa một lần
+    if (!fontData.empty()) {
+        fontBig = TTF_OpenFontRW(fontData.openRW(), 1, 48);
+        fontMedium = TTF_OpenFontRW(fontData.openRW(), 1, 32);
+        fontSmall = TTF_OpenFontRW(fontData.openRW(), 1, 24);
+        fontTiny = TTF_OpenFontRW(fontData.openRW(), 1, 18);
+    }
+
+    if (!fontBig || !fontSmall || !fontMedium || !fontTiny) {
+        std::cerr << "Failed to load font! Error: " << TTF_GetError() << std::endl;
+        running = false;
+        return;
+    }
+
+    state = GameState::MENU;
+    std::cout << "Time to interactive: " << (int)(secondsSinceInit() * 1000.0) << " ms" << std::endl;
+}
+
+// Bản nhạc mặc định: nguồn cho beat map, và là nhạc nền khi không stream được
+void Game::onMusicLoaded(AssetBlob& blob) {
+    if (blob.empty()) return;
+    musicData = std::move(blob);
+
+    if (!audio.isStreamingMusic()) {
+        backgroundMusic = Mix_LoadMUS_RW(musicData.openRW(), 1);
+        if (!backgroundMusic) {
+            std::cerr << "Failed to load music (music.mp3)! Error: " << Mix_GetError() << std::endl;
+            musicData.clear();
+            return;
+        }
+        audio.setMusic(backgroundMusic, DEFAULT_MUSIC);
+    }
+    beatAnalyzer.start(musicData.data, musicData.size, BEAT_MAP_CACHE, BEAT_ANALYSIS_BUDGET_MS);
+}
+
+// Mỗi theme có nhạc riêng (ban đêm đổi bản), thiếu file thì lùi về bản ngày
+// rồi nhạc mặc định. Streamer tự crossfade khi bài khác bài đang phát.
+void Game::updateMusicTrack() {
+    musicNight = dayNightCycle.getCurrentTimeOfDay() == NIGHT;
+    if (!audio.isStreamingMusic()) return;
+
+    std::string path = mapTheme.getMusicPath(musicNight);
+    if (!assetLoader.hasAsset(path)) path = mapTheme.getMusicPath(false);
+    if (!assetLoader.hasAsset(path)) path = DEFAULT_MUSIC;
+    audio.playMusic(path);
+}
+
+void Game::onGameEvent(const GameEvent& event) {
+    if (event.type == EVENT_POWERUP_COLLECTED) player.totalPowerupsCollected++;
+}
+
+double Game::secondsSinceInit() const {
+    return (double)(SDL_GetPerformanceCounter() - initStartCounter) / SDL_GetPerformanceFrequency();
+}
+
 void Game::run() {
+    bool allAssetsReported = false;
+
     while (running) {
         uiRenderer.update();
         handleEvents();
-        if (state == GameState::PLAYING && !gameOver && !musicPlaying) {
-            if (backgroundMusic) {
-                Mix_PlayMusic(backgroundMusic, -1); // -1 để lặp vô tận
+
+        assetLoader.pumpCompleted(ASSET_UPLOADS_PER_FRAME);
+        if (!allAssetsReported && assetLoader.isIdle()) {
+            std::cout << "All assets loaded: " << (int)(secondsSinceInit() * 1000.0) << " ms" << std::endl;
+            shop.skins.logUsage("startup");
+            if (textureAtlas.isReady()) {
+                std::cout << "Texture atlas: " << textureAtlas.getLiveCount() << " sprites in "
+                          << textureAtlas.getPageCount() << " page(s), "
+                          << (int)(textureAtlas.getOccupancy() * 100) << "% used" << std::endl;
             }
-            musicPlaying = true;
-        }
-        else if ((state != GameState::PLAYING || gameOver) && musicPlaying) {
-            Mix_HaltMusic(); // Dừng nhạc
-            musicPlaying = false;
+            allAssetsReported = true;
         }
 
         update();
         render();
+        if (!firstFramePresented) {
+            std::cout << "Time to first frame: " << (int)(secondsSinceInit() * 1000.0) << " ms" << std::endl;
+            firstFramePresented = true;
+        }
         SDL_Delay(16);
     }
 }
@@ -143,8 +284,19 @@ void Game::handleEvents() {
             running = false;
             return;
         }
+        // Driver làm mất nội dung texture TARGET (vd Direct3D đổi chế độ màn hình):
+        // vẽ lại các trang atlas, texture chữ thì tạo mới mỗi frame sẵn rồi
+        if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+            if (textureAtlas.isReady()) textureAtlas.restore();
+            continue;
+        }
+        if (e.type == SDL_MOUSEBUTTONDOWN && state != GameState::PLAYING) {
+            audio.play(SFX_UI_CLICK);
+        }
 
         switch (state) {
+            case GameState::LOADING:
+                break;
             case GameState::MENU:
                 handleMenuInput(e);
                 break;
@@ -189,8 +341,10 @@ void Game::handleMenuInput(SDL_Event& e) {
 
         if (mx >= playBtn.x && mx <= playBtn.x + playBtn.w && my >= playBtn.y && my <= playBtn.y + playBtn.h)
             state = GameState::LEVEL_SELECT;
-        else if (mx >= shopBtn.x && mx <= shopBtn.x + shopBtn.w && my >= shopBtn.y && my <= shopBtn.y + shopBtn.h)
+        else if (mx >= shopBtn.x && mx <= shopBtn.x + shopBtn.w && my >= shopBtn.y && my <= shopBtn.y + shopBtn.h) {
             state = GameState::SHOP;
+            shop.onOpen();
+        }
         else if (mx >= questBtn.x && mx <= questBtn.x + questBtn.w && my >= questBtn.y && my <= questBtn.y + questBtn.h)
             state = GameState::QUEST;
         else if (mx >= achievementBtn.x && mx <= achievementBtn.x + achievementBtn.w && my >= achievementBtn.y && my <= achievementBtn.y + achievementBtn.h)
@@ -202,28 +356,64 @@ void Game::handleMenuInput(SDL_Event& e) {
     }
 }
 
+// Ô thứ slot trong trang level (3 cột x 2 hàng)
+SDL_Rect Game::levelButtonRect(int slot) const {
+    SDL_Rect rect = { 50 + (slot % 3) * 250, 110 + (slot / 3) * 110, 200, 90 };
+    return rect;
+}
+
+int Game::levelPageCount() const {
+    return ((int)levelManager.levels.size() + LEVELS_PER_PAGE - 1) / LEVELS_PER_PAGE;
+}
+
 void Game::handleLevelSelectInput(SDL_Event& e) {
+    // Lật trang: nút, phím trái/phải hoặc con lăn chuột
+    int pageStep = 0;
+    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_LEFT) pageStep = -1;
+    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_RIGHT) pageStep = 1;
+    if (e.type == SDL_MOUSEWHEEL) pageStep = e.wheel.y > 0 ? -1 : (e.wheel.y < 0 ? 1 : 0);
+
     if (e.type == SDL_MOUSEBUTTONDOWN) {
         int mx = e.button.x, my = e.button.y;
 
-        for (size_t i = 0; i < levelManager.levels.size(); i++) {
-            int btnX = 50 + (i % 3) * 250;
-            int btnY = 120 + (i / 3) * 100;
-            SDL_Rect levelBtn = { btnX, btnY, 200, 80 };
+        // Chỉ các level của trang đang xem
+        int first = levelPage * LEVELS_PER_PAGE;
+        for (int slot = 0; slot < LEVELS_PER_PAGE && first + slot < (int)levelManager.levels.size(); slot++) {
+            SDL_Rect levelBtn = levelButtonRect(slot);
 
             if (mx >= levelBtn.x && mx <= levelBtn.x + levelBtn.w &&
                 my >= levelBtn.y && my <= levelBtn.y + levelBtn.h &&
-                levelManager.levels[i].unlocked) {
-                startLevel(i);
-                break;
+                levelManager.levels[first + slot].unlocked) {
+                endlessMode = false;
+                startLevel(first + slot);
+                return;
             }
         }
 
+        SDL_Rect prevBtn = { 50, 335, 120, 45 };
+        SDL_Rect nextBtn = { SCREEN_WIDTH - 170, 335, 120, 45 };
+        if (mx >= prevBtn.x && mx <= prevBtn.x + prevBtn.w && my >= prevBtn.y && my <= prevBtn.y + prevBtn.h)
+            pageStep = -1;
+        else if (mx >= nextBtn.x && mx <= nextBtn.x + nextBtn.w && my >= nextBtn.y && my <= nextBtn.y + nextBtn.h)
+            pageStep = 1;
+
+        SDL_Rect endlessBtn = { SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT - 140, 300, 50 };
+        if (mx >= endlessBtn.x && mx <= endlessBtn.x + endlessBtn.w &&
+            my >= endlessBtn.y && my <= endlessBtn.y + endlessBtn.h) {
+            startEndless();
+            return;
+        }
+
         SDL_Rect backBtnLS = { SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT - 70, 200, 50 };
         if (mx >= backBtnLS.x && mx <= backBtnLS.x + backBtnLS.w &&
             my >= backBtnLS.y && my <= backBtnLS.y + backBtnLS.h)
             state = GameState::MENU;
     }
+
+    if (pageStep != 0) {
+        int page = levelPage + pageStep;
+        if (page >= 0 && page < levelPageCount()) levelPage = page;
+    }
 }
 
 void Game::handlePlayingInput(SDL_Event& e) {
@@ -231,14 +421,15 @@ void Game::handlePlayingInput(SDL_Event& e) {
 
     if (e.type == SDL_KEYDOWN) {
         if ((e.key.keysym.sym == SDLK_SPACE || e.key.keysym.sym == SDLK_UP) && player.isOnGround) {
-            player.vy = -12.0f;
+            player.vy = Player::JUMP_VELOCITY;
             player.isOnGround = false;
-            questSystem.onJump();
+            events.publish(GameEvent::jump());
         } else if (e.key.keysym.sym == SDLK_d && powerUpManager.canDash()) {
             player.x += 100;
             powerUpManager.useDash(player);
+            events.publish(GameEvent::dash());
         } else if (e.key.keysym.sym == SDLK_ESCAPE) {
-            levelManager.updateBestScore(scoreManager.getCurrentScore());
+            if (!endlessMode) levelManager.updateBestScore(scoreManager.getCurrentScore());
             saveProgress();
             state = GameState::LEVEL_SELECT;
         }
@@ -272,12 +463,10 @@ void Game::handleLevelCompleteInput(SDL_Event& e) {
 void Game::handleShopInput(SDL_Event& e) {
     auto saveCallback = [this]() { saveProgress(); };
 
-    if (shop.handleInput(e, player, player.equippedSkinIndex, saveCallback)) {
-        state = GameState::MENU;
-    }
-
-    if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE) {
+    if (shop.handleInput(e, player, player.equippedSkinIndex, saveCallback) ||
+        (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE)) {
         state = GameState::MENU;
+        shop.onClose();
     }
 }
 
@@ -312,11 +501,19 @@ void Game::handleLeaderboardInput(SDL_Event& e) {
     }
 }
 
+// Toàn bộ mô phỏng một frame, không vẽ gì: soak test gọi thẳng hàm này
 void Game::update() {
+    BeatMap beatMap;
+    if (beatAnalyzer.takeResult(beatMap)) beatScheduler.setBeatMap(beatMap);
+
+    // Nhạc tạm dừng ngoài màn chơi và tiếp tục từ chỗ cũ khi quay lại
+    audio.setMusicActive(state == GameState::PLAYING && !gameOver);
+
     if (state == GameState::PLAYING && !gameOver) {
         // Update day/night cycle
         dayNightCycle.update();
         mapTheme.update(SCREEN_WIDTH, SCREEN_HEIGHT, dayNightCycle);
+        if ((dayNightCycle.getCurrentTimeOfDay() == NIGHT) != musicNight) updateMusicTrack();
 
         if (!player.isOnGround) player.vy += player.gravity;
         player.y += 2*player.vy;
@@ -327,59 +524,84 @@ void Game::update() {
         }
 
         difficultyManager.update();
-        obstacleManager.setSpeed(difficultyManager.getSpeed());
-        obstacleManager.update();
-        scoreManager.setSpeed(difficultyManager.getSpeed());
-        scoreManager.update(player);
-
-        questSystem.onScoreUpdate(scoreManager.getCurrentScore());
-        for (auto& coin : scoreManager.coins) {
-            if (!coin.collected && coin.checkCollision(player.x, player.y, player.width, player.height)) {
-                comboSystem.addCombo();
-                questSystem.onCoinCollected();
+        world.setSpeed(difficultyManager.getSpeed());
+        world.advance();
+        if (world.needsRebase()) rebaseWorld();
+        animClock.advance();
+
+        // Có beat map (của nhạc mặc định, đang nghe) thì vật cản và xu sinh theo
+        // phách nhạc thay cho bộ đếm ngẫu nhiên
+        // Không theo nhạc thì lấy từ các đoạn LevelGenerator đã kiểm tra công bằng;
+        // worker không chạy được mới quay về timer ngẫu nhiên
+        bool beatSync = beatScheduler.isActive() && audio.getMusicPath() == DEFAULT_MUSIC;
+        bool generated = !beatSync && levelGenerator.isRunning();
+        obstacleManager.autoSpawn = !beatSync && !generated;
+        scoreManager.autoSpawn = !beatSync && !generated;
+        powerUpManager.autoSpawn = !generated;
+        if (generated) {
+            levelGenerator.feed(world.toWorld(SCREEN_WIDTH), obstacleManager, scoreManager, powerUpManager);
+        } else if (beatSync) {
+            switch (beatScheduler.update(audio.getMusicTime(), (float)(SCREEN_WIDTH - player.x),
+                                         world.getSpeed())) {
+                case BeatScheduler::SPAWN_OBSTACLE: obstacleManager.spawnObstacle(); break;
+                case BeatScheduler::SPAWN_COIN: scoreManager.spawnCoin(); break;
+                default: break;
             }
         }
-        LevelInfo& level = levelManager.getCurrentLevelInfo();
-        powerUpManager.setSpeed(level.obstacleSpeed);
-        powerUpManager.update(player, &scoreManager);
-        for (auto& pu : powerUpManager.powerUps) {
-            if (!pu.collected && pu.checkCollision(player.x, player.y, player.width, player.height)) {
-                questSystem.onPowerupCollected();
-                player.totalPowerupsCollected++;
-            }
+
+        // Sự kiện kịch bản của level (từ level pack) tới hạn theo thời gian sống
+        const std::vector<LevelEvent>& script = levelManager.getEvents();
+        while (nextLevelEvent < script.size() && (int)script[nextLevelEvent].frame <= difficultyManager.survivalTime) {
+            runLevelEvent(script[nextLevelEvent++]);
         }
 
-        comboSystem.update();
+        obstacleManager.update();
+        scoreManager.update(player, &events);
+        powerUpManager.update(player, &scoreManager, &events);
+
+        // Spawn, hết hạn hiệu ứng, combo, thông báo: chỉ timer đến hạn mới tốn công
+        timers.advance();
+        questSystem.onScoreUpdate(scoreManager.getCurrentScore());
+
+        // Xu/power-up vừa nhặt (và jump/dash từ input) tới combo, quest, âm thanh
+        events.dispatch();
+
         questSystem.onComboUpdate(comboSystem.currentCombo);
         if (comboSystem.getMaxCombo() > player.bestComboAchieved) {
             player.bestComboAchieved = comboSystem.getMaxCombo();
         }
         questSystem.onSurvivalTimeUpdate();
         questSystem.updateQuests(player);
-        achievementSystem.update();
 
         achievementSystem.checkAchievements(scoreManager.getCurrentScore(),
                                            player.totalCoins,
                                            comboSystem.getMaxCombo(),
                                            levelManager.currentLevel + 1);
 
-        if (levelManager.isLevelComplete(scoreManager.getCurrentScore())) {
+        if (!endlessMode && levelManager.isLevelComplete(scoreManager.getCurrentScore())) {
             levelManager.updateBestScore(scoreManager.getCurrentScore());
             levelManager.unlockNextLevel();
             player.addXp(50);
             player.totalCoins += achievementSystem.getTotalRewardsEarned();
             achievementSystem.clearSessionRewards();
-            questSystem.onLevelComplete();
             player.totalLevelsCompleted++;
+            events.publish(GameEvent::levelComplete(levelManager.currentLevel, scoreManager.getCurrentScore()));
+            events.dispatch();
             saveProgress();
             state = GameState::LEVEL_COMPLETE;
         }
 
-        if (obstacleManager.checkCollisionWithPlayer(player.x, player.y, player.width, player.height) &&
-            !powerUpManager.shieldActive) {
+        const CollisionMask* playerMask =
+            shop.skins.getCollisionMask(player.equippedSkinIndex, (int)player.width, (int)player.height);
+        bool hit = obstacleManager.checkCollisionWithPlayer(player.x, player.y, player.width, player.height, playerMask) &&
+                   !powerUpManager.shieldActive;
+        if (hit && invulnerable) {
+            ignoredHits++;
+        } else if (hit) {
             gameOver = true;
-            questSystem.onDamageTaken();
-            levelManager.updateBestScore(scoreManager.getCurrentScore());
+            events.publish(GameEvent::hit());
+            events.dispatch();
+            if (!endlessMode) levelManager.updateBestScore(scoreManager.getCurrentScore());
             player.totalCoins += achievementSystem.getTotalRewardsEarned();
             achievementSystem.clearSessionRewards();
             saveProgress();
@@ -392,6 +614,9 @@ void Game::render() {
     SDL_RenderClear(renderer);
 
     switch (state) {
+        case GameState::LOADING:
+            renderLoading();
+            break;
         case GameState::MENU:
             renderMenu();
             break;
@@ -420,6 +645,26 @@ void Game::render() {
     SDL_RenderPresent(renderer);
 }
 
+void Game::renderLoading() {
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        float t = (float)y / SCREEN_HEIGHT;
+        Uint8 r = 30 + (120 - 30) * t;
+        Uint8 g = 144 + (200 - 144) * t;
+        Uint8 b = 255;
+        SDL_SetRenderDrawColor(renderer, r, g, b, 255);
+        SDL_RenderDrawLine(renderer, 0, y, SCREEN_WIDTH, y);
+    }
+
+    // Chưa có font nên chỉ vẽ thanh tiến trình
+    int requested = assetLoader.getRequestedCount();
+    float progress = requested > 0 ? (float)assetLoader.getFinishedCount() / requested : 0.0f;
+
+    SDL_FRect barBg = {SCREEN_WIDTH/2.0f - 200, SCREEN_HEIGHT/2.0f - 15, 400, 30};
+    uiRenderer.drawRoundedRect(barBg, 12, {20, 40, 80, 200});
+    SDL_FRect bar = {barBg.x + 4, barBg.y + 4, (barBg.w - 8) * progress, barBg.h - 8};
+    if (bar.w > 0) uiRenderer.drawRoundedRect(bar, 9, {255, 215, 0, 255});
+}
+
 void Game::renderMenu() {
     SDL_Color white = {255, 255, 255, 255};
 
@@ -492,18 +737,19 @@ void Game::renderLevelSelect() {
     int mx, my;
     SDL_GetMouseState(&mx, &my);
 
-    for (size_t i = 0; i < levelManager.levels.size(); i++) {
+    int first = levelPage * LEVELS_PER_PAGE;
+    for (int slot = 0; slot < LEVELS_PER_PAGE && first + slot < (int)levelManager.levels.size(); slot++) {
+        int i = first + slot;
         LevelInfo& level = levelManager.levels[i];
-        int btnX = 50 + (i % 3) * 250;
-        int btnY = 110 + (i / 3) * 110;
-        SDL_FRect levelBtn = {(float)btnX, (float)btnY, 200, 90};
+        SDL_Rect btnRect = levelButtonRect(slot);
+        SDL_FRect levelBtn = {(float)btnRect.x, (float)btnRect.y, (float)btnRect.w, (float)btnRect.h};
 
         bool hovered = (mx >= levelBtn.x && mx <= levelBtn.x + levelBtn.w &&
                        my >= levelBtn.y && my <= levelBtn.y + levelBtn.h);
 
         SDL_Color bgColor;
         if (level.unlocked) {
-            float hue = 120.0f - (i * 30.0f);
+            float hue = 120.0f - ((i % 5) * 30.0f);
             bgColor = uiRenderer.hsvToRgb(hue, 0.6f, 0.7f);
             bgColor.a = 200;
         } else {
@@ -548,6 +794,30 @@ void Game::renderLevelSelect() {
     bool hovBackLS = (mx >= backBtnLS.x && mx <= backBtnLS.x + backBtnLS.w &&
                       my >= backBtnLS.y && my <= backBtnLS.y + backBtnLS.h);
     uiRenderer.renderEnhancedButton(backBtnLS, hovBackLS, "BACK", fontSmall, {180, 50, 50, 255});
+
+    int pageCount = levelPageCount();
+    if (pageCount > 1) {
+        SDL_FRect prevBtn = {50, 335, 120, 45};
+        SDL_FRect nextBtn = {SCREEN_WIDTH - 170.0f, 335, 120, 45};
+        bool hovPrev = (mx >= prevBtn.x && mx <= prevBtn.x + prevBtn.w && my >= prevBtn.y && my <= prevBtn.y + prevBtn.h);
+        bool hovNext = (mx >= nextBtn.x && mx <= nextBtn.x + nextBtn.w && my >= nextBtn.y && my <= nextBtn.y + nextBtn.h);
+        SDL_Color pageColor = {60, 110, 200, 255};
+        SDL_Color disabled = {110, 110, 110, 255};
+        uiRenderer.renderEnhancedButton(prevBtn, hovPrev && levelPage > 0, "< PREV", fontSmall,
+                                        levelPage > 0 ? pageColor : disabled);
+        uiRenderer.renderEnhancedButton(nextBtn, hovNext && levelPage < pageCount - 1, "NEXT >", fontSmall,
+                                        levelPage < pageCount - 1 ? pageColor : disabled);
+        std::string pageText = "Page " + std::to_string(levelPage + 1) + " / " + std::to_string(pageCount);
+        uiRenderer.renderTextCentered(pageText, SCREEN_WIDTH / 2.0f, 357, fontSmall, white);
+    }
+    if (!levelManager.getPackTitle().empty()) {
+        uiRenderer.renderTextCentered(levelManager.getPackTitle(), SCREEN_WIDTH / 2.0f, 395, fontTiny, white);
+    }
+
+    SDL_FRect endlessBtn = {SCREEN_WIDTH/2.0f - 150, (float)(SCREEN_HEIGHT - 140), 300, 50};
+    bool hovEndless = (mx >= endlessBtn.x && mx <= endlessBtn.x + endlessBtn.w &&
+                       my >= endlessBtn.y && my <= endlessBtn.y + endlessBtn.h);
+    uiRenderer.renderEnhancedButton(endlessBtn, hovEndless, "ENDLESS", fontSmall, {120, 60, 200, 255});
 }
 
 void Game::renderPlaying() {
@@ -566,11 +836,8 @@ void Game::renderPlaying() {
     powerUpManager.render(renderer);
 
     // Render player
-    SDL_Texture* skin = shop.items[player.equippedSkinIndex].texture;
-    if (skin) {
-        SDL_Rect rect = { player.x, player.y - (int)player.height, (int)player.width, (int)player.height };
-        SDL_RenderCopy(renderer, skin, nullptr, &rect);
-    }
+    SDL_Rect playerRect = { player.x, player.y - (int)player.height, (int)player.width, (int)player.height };
+    shop.drawSkin(renderer, player.equippedSkinIndex, SKIN_FULL, playerRect);
 
     // UI overlay with adjusted colors for visibility
     SDL_Color white = {255,255,255,255};
@@ -585,8 +852,13 @@ void Game::renderPlaying() {
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
 
     LevelInfo& level = levelManager.getCurrentLevelInfo();
-    renderLeftText(fontSmall, "Level " + std::to_string(level.levelNumber) + ": " + level.name, white, 10, 10);
-    renderLeftText(fontSmall, "Score: " + std::to_string(scoreManager.getCurrentScore()) + " / " + std::to_string(level.targetScore), white, 10, 40);
+    if (endlessMode) {
+        renderLeftText(fontSmall, "Endless: " + level.name, white, 10, 10);
+        renderLeftText(fontSmall, "Score: " + std::to_string(scoreManager.getCurrentScore()), white, 10, 40);
+    } else {
+        renderLeftText(fontSmall, "Level " + std::to_string(level.levelNumber) + ": " + level.name, white, 10, 10);
+        renderLeftText(fontSmall, "Score: " + std::to_string(scoreManager.getCurrentScore()) + " / " + std::to_string(level.targetScore), white, 10, 40);
+    }
 
     // Display time of day
     std::string timeOfDayStr;
@@ -670,11 +942,10 @@ void Game::renderLeaderboard() {
 }
 
 void Game::saveProgress() {
+    if (headless) return;
     std::ofstream file("game_progress.dat", std::ios::trunc);
     if (file.is_open()) {
-        for (const auto& level : levelManager.levels) {
-            file << level.unlocked << " " << level.bestScore << "\n";
-        }
+        levelManager.writeProgress(file);
         file << player.totalCoins << "\n";
         file << player.equippedSkinIndex << "\n";
         file << player.level << "\n";
@@ -701,9 +972,7 @@ void Game::loadProgress() {
         return;
     }
 
-    for (auto& level : levelManager.levels) {
-        file >> level.unlocked >> level.bestScore;
-    }
+    levelManager.readProgress(file);
     file >> player.totalCoins;
     file >> player.equippedSkinIndex;
     file >> player.level;
@@ -725,6 +994,8 @@ void Game::loadProgress() {
         file >> item.isOwned;
     }
     shop.items[0].isOwned = true;
+    // Content DB có thể ít skin hơn lúc lưu
+    if (player.equippedSkinIndex < 0 || player.equippedSkinIndex >= (int)shop.items.size()) player.equippedSkinIndex = 0;
     file.close();
 
     achievementSystem.loadProgress();
@@ -733,18 +1004,28 @@ void Game::loadProgress() {
 
 void Game::resetGame() {
     LevelInfo& level = levelManager.getCurrentLevelInfo();
-    obstacleManager.clear();
+    world.reset();
     obstacleManager.spawnInterval = level.spawnInterval;
+    obstacleManager.meteorInterval = level.meteorInterval;
+    obstacleManager.clear();
+    obstacleManager.setSpawnWeights(level.obstacleWeights);
     scoreManager.reset();
+    scoreManager.setSpawnWeights(level.coinWeights);
     powerUpManager.reset();
     comboSystem.reset();
+    difficultyManager.setCurve(level.speedCurve);
+    if (endlessMode) difficultyManager.enableEndlessCap();
     difficultyManager.reset();
+    nextLevelEvent = 0;
     questSystem.resetSessionStats();
     dayNightCycle.reset();
+    updateMusicTrack();
+    beatScheduler.reset();
     player.x = 50;
     player.y = GROUND_Y;
     player.vy = 0;
     player.isOnGround = true;
+    startGenerator(level);
     gameOver = false;
     state = GameState::PLAYING;
 }
@@ -752,14 +1033,25 @@ void Game::resetGame() {
 void Game::startLevel(int levelIndex) {
     levelManager.setCurrentLevel(levelIndex);
     LevelInfo& level = levelManager.getCurrentLevelInfo();
+    levelPage = levelManager.currentLevel / LEVELS_PER_PAGE;
 
     // Set map theme cho level
     mapTheme.setTheme(level.themeType);
     dayNightCycle.reset();
+    updateMusicTrack();
 
-    obstacleManager = ObstacleManager(GROUND_Y, level.obstacleSpeed, SCREEN_WIDTH);
-    scoreManager = ScoreManager(GROUND_Y, level.obstacleSpeed, SCREEN_WIDTH);
-    powerUpManager = PowerUpManager(GROUND_Y, level.obstacleSpeed, SCREEN_WIDTH);
+    // Giữ nguyên các manager (và pool của chúng), chỉ nới sức chứa nếu level cần hơn
+    world.reset();
+    sizeEntityPools(level);
+    obstacleManager.reset();
+    // Lần spawn và thiên thạch đầu tiên theo level; clear() hẹn lại timer
+    obstacleManager.spawnInterval = level.spawnInterval;
+    obstacleManager.meteorInterval = level.meteorInterval;
+    obstacleManager.clear();
+    obstacleManager.setSpawnWeights(level.obstacleWeights);
+    scoreManager.reset();
+    scoreManager.setSpawnWeights(level.coinWeights);
+    powerUpManager.reset();
 
     player.x = 50;
     player.y = GROUND_Y;
@@ -767,13 +1059,124 @@ void Game::startLevel(int levelIndex) {
     player.isOnGround = true;
 
     comboSystem.reset();
+    difficultyManager.setCurve(level.speedCurve);
+    if (endlessMode) difficultyManager.enableEndlessCap();
     difficultyManager.reset();
+    nextLevelEvent = 0;
     questSystem.resetSessionStats();
+    beatScheduler.reset();
+    startGenerator(level);
 
     gameOver = false;
     state = GameState::PLAYING;
 }
 
+// Endless chạy trên màn cao nhất đã mở (theme và trọng số sinh của màn đó)
+void Game::startEndless() {
+    int levelIndex = 0;
+    for (size_t i = 0; i < levelManager.levels.size(); i++) {
+        if (levelManager.levels[i].unlocked) levelIndex = (int)i;
+    }
+    endlessMode = true;
+    startLevel(levelIndex);
+}
+
+// Sinh ở mép phải màn hình như spawn theo timer; lift < 0 thì chọn làn như thường.
+// Vật cản và thiên thạch dùng spec đã chọn trong startGenerator (worker đã xếp pattern quanh chúng)
+void Game::runLevelEvent(const LevelEvent& event) {
+    LibcRandom rng;
+    double edge = world.toWorld(SCREEN_WIDTH);
+    switch (event.action) {
+        case LEVEL_EVENT_OBSTACLE:
+            if (nextScriptedHazard < scriptedHazards.size())
+                obstacleManager.spawnAt(edge, scriptedHazards[nextScriptedHazard++].spec);
+            break;
+        case LEVEL_EVENT_COIN: {
+            CoinType type = (CoinType)event.kind;
+            scoreManager.spawnCoinAt(edge, type, event.lift >= 0 ? event.lift : rollCoinLift(type, rng));
+            break;
+        }
+        case LEVEL_EVENT_POWERUP: {
+            int lift = event.lift >= 0 ? event.lift : PowerUp::MIN_LIFT + rng.below(PowerUp::LIFT_RANGE);
+            powerUpManager.spawnAt(edge, (PowerUpType)event.kind, lift);
+            break;
+        }
+        case LEVEL_EVENT_METEOR:
+            if (nextScriptedHazard < scriptedHazards.size()) {
+                const ScriptedHazard& hazard = scriptedHazards[nextScriptedHazard++];
+                obstacleManager.spawnMeteorAt(SCREEN_WIDTH - hazard.inset, hazard.spec);
+            }
+            break;
+    }
+}
+
+// Gốc thế giới dời lùi phần nguyên của offset: toạ độ trên màn hình không đổi,
+// còn worldX của mọi thứ luôn nhỏ dù chơi bao lâu
+void Game::rebaseWorld() {
+    double shift = std::floor(world.getOffset());
+    world.rebase(shift);
+    entities.rebase(shift);
+    levelGenerator.rebase(shift);
+}
+
+// Seed mới mỗi lần chơi; lịch tốc độ lấy từ DifficultyManager (vừa reset).
+// Vật cản và thiên thạch của kịch bản level được chọn spec ngay đây để worker
+// kiểm tra pattern quanh đúng những vật cản runLevelEvent sẽ sinh
+void Game::startGenerator(const LevelInfo& level) {
+    LibcRandom rng;
+    scriptedHazards.clear();
+    nextScriptedHazard = 0;
+    for (const LevelEvent& event : levelManager.getEvents()) {
+        ScriptedHazard hazard;
+        hazard.frame = event.frame;
+        if (event.action == LEVEL_EVENT_OBSTACLE) {
+            hazard.spec = rollObstacleSpec((ObstacleType)event.kind, rng);
+            if (event.lift >= 0) hazard.spec.lift = event.lift;
+            hazard.inset = 0;
+        } else if (event.action == LEVEL_EVENT_METEOR) {
+            hazard.spec = rollObstacleSpec(METEOR, rng);
+            hazard.inset = SCREEN_WIDTH - obstacleManager.rollMeteorX();
+        } else {
+            continue;
+        }
+        scriptedHazards.push_back(hazard);
+    }
+
+    GeneratorConfig config;
+    config.seed = (Uint32)time(NULL) ^ ((Uint32)level.levelNumber * 2654435761U);
+    config.obstacleWeights = level.obstacleWeights;
+    config.coinWeights = level.coinWeights;
+    config.startX = world.toWorld(SCREEN_WIDTH);
+    config.playerX = world.toWorld(player.x);
+    config.playerWidth = (int)player.width;
+    config.playerHeight = (int)player.height;
+    config.groundY = GROUND_Y;
+    config.gravity = player.gravity;
+    config.chunkWidth = SCREEN_WIDTH;
+    config.difficulty = difficultyManager;
+    config.scripted = scriptedHazards;
+    config.logStats = statsLog;
+    levelGenerator.start(config);
+}
+
+// Sức chứa pool: số vật cùng lúc trên màn hình ở tốc độ thấp nhất (đầu level)
+// với khoảng spawn ngắn nhất có thể, nhân đôi cho dư
+void Game::sizeEntityPools(const LevelInfo& level) {
+    const int MAX_ENTITY_WIDTH = 100;
+    int liveFrames = (int)((SCREEN_WIDTH + MAX_ENTITY_WIDTH) / difficultyManager.baseSpeed) + 1;
+    int obstacleGap = std::min(level.spawnInterval, 69);   // Timer 70-120 frame, theo nhạc >= 1.15 s
+    int meteorGap = 400;
+    int coinGap = 20;                                        // Theo nhạc: tối đa một xu mỗi phách ở 180 BPM
+    int powerUpGap = 300;
+
+    int obstacles = 2 * (liveFrames / obstacleGap + 1) + liveFrames / meteorGap + 1;
+    int coins = 2 * (liveFrames / coinGap + 1);
+    int powerUps = 2 * (liveFrames / powerUpGap + 1);
+    obstacleManager.reserve(obstacles);
+    scoreManager.reserve(coins);
+    powerUpManager.reserve(powerUps, coins);
+}
+
 SDL_Texture* Game::renderText(TTF_Font* font, const std::string& text, SDL_Color color) {
     SDL_Surface* surface = TTF_RenderUTF8_Blended(font, text.c_str(), color);
     if (!surface) {
@@ -808,8 +1211,21 @@ void Game::renderLeftText(TTF_Font* font, const std::string& text, SDL_Color col
 }
 
 void Game::cleanup() {
+    assetLoader.shutdown();
+    levelGenerator.stop();
+    beatAnalyzer.wait();  // Còn dùng mixer và musicData
     saveProgress();
     shop.cleanup();
+    textureAtlas.cleanup();
+    if (statsLog) {
+        audio.logStats();
+        events.logStats();
+        timers.logStats();
+        entities.logStats(ARCH_OBSTACLE, "obstacles");
+        entities.logStats(ARCH_COIN, "coins");
+        entities.logStats(ARCH_POWERUP, "power-ups");
+    }
+    audio.cleanup();
 
     if (backgroundMusic) {
         Mix_FreeMusic(backgroundMusic);
@@ -826,6 +1242,11 @@ void Game::cleanup() {
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
 
+    // Font và nhạc có thể đang trỏ vào pack nên đóng pack sau cùng
+    fontData.clear();
+    musicData.clear();
+    assetPack.close();
+
     IMG_Quit();
     TTF_Quit();
     SDL_Quit();
@@ -25,7 +25,18 @@
 #include "comboSystem.h"
 #include "DifficultyManager.h"
 #include "ObstacleManager.h"
+#include "asset_loader.h"
+#include "texture_atlas.h"
+#include "audio_system.h"
+#include "beat_map.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
+#include "world_scroll.h"
+#include "anim_clock.h"
+#include "ecs.h"
+#include "level_generator.h"
 enum class GameState {
+    LOADING,
     MENU,
     LEVEL_SELECT,
     PLAYING,
@@ -37,8 +48,15 @@ enum class GameState {
     LEADERBOARD
 };
 
-class Game {
+class Game : public GameEventListener {
+    friend bool runSoakTest(double hours);
+
 private:
+    // Screen dimensions: khai báo trước các manager vì chúng được khởi tạo từ đây
+    const int SCREEN_WIDTH;
+    const int SCREEN_HEIGHT;
+    const int GROUND_Y;
+
     // Window and rendering
     SDL_Window* window;
     SDL_Renderer* renderer;
@@ -48,12 +66,34 @@ private:
     TTF_Font* fontTiny;
     Mix_Music* backgroundMusic;
 
+    // Async asset loading
+    AssetPack assetPack;          // assets.pak (nếu có), mmap một lần
+    AssetLoader assetLoader;
+    AssetBlob fontData;           // TTF_OpenFontRW đọc trực tiếp từ buffer này
+    AssetBlob musicData;          // Mix_Music stream từ buffer này, phải sống tới khi free
+    Uint64 initStartCounter;
+    bool firstFramePresented;
+
+    // Skin và sprite vẽ sẵn dùng chung vài trang atlas
+    TextureAtlas textureAtlas;
+    CoinSprites coinSprites;
+    PowerUpIcons powerUpIcons;
+
     // Game systems
+    EventBus events;              // Sự kiện gameplay trong frame
+    TimerWheel timers;            // Timer gameplay, 1 tick = 1 frame PLAYING
+    WorldScroll world;            // Offset cuộn chung của vật cản/xu/power-up
+    AnimationClock animClock;     // Tick hoạt ảnh, tăng cùng WorldScroll
+    EntityRegistry entities;      // Vật cản/xu/power-up; các manager là mặt tiền
+    AudioSystem audio;
+    BeatAnalyzer beatAnalyzer;    // Đọc musicData trên thread riêng
+    BeatScheduler beatScheduler;
     Player player;
     UIRenderer uiRenderer;
     ObstacleManager obstacleManager;
     ScoreManager scoreManager;
     PowerUpManager powerUpManager;
+    LevelGenerator levelGenerator;  // Đoạn màn sinh trước trên worker, thay spawn theo timer
     LevelManager levelManager;
     Shop shop;
     ComboSystem comboSystem;
@@ -68,27 +108,43 @@ private:
     // Map and environment
     MapTheme mapTheme;
     DayNightCycle dayNightCycle;
+    bool musicNight;              // Đang phát bản nhạc đêm của theme
 
     // Game state
     GameState state;
     bool running;
     bool gameOver;
-    bool musicPlaying;
-
-    // Screen dimensions
-    const int SCREEN_WIDTH;
-    const int SCREEN_HEIGHT;
-    const int GROUND_Y;
+    bool endlessMode;             // Không có điểm đích, tốc độ tiến tới trần, chơi tới khi thua
+    size_t nextLevelEvent;        // Sự kiện kịch bản tiếp theo của level hiện tại
+    std::vector<ScriptedHazard> scriptedHazards;   // Spec chọn sẵn cho vật cản/thiên thạch kịch bản
+    size_t nextScriptedHazard;
+    int levelPage;                // Trang đang xem ở màn chọn level
+    bool headless;                // Soak test: không cửa sổ, không âm thanh, không ghi save
+    bool invulnerable;            // Soak test: va chạm chỉ được đếm, không thua
+    long long ignoredHits;
+    bool statsLog;                // --stats: in thống kê các hệ thống khi thoát
 
 public:
-    Game(int width = 800, int height = 600);
+    // headlessMode: cho initializeHeadless (soak test); các hệ thống không ghi save
+    // ngay từ lúc dựng
+    Game(int width = 800, int height = 600, bool headlessMode = false);
     ~Game();
 
     bool initialize();
+    bool initializeHeadless();
     void run();
     void cleanup();
+    void setStatsLog(bool enabled) { statsLog = enabled; }
 
 private:
+    void attachSystems();
+    void requestAssets();
+    void onFontLoaded(AssetBlob& blob);
+    void onMusicLoaded(AssetBlob& blob);
+    void updateMusicTrack();
+    void onGameEvent(const GameEvent& event) override;
+    double secondsSinceInit() const;
+
     void handleEvents();
     void update();
     void render();
@@ -103,6 +159,7 @@ private:
     void handleAchievementInput(SDL_Event& e);
     void handleLeaderboardInput(SDL_Event& e);
 
+    void renderLoading();
     void renderMenu();
     void renderLevelSelect();
     void renderPlaying();
@@ -123,6 +180,13 @@ private:
 
     void resetGame();
     void startLevel(int levelIndex);
+    void startEndless();
+    void rebaseWorld();
+    void runLevelEvent(const LevelEvent& event);
+    SDL_Rect levelButtonRect(int slot) const;
+    int levelPageCount() const;
+    void sizeEntityPools(const LevelInfo& level);
+    void startGenerator(const LevelInfo& level);
 };
 
 #endif // GAME_H_INCLUDED
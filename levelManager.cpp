@@ -1,28 +1,167 @@
 #include "levelManager.h"
+#include "entity_tables.h"
+#include "powerup.h"
+#include <iostream>
 
+// Có levels.lvp cạnh file chạy thì dùng (mod/pack khác), không thì bản nhúng
+// levels_builtin.inc. Cả hai sinh từ levels/main.txt ở bước pre-build
+static const char* LEVEL_PACK_PATH = "levels.lvp";
+// game_progress.dat cũ không ghi số level: luôn là 5 level có sẵn
+static const size_t LEGACY_LEVEL_COUNT = 5;
 
-LevelManager::LevelManager() {
-    currentLevel = 0;
-    initializeLevels();
+static_assert(OBSTACLE_TYPE_COUNT <= LEVEL_MAX_WEIGHTS && COIN_TYPE_COUNT <= LEVEL_MAX_WEIGHTS,
+              "LevelRecord weight arrays are too small");
+
+LevelManager::LevelManager() : currentLevel(0), loadedLevel(-1) {
+    events.reserve(LEVEL_MAX_EVENTS);
+    if (!openPack(LEVEL_PACK_PATH)) {
+        if (pack.openBuiltin()) {
+            indexLevels();
+        } else {
+            // Chỉ xảy ra khi levels_builtin.inc hỏng: vẫn chạy được một level mặc định
+            std::cerr << "LevelManager: no usable level pack, using a single default level" << std::endl;
+            levels = { {1, "Easy Valley", 6, 90, 300, 50, true, 0, GRASSLAND, nullptr, nullptr, SpeedCurve()} };
+        }
+    }
     loadProgress();
+    setCurrentLevel(0);
+}
+
+bool LevelManager::openPack(const std::string& path) {
+    if (!pack.open(path)) return false;
+    indexLevels();
+    return true;
+}
+
+// Chỉ dựng từ index: tên, đích, theme. Phần còn lại giữ mặc định tới khi nạp record
+void LevelManager::indexLevels() {
+    levels.clear();
+    levels.reserve(pack.levelCount());
+    for (int i = 0; i < pack.levelCount(); i++) {
+        const LevelIndexEntry& entry = pack.entry(i);
+        LevelInfo level;
+        level.levelNumber = i + 1;
+        level.name = entry.name;
+        level.obstacleSpeed = (int)level.speedCurve.baseSpeed;
+        level.spawnInterval = 90;
+        level.meteorInterval = 300;
+        level.targetScore = (int)entry.targetScore;
+        level.unlocked = i == 0;
+        level.bestScore = 0;
+        level.themeType = (MapThemeType)entry.theme;
+        levels.push_back(level);
+    }
+    currentLevel = 0;
+    loadedLevel = -1;
+    events.clear();
+}
+
+// Phần pack không tự kiểm tra được: loại thực thể và trọng số theo bảng của game
+static bool recordValid(const LevelRecord& record, const std::vector<LevelEvent>& events) {
+    ObstacleWeights obstacleWeights;
+    for (int i = 0; i < OBSTACLE_TYPE_COUNT; i++) obstacleWeights.weights[i] = record.obstacleWeights[i];
+    CoinWeights coinWeights;
+    for (int i = 0; i < COIN_TYPE_COUNT; i++) coinWeights.weights[i] = record.coinWeights[i];
+    if (((record.flags & LEVEL_OBSTACLE_WEIGHTS) && !weightsValid(obstacleWeights.weights)) ||
+        ((record.flags & LEVEL_COIN_WEIGHTS) && !weightsValid(coinWeights.weights))) return false;
+
+    bool speedValid = record.baseSpeed > 0.0f && record.baseSpeed < DifficultyManager::ENDLESS_MAX_SPEED &&
+                      record.speedIncrement >= 0.0f && record.speedInterval > 0 &&
+                      (record.maxSpeed == 0.0f || record.maxSpeed > record.baseSpeed);
+    if (!speedValid || record.spawnInterval == 0 || record.meteorInterval == 0) return false;
+
+    for (const LevelEvent& event : events) {
+        switch (event.action) {
+            case LEVEL_EVENT_OBSTACLE:
+                if (event.kind >= OBSTACLE_TYPE_COUNT || event.kind == METEOR) return false;
+                break;
+            case LEVEL_EVENT_COIN:
+                if (event.kind >= COIN_TYPE_COUNT) return false;
+                break;
+            case LEVEL_EVENT_POWERUP:
+                if (event.kind >= (int)PowerUpType::COUNT) return false;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+// Không đọc được record: vẫn chơi được với thông số mặc định, chỉ mất kịch bản
+bool LevelManager::loadLevel(int index) {
+    if (!pack.isOpen() || index == loadedLevel) return true;
+
+    if (loadedLevel >= 0) {
+        levels[loadedLevel].obstacleWeights = nullptr;
+        levels[loadedLevel].coinWeights = nullptr;
+    }
+    loadedLevel = -1;
+
+    LevelRecord record;
+    if (!pack.loadRecord(index, record, events) || !recordValid(record, events)) {
+        std::cerr << "LevelManager: level " << index + 1 << " could not be loaded, using defaults" << std::endl;
+        events.clear();
+        return false;
+    }
+
+    LevelInfo& level = levels[index];
+    level.spawnInterval = (int)record.spawnInterval;
+    level.meteorInterval = (int)record.meteorInterval;
+    level.speedCurve.baseSpeed = record.baseSpeed;
+    level.speedCurve.increment = record.speedIncrement;
+    level.speedCurve.interval = (int)record.speedInterval;
+    level.speedCurve.maxSpeed = record.maxSpeed;
+    level.obstacleSpeed = (int)record.baseSpeed;
+    if (record.flags & LEVEL_OBSTACLE_WEIGHTS) {
+        for (int i = 0; i < OBSTACLE_TYPE_COUNT; i++) loadedObstacleWeights.weights[i] = record.obstacleWeights[i];
+        level.obstacleWeights = &loadedObstacleWeights;
+    }
+    if (record.flags & LEVEL_COIN_WEIGHTS) {
+        for (int i = 0; i < COIN_TYPE_COUNT; i++) loadedCoinWeights.weights[i] = record.coinWeights[i];
+        level.coinWeights = &loadedCoinWeights;
+    }
+    loadedLevel = index;
+    return true;
 }
 
-void LevelManager::initializeLevels() {
-    levels = {
-        {1, "Easy Valley", 6, 90, 250, 50, true, 0, GRASSLAND},
-        {2, "Rocky Hills", 7, 80, 220, 100, false, 0, DESERT},
-        {3, "Desert Storm", 8, 70, 200, 150, false, 0, FOREST},
-        {4, "Thunder Plains", 9, 60, 180, 200, false, 0, MOUNTAIN},
-        {5, "Volcano Peak", 10, 50, 150, 300, false, 0, VOLCANO}
-    };
+void LevelManager::writeProgress(std::ostream& out) const {
+    out << "levels " << levels.size() << "\n";
+    for (const auto& level : levels) {
+        out << level.unlocked << " " << level.bestScore << "\n";
+    }
+}
+
+void LevelManager::readProgress(std::istream& in) {
+    std::string tag;
+    if (!(in >> tag)) return;
+    bool legacy = tag != "levels";
+    size_t saved = LEGACY_LEVEL_COUNT;
+    if (!legacy) in >> saved;
+
+    // Đổi pack thì số level có thể khác: thừa thì bỏ, thiếu thì giữ mặc định
+    for (size_t i = 0; i < saved; i++) {
+        bool unlocked;
+        int bestScore;
+        if (legacy && i == 0) {
+            unlocked = tag != "0";
+            in >> bestScore;
+        } else {
+            in >> unlocked >> bestScore;
+        }
+        if (!in) break;
+        if (i < levels.size()) {
+            levels[i].unlocked = unlocked;
+            levels[i].bestScore = bestScore;
+        }
+    }
+    if (!levels.empty()) levels[0].unlocked = true;
 }
 
 void LevelManager::saveProgress() {
     std::ofstream file("game_progress.dat");
     if (file.is_open()) {
-        for (const auto& level : levels) {
-            file << level.unlocked << " " << level.bestScore << "\n";
-        }
+        writeProgress(file);
         file.close();
     }
 }
@@ -30,9 +169,7 @@ void LevelManager::saveProgress() {
 void LevelManager::loadProgress() {
     std::ifstream file("game_progress.dat");
     if (file.is_open()) {
-        for (auto& level : levels) {
-            file >> level.unlocked >> level.bestScore;
-        }
+        readProgress(file);
         file.close();
     }
 }
@@ -62,5 +199,6 @@ LevelInfo& LevelManager::getCurrentLevelInfo() {
 void LevelManager::setCurrentLevel(int index) {
     if (index >= 0 && static_cast<size_t>(index) < levels.size()) {
         currentLevel = index;
+        loadLevel(index);
     }
 }
@@ -4,6 +4,10 @@
 #include "map_theme.h"
 #include <vector>
 #include <fstream>
+#include "obstacle.h"
+#include "score.h"
+#include "DifficultyManager.h"
+#include "level_pack.h"
 
 struct LevelInfo {
     int levelNumber;
@@ -15,6 +19,10 @@ struct LevelInfo {
     bool unlocked;
     int bestScore;
     MapThemeType themeType;
+    // Trọng số loại vật cản/xu riêng của level; nullptr = bảng mặc định
+    const ObstacleWeights* obstacleWeights = nullptr;
+    const CoinWeights* coinWeights = nullptr;
+    SpeedCurve speedCurve;
 };
 
 class LevelManager {
@@ -23,14 +31,32 @@ public:
     int currentLevel;
 
     LevelManager();
-    void initializeLevels();
+    // Thay danh sách level bằng index của level pack; record từng level nạp khi chọn
+    bool openPack(const std::string& path);
     void saveProgress();
     void loadProgress();
+    // Tiến độ từng level (mở khoá, điểm cao nhất), phần đầu của game_progress.dat
+    void writeProgress(std::ostream& out) const;
+    void readProgress(std::istream& in);
     void unlockNextLevel();
     void updateBestScore(int score);
     bool isLevelComplete(int score);
     LevelInfo& getCurrentLevelInfo();
+    // Đổi level hiện tại và nạp record của nó từ pack (nếu có)
     void setCurrentLevel(int index);
+    // Sự kiện kịch bản của level hiện tại, xếp theo frame
+    const std::vector<LevelEvent>& getEvents() const { return events; }
+    const std::string& getPackTitle() const { return pack.title(); }
+
+private:
+    void indexLevels();
+    bool loadLevel(int index);
+
+    LevelPack pack;
+    int loadedLevel;                        // Level có record đang nạp, -1 nếu chưa
+    ObstacleWeights loadedObstacleWeights;  // Trọng số của level đang nạp (LevelInfo trỏ vào đây)
+    CoinWeights loadedCoinWeights;
+    std::vector<LevelEvent> events;
 };
 
 #endif // LEVELMANAGER_H_INCLUDED
@@ -0,0 +1,484 @@
+#include "level_generator.h"
+#include "ObstacleManager.h"
+#include "ecs.h"
+#include "powerup.h"
+#include "player.h"
+#include "entity_tables.h"
+#include <iostream>
+#include <algorithm>
+
+// Nới vật cản theo chiều ngang: bù sai số dự báo tốc độ và làm tròn toạ độ
+static const double HORIZONTAL_MARGIN = 4.0;
+// Số pattern thử cho mỗi chỗ trống trước khi chèn đoạn nghỉ
+static const int MAX_ATTEMPTS = 4;
+
+struct PatternSlot {
+    Uint8 arch;       // ArchetypeId
+    Sint8 kind;       // -1: theo trọng số của level (power-up: đều)
+    Sint16 offset;    // px tính từ đầu pattern
+    Sint16 lift;      // -1: làn theo bảng loại
+};
+
+struct Pattern {
+    int weight;
+    int length, jitter;   // Chiếm length + 0..jitter-1 px
+    int slotCount;
+    PatternSlot slots[6];
+};
+
+static constexpr Pattern PATTERNS[] = {
+    // Một vật cản
+    { 40, 420, 300, 1, { { ARCH_OBSTACLE, -1, 0, -1 } } },
+    // Hàng xu thấp rồi vật cản
+    { 20, 460, 200, 4, { { ARCH_COIN, -1, 0, 60 }, { ARCH_COIN, -1, 40, 60 }, { ARCH_COIN, -1, 80, 60 },
+                         { ARCH_OBSTACLE, -1, 280, -1 } } },
+    // Vòng xu theo đường nhảy qua vật cản
+    { 15, 480, 200, 5, { { ARCH_COIN, -1, 0, 110 }, { ARCH_COIN, -1, 50, 170 }, { ARCH_OBSTACLE, -1, 100, -1 },
+                         { ARCH_COIN, -1, 110, 190 }, { ARCH_COIN, -1, 170, 150 } } },
+    // Hai vật cản: chạm đất rồi nhảy tiếp
+    { 10, 700, 200, 2, { { ARCH_OBSTACLE, -1, 0, -1 }, { ARCH_OBSTACLE, CACTUS_SMALL, 340, -1 } } },
+    // Chim ở làn ngẫu nhiên
+    { 8, 480, 200, 1, { { ARCH_OBSTACLE, BIRD, 0, -1 } } },
+    // Power-up rồi vật cản
+    { 6, 520, 200, 2, { { ARCH_POWERUP, -1, 0, -1 }, { ARCH_OBSTACLE, -1, 240, -1 } } },
+    // Nghỉ: không có vật cản nên luôn qua được
+    { 6, 300, 200, 0, { } },
+};
+
+static const int PATTERN_COUNT = sizeof(PATTERNS) / sizeof(PATTERNS[0]);
+static const int REST_PATTERN = PATTERN_COUNT - 1;
+
+struct PatternWeights {
+    int weights[PATTERN_COUNT];
+};
+constexpr PatternWeights PATTERN_WEIGHTS = weightsOf<PatternWeights>(PATTERNS);
+static_assert(weightsValid(PATTERN_WEIGHTS.weights), "invalid pattern weights");
+
+// Dựng lần đầu được dùng (trên worker)
+struct PatternPicker {
+    AliasTable<PATTERN_COUNT> table;
+
+    PatternPicker() { table.build(PATTERN_WEIGHTS.weights); }
+};
+
+// ===================== LEVEL GENERATOR IMPLEMENTATION =====================
+
+LevelGenerator::LevelGenerator()
+    : thread(nullptr), wake(nullptr), cursor(0.0), nextIndex(0), nextFixed(0),
+      airFrames(0), bobDrop(0.0f), chunksBuilt(0), patternsRejected(0), unavoidable(0), appliedShift(0.0),
+      currentItem(0), totalShift(0.0), unposted(0.0) {
+    SDL_AtomicSet(&stopping, 0);
+    current.count = 0;
+    current.endX = -1e300;
+    jumpArc[0] = 0;
+}
+
+LevelGenerator::~LevelGenerator() {
+    stop();
+    if (wake) SDL_DestroySemaphore(wake);
+}
+
+bool LevelGenerator::start(const GeneratorConfig& generatorConfig) {
+    stop();
+
+    config = generatorConfig;
+    rng.reseed(config.seed);
+    obstaclePicker.build((config.obstacleWeights ? *config.obstacleWeights : DEFAULT_OBSTACLE_WEIGHTS).weights);
+    coinPicker.build((config.coinWeights ? *config.coinWeights : DEFAULT_COIN_WEIGHTS).weights);
+    cursor = config.startX;
+    // Worker đã dừng: bỏ các lần dời gốc của lượt trước
+    double discardedShift;
+    while (shifts.pop(discardedShift)) {}
+    appliedShift = totalShift = unposted = 0.0;
+    nextIndex = 0;
+    pending.clear();
+    pending.reserve(64);
+    buildJumpArc();
+
+    // Nhấp nhô cộng vào y màn hình: chim thấp xuống tối đa bobDrop
+    bobDrop = 0.0f;
+    for (Uint32 age = 0; age < 256; age++) bobDrop = std::max(bobDrop, bobOffset(age));
+
+    sim.x = config.playerX;
+    sim.states = 1;   // Đứng trên đất
+    sim.speed = config.difficulty.currentSpeed;
+    sim.frame = config.difficulty.survivalTime;
+    sim.nextIncrease = config.difficulty.nextSpeedIncrease;
+    placeScripted();
+    chunksBuilt = patternsRejected = unavoidable = 0;
+
+    if (!wake) wake = SDL_CreateSemaphore(0);
+    if (!wake) {
+        std::cerr << "LevelGenerator: SDL_CreateSemaphore Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_AtomicSet(&stopping, 0);
+    thread = SDL_CreateThread(threadMain, "LevelGenerator", this);
+    if (!thread) {
+        std::cerr << "LevelGenerator: SDL_CreateThread Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    if (config.logStats) {
+        std::cout << "Level generator: seed " << config.seed << ", jump " << airFrames << " frames" << std::endl;
+    }
+    return true;
+}
+
+void LevelGenerator::stop() {
+    if (thread) {
+        SDL_AtomicSet(&stopping, 1);
+        SDL_SemPost(wake);
+        SDL_WaitThread(thread, nullptr);
+        thread = nullptr;
+        if (config.logStats) {
+            std::cout << "Level generator: " << chunksBuilt << " chunks, "
+                      << patternsRejected << " patterns rejected as unfair" << std::endl;
+        }
+        if (unavoidable > 0)
+            std::cerr << "Level generator: " << unavoidable << " scripted hazard(s) cannot be avoided" << std::endl;
+    }
+    // Worker đã dừng: main thread làm consumer, bỏ các đoạn còn lại
+    GeneratedChunk discarded;
+    while (ready.pop(discarded)) {}
+    current.count = 0;
+    current.endX = -1e300;
+    currentItem = 0;
+}
+
+bool LevelGenerator::feed(double spawnLine, ObstacleManager& obstacles, ScoreManager& coins, PowerUpManager& powerUps) {
+    if (!thread) return true;
+    for (;;) {
+        if (currentItem >= current.count) {
+            // Worker chưa kịp: frame sau thử lại (đoạn vừa hết vẫn phủ spawnLine thì chưa tính là trễ)
+            if (!ready.pop(current)) return current.endX > spawnLine;
+            currentItem = 0;
+            // Đoạn sinh trước khi worker nhận các lần dời gốc gần nhất
+            double lag = totalShift - current.shift;
+            if (lag != 0.0) {
+                for (int i = 0; i < current.count; i++) current.items[i].worldX -= lag;
+                current.startX -= lag;
+                current.endX -= lag;
+            }
+            SDL_SemPost(wake);
+            continue;
+        }
+        const SpawnCommand& command = current.items[currentItem];
+        double worldX = command.worldX;
+        if (worldX > spawnLine) return true;
+        currentItem++;
+
+        switch (command.arch) {
+            case ARCH_OBSTACLE: {
+                ObstacleSpec spec;
+                spec.type = (ObstacleType)command.kind;
+                spec.width = command.width;
+                spec.height = command.height;
+                spec.lift = command.lift;
+                spec.variant = command.variant;
+                spec.skyY = spec.fallSpeed = 0;
+                obstacles.spawnAt(worldX, spec);
+                break;
+            }
+            case ARCH_COIN:
+                coins.spawnCoinAt(worldX, (CoinType)command.kind, command.lift);
+                break;
+            case ARCH_POWERUP:
+                powerUps.spawnAt(worldX, (PowerUpType)command.kind, command.lift);
+                break;
+        }
+    }
+}
+
+void LevelGenerator::rebase(double shift) {
+    totalShift += shift;
+    for (int i = currentItem; i < current.count; i++) current.items[i].worldX -= shift;
+    current.startX -= shift;
+    current.endX -= shift;
+    if (!thread) return;
+    // shifts đầy (worker chưa đọc mấy lần trước): gộp vào lần sau, feed vẫn bù đúng theo totalShift
+    unposted += shift;
+    if (shifts.push(unposted)) {
+        unposted = 0.0;
+        SDL_SemPost(wake);
+    }
+}
+
+int LevelGenerator::threadMain(void* data) {
+    static_cast<LevelGenerator*>(data)->run();
+    return 0;
+}
+
+void LevelGenerator::run() {
+    GeneratedChunk chunk;
+    while (!SDL_AtomicGet(&stopping)) {
+        double shift;
+        while (shifts.pop(shift)) applyShift(shift);
+        if (ready.size() >= READY_CHUNKS) {
+            SDL_SemWait(wake);   // feed() gọi lại khi lấy đi một đoạn
+            continue;
+        }
+        buildChunk(chunk);
+        ready.push(chunk);
+    }
+}
+
+// Như EntityRegistry::rebase cho mọi worldX worker đang giữ
+void LevelGenerator::applyShift(double shift) {
+    cursor -= shift;
+    sim.x -= shift;
+    for (Hazard& hazard : pending) {
+        hazard.left -= shift;
+        hazard.right -= shift;
+    }
+    for (Hazard& hazard : fixedHazards) {
+        hazard.left -= shift;
+        hazard.right -= shift;
+    }
+    for (TrackPoint& point : fallTrack) point.x -= shift;
+    appliedShift += shift;
+}
+
+// Độ cao đáy người chơi sau k frame kể từ lúc nhấn nhảy, tính lại đúng như
+// Game::update (y nguyên, vy thực, y += 2*vy) để có cả phần làm tròn
+void LevelGenerator::buildJumpArc() {
+    int y = config.groundY;
+    float vy = Player::JUMP_VELOCITY;
+    airFrames = 0;
+    for (int k = 1; k <= MAX_AIR_FRAMES; k++) {
+        vy += config.gravity;
+        y += 2*vy;
+        if (y >= config.groundY) {
+            airFrames = k;
+            break;
+        }
+        jumpArc[k] = config.groundY - y;
+    }
+    if (airFrames == 0) {
+        std::cerr << "LevelGenerator: jump longer than " << MAX_AIR_FRAMES << " frames, arc truncated" << std::endl;
+        airFrames = MAX_AIR_FRAMES;
+    }
+    jumpArc[airFrames] = 0;
+}
+
+// Đặt vật cản kịch bản vào thế giới: chạy lịch tốc độ như advance() tới frame
+// sinh, mép phải màn hình lúc đó là startX cộng quãng đã cuộn
+void LevelGenerator::placeScripted() {
+    fixedHazards.clear();
+    falling.clear();
+    fallTrack.clear();
+    nextFixed = 0;
+
+    Run r = sim;
+    for (const ScriptedHazard& scripted : config.scripted) {
+        // Sự kiện chạy sau khi frame đã cuộn, sớm nhất là frame đầu tiên
+        int frame = std::max((int)scripted.frame, sim.frame + 1);
+        while (r.frame < frame) advance(r);
+        double edge = config.startX + (r.x - config.playerX);
+        const ObstacleSpec& spec = scripted.spec;
+        const ObstacleParams& params = OBSTACLE_TYPES[spec.type];
+
+        if (params.laneCount > 0) {
+            Hazard hazard;
+            hazard.left = edge - HORIZONTAL_MARGIN;
+            hazard.right = edge + spec.width + HORIZONTAL_MARGIN;
+            hazard.bottom = (float)spec.lift - ((params.flags & ENTITY_BOBBING) ? bobDrop : 0.0f);
+            hazard.top = (float)(spec.lift + spec.height + 1);
+            fixedHazards.push_back(hazard);
+            continue;
+        }
+
+        // Như runMotionSystem: mỗi frame x += drift, y += vy rồi tăng vy; hết khi đỉnh đã dưới đất
+        FallingHazard hazard;
+        hazard.firstFrame = frame;
+        hazard.track = (int)fallTrack.size();
+        hazard.width = spec.width;
+        hazard.height = spec.height;
+        double x = edge - scripted.inset;
+        float drift = r.speed / 2, y = (float)spec.skyY, vy = (float)spec.fallSpeed;
+        while (y - spec.height <= config.groundY) {
+            x += drift;
+            y += vy;
+            if (vy < FALL_MAX_SPEED) vy += FALL_ACCELERATION;
+            TrackPoint point = { x, (float)config.groundY - y };
+            fallTrack.push_back(point);
+        }
+        hazard.frameCount = (int)fallTrack.size() - hazard.track;
+        falling.push_back(hazard);
+    }
+    // Sự kiện xếp theo frame, mép phải chỉ tiến nên đã theo left; giữ chắc cho bản tay
+    std::sort(fixedHazards.begin(), fixedHazards.end(),
+              [](const Hazard& a, const Hazard& b) { return a.left < b.left; });
+}
+
+void LevelGenerator::buildChunk(GeneratedChunk& chunk) {
+    static const PatternPicker picker;
+
+    chunk.index = nextIndex++;
+    chunk.startX = cursor;
+    chunk.shift = appliedShift;
+    chunk.count = 0;
+    double end = cursor + config.chunkWidth;
+    while (cursor < end) {
+        bool placed = false;
+        for (int attempt = 0; attempt < MAX_ATTEMPTS && !placed; attempt++) {
+            int pattern = picker.table.sample(rng);
+            if (chunk.count + PATTERNS[pattern].slotCount > GeneratedChunk::MAX_ITEMS) break;
+            placed = tryPattern(pattern, chunk, cursor, false);
+            if (!placed) patternsRejected++;
+        }
+        if (!placed) tryPattern(REST_PATTERN, chunk, cursor, true);
+    }
+    std::sort(chunk.items, chunk.items + chunk.count,
+              [](const SpawnCommand& a, const SpawnCommand& b) { return a.worldX < b.worldX; });
+    chunk.endX = cursor;
+    chunksBuilt++;
+}
+
+// force: luôn nhận (đoạn nghỉ khi mọi pattern đều hỏng), kể cả khi vật cản
+// kịch bản không tránh được
+bool LevelGenerator::tryPattern(int patternIndex, GeneratedChunk& chunk, double& patternStart, bool force) {
+    const Pattern& pattern = PATTERNS[patternIndex];
+    double origin = patternStart;
+    double next = origin + pattern.length + (pattern.jitter > 0 ? rng.below(pattern.jitter) : 0);
+    size_t keepHazards = pending.size();
+    size_t keepFixed = nextFixed;
+    int keepCount = chunk.count;
+
+    for (int i = 0; i < pattern.slotCount; i++) {
+        const PatternSlot& slot = pattern.slots[i];
+        SpawnCommand command = SpawnCommand();
+        command.worldX = origin + slot.offset;
+        command.arch = slot.arch;
+
+        if (slot.arch == ARCH_OBSTACLE) {
+            ObstacleType type = slot.kind >= 0 ? (ObstacleType)slot.kind : (ObstacleType)obstaclePicker.sample(rng);
+            const ObstacleParams& params = OBSTACLE_TYPES[type];
+            if (params.laneCount == 0) {
+                // Thiên thạch chỉ sinh theo timer riêng
+                pending.resize(keepHazards);
+                chunk.count = keepCount;
+                return false;
+            }
+            ObstacleSpec spec = rollObstacleSpec(type, rng);
+            if (slot.lift >= 0) spec.lift = slot.lift;
+            command.kind = (Uint8)type;
+            command.variant = (Uint8)spec.variant;
+            command.width = (Sint16)spec.width;
+            command.height = (Sint16)spec.height;
+            command.lift = (Sint16)spec.lift;
+
+            Hazard hazard;
+            hazard.left = command.worldX - HORIZONTAL_MARGIN;
+            hazard.right = command.worldX + spec.width + HORIZONTAL_MARGIN;
+            hazard.bottom = (float)spec.lift - ((params.flags & ENTITY_BOBBING) ? bobDrop : 0.0f);
+            hazard.top = (float)(spec.lift + spec.height + 1);   // +1: y bị cắt phần lẻ khi va chạm
+            pending.push_back(hazard);
+        } else if (slot.arch == ARCH_COIN) {
+            CoinType type = slot.kind >= 0 ? (CoinType)slot.kind : (CoinType)coinPicker.sample(rng);
+            command.kind = (Uint8)type;
+            command.lift = (Sint16)(slot.lift >= 0 ? slot.lift : rollCoinLift(type, rng));
+        } else {
+            int type = slot.kind >= 0 ? slot.kind : rng.below((int)PowerUpType::COUNT);
+            command.kind = (Uint8)type;
+            command.lift = (Sint16)(slot.lift >= 0 ? slot.lift : PowerUp::MIN_LIFT + rng.below(PowerUp::LIFT_RANGE));
+        }
+        chunk.items[chunk.count++] = command;
+    }
+
+    // Vật cản kịch bản bắt đầu trong pattern này kiểm tra cùng pattern
+    while (nextFixed < fixedHazards.size() && fixedHazards[nextFixed].left < next) pending.push_back(fixedHazards[nextFixed++]);
+
+    // Thử tới khi mọi vật cản đã trôi qua người chơi. Vật cản kịch bản trong
+    // tầm một cú nhảy sau đó và thiên thạch đang rơi kéo dài lần thử: không
+    // được nhận pattern chỉ qua được bằng cách lao vào chúng
+    if (pending.size() > keepHazards && !force) {
+        double clear = 0.0;
+        for (const Hazard& hazard : pending) clear = std::max(clear, hazard.right);
+        int until = 0;
+        Run trial = sim;
+        while (true) {
+            while (nextFixed < fixedHazards.size() && fixedHazards[nextFixed].left < clear + config.playerWidth + airFrames * trial.speed) {
+                clear = std::max(clear, fixedHazards[nextFixed].right);
+                pending.push_back(fixedHazards[nextFixed++]);
+            }
+            for (const FallingHazard& meteor : falling) {
+                if (meteor.firstFrame <= trial.frame + 1) until = std::max(until, meteor.firstFrame + meteor.frameCount);
+            }
+            if (trial.x >= clear && trial.frame >= until) break;
+            step(trial);
+            if (!trial.states) {
+                pending.resize(keepHazards);
+                nextFixed = keepFixed;
+                chunk.count = keepCount;
+                return false;
+            }
+        }
+    }
+
+    // Nhận: chốt các frame mà vật cản của pattern sau không còn chạm tới được
+    while (sim.x + nextSpeed(sim) + config.playerWidth < next - HORIZONTAL_MARGIN) {
+        step(sim);
+        if (!sim.states) {
+            // Chỉ vật cản kịch bản làm được vậy: coi như người chơi đứng lại trên đất
+            unavoidable++;
+            sim.states = 1;
+        }
+    }
+    double passed = sim.x;
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [passed](const Hazard& hazard) { return hazard.right <= passed; }),
+                  pending.end());
+    patternStart = next;
+    return true;
+}
+
+// Quãng cuộn của frame tới (không đổi run)
+float LevelGenerator::nextSpeed(const Run& r) const {
+    return r.frame + 1 >= r.nextIncrease ? config.difficulty.stepSpeed(r.speed) : r.speed;
+}
+
+// Như DifficultyManager::update rồi WorldScroll::advance
+void LevelGenerator::advance(Run& r) const {
+    r.frame++;
+    if (r.frame >= r.nextIncrease) {
+        r.speed = config.difficulty.stepSpeed(r.speed);
+        r.nextIncrease += config.difficulty.speedIncreaseInterval;
+    }
+    r.x += r.speed;
+}
+
+// Bỏ các trạng thái chạm hazard khi mép trái người chơi ở x
+Uint64 LevelGenerator::removeHits(const Hazard& hazard, double x, Uint64 states) const {
+    if (hazard.left >= x + config.playerWidth || hazard.right <= x) return states;
+    for (int k = 0; k < airFrames; k++) {
+        if (!(states & ((Uint64)1 << k))) continue;
+        float bottom = (float)jumpArc[k];
+        if (hazard.bottom < bottom + config.playerHeight && hazard.top > bottom) states &= ~((Uint64)1 << k);
+    }
+    return states;
+}
+
+// Một frame: đứng yên hoặc nhảy, người đang bay đi tiếp trên đường nhảy;
+// bỏ trạng thái nào chạm vật cản ở vị trí mới
+void LevelGenerator::step(Run& r) const {
+    Uint64 states = r.states;
+    Uint64 next = (states & ~(Uint64)1) << 1;
+    Uint64 landed = (Uint64)1 << airFrames;
+    if (next & landed) next = (next & ~landed) | 1;
+    if (states & 1) next |= 1 | 2;
+
+    advance(r);
+    for (const Hazard& hazard : pending) next = removeHits(hazard, r.x, next);
+    for (const FallingHazard& meteor : falling) {
+        int t = r.frame - meteor.firstFrame;
+        if (t < 0 || t >= meteor.frameCount) continue;
+        const TrackPoint& point = fallTrack[meteor.track + t];
+        Hazard hazard;
+        hazard.left = point.x - HORIZONTAL_MARGIN;
+        hazard.right = point.x + meteor.width + HORIZONTAL_MARGIN;
+        hazard.bottom = point.bottom;
+        hazard.top = point.bottom + meteor.height + 1;
+        next = removeHits(hazard, r.x, next);
+    }
+    r.states = next;
+}
@@ -0,0 +1,164 @@
+#ifndef LEVEL_GENERATOR_H_INCLUDED
+#define LEVEL_GENERATOR_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "spsc_ring.h"
+#include "random_stream.h"
+#include "alias_table.h"
+#include "obstacle.h"
+#include "score.h"
+#include "DifficultyManager.h"
+
+class ObstacleManager;
+class ScoreManager;
+class PowerUpManager;
+
+// Một thực thể đã chọn sẵn mọi tham số; main thread chỉ tạo hàng khi worldX tới mép phải
+struct SpawnCommand {
+    double worldX;
+    Uint8 arch;             // ArchetypeId
+    Uint8 kind;             // ObstacleType / CoinType / PowerUpType
+    Uint8 variant;
+    Sint16 width, height;   // Chỉ vật cản
+    Sint16 lift;            // Đáy cao hơn mặt đất
+};
+
+// Một đoạn rộng cỡ màn hình, lệnh xếp theo worldX
+struct GeneratedChunk {
+    static const int MAX_ITEMS = 32;
+
+    Uint32 index;
+    double startX, endX;
+    double shift;           // Tổng các lần dời gốc worker đã áp lúc sinh đoạn
+    int count;
+    SpawnCommand items[MAX_ITEMS];
+};
+
+// Vật cản trong kịch bản của level: Game sinh ở đúng frame với spec chọn sẵn
+// (Game::runLevelEvent), worker coi như vật cản cố định khi kiểm tra pattern
+struct ScriptedHazard {
+    Uint32 frame;           // survivalTime lúc sinh (như LevelEvent::frame)
+    int inset;              // Sinh cách mép phải màn hình bấy nhiêu px (thiên thạch), 0: ở mép
+    ObstacleSpec spec;
+};
+
+struct GeneratorConfig {
+    Uint32 seed;
+    const ObstacleWeights* obstacleWeights;   // nullptr: bảng mặc định
+    const CoinWeights* coinWeights;
+    double startX;            // worldX đoạn đầu tiên (mép phải màn hình lúc bắt đầu)
+    double playerX;           // worldX mép trái người chơi lúc bắt đầu
+    int playerWidth, playerHeight;
+    int groundY;
+    float gravity;
+    int chunkWidth;
+    DifficultyManager difficulty;   // Bản sao vừa reset: lịch tăng tốc (kể cả trần của endless)
+    std::vector<ScriptedHazard> scripted;   // Theo frame
+    bool logStats;            // In seed và số đoạn/pattern bị bỏ khi start/stop (--stats)
+};
+
+// Sinh màn theo pattern trên thread riêng, đi trước một-hai đoạn. Mỗi pattern
+// được kiểm tra công bằng trước khi nhận: tập trạng thái người chơi (đứng
+// hoặc đang ở frame thứ k của cú nhảy) được đẩy từng frame qua các vật cản ở
+// tốc độ theo lịch của DifficultyManager; pattern làm tập này rỗng thì bị bỏ.
+// SPEED_BOOST chỉ làm power-up trôi nhanh hơn nên không đổi tốc độ cuộn.
+// Vật cản kịch bản của level được đặt vào thế giới theo cùng lịch tốc độ và
+// tính vào mọi lần kiểm tra (thiên thạch theo đúng đường rơi từng frame).
+// Đường nhảy lấy từ đúng phép tích phân của Game::update (vy, gravity, y += 2*vy).
+class LevelGenerator {
+public:
+    LevelGenerator();
+    ~LevelGenerator();
+
+    // Dừng worker cũ (nếu có), bỏ các đoạn chưa dùng rồi sinh lại từ seed
+    bool start(const GeneratorConfig& config);
+    void stop();
+    bool isRunning() const { return thread != nullptr; }
+
+    // Main thread: tạo mọi thực thể có worldX <= spawnLine. false: worker chưa
+    // sinh kịp tới spawnLine (đoạn sau sẽ tạo bù khi tới)
+    bool feed(double spawnLine, ObstacleManager& obstacles, ScoreManager& coins, PowerUpManager& powerUps);
+    // Main thread: feed() tới spawnLine không phải chờ worker (đoạn kế rộng cả màn hình)
+    bool isAhead(double spawnLine) const { return !thread || current.endX > spawnLine || ready.size() > 0; }
+    // Main thread: gốc thế giới vừa dời lùi shift px (như EntityRegistry::rebase).
+    // Worker dời toạ độ của mình trước đoạn kế; đoạn sinh theo gốc cũ được bù khi lấy ra
+    void rebase(double shift);
+
+private:
+    static const int MAX_AIR_FRAMES = 63;   // Trạng thái người chơi vừa một Uint64
+    static const int READY_CHUNKS = 2;
+    static const int SHIFT_SLOTS = 4;
+
+    // Vùng nguy hiểm trong thế giới: [left, right] x [bottom, top] tính từ mặt đất
+    struct Hazard {
+        double left, right;
+        float bottom, top;
+    };
+
+    // Thiên thạch kịch bản: vị trí từng frame tính sẵn trong fallTrack
+    struct FallingHazard {
+        int firstFrame;       // Frame sinh (đã rơi một bước khi kiểm tra va chạm)
+        int frameCount;
+        int track;            // Chỉ số điểm đầu trong fallTrack
+        int width, height;
+    };
+
+    struct TrackPoint {
+        double x;             // worldX mép trái
+        float bottom;         // Đáy tính từ mặt đất (âm: đã lún dưới đất)
+    };
+
+    // Tiến trình mô phỏng: bit 0 đứng trên đất, bit k đang ở frame k của cú nhảy
+    struct Run {
+        double x;             // worldX mép trái người chơi
+        Uint64 states;
+        float speed;          // Như DifficultyManager::currentSpeed
+        int frame, nextIncrease;
+    };
+
+    static int threadMain(void* data);
+    void run();
+    void buildChunk(GeneratedChunk& chunk);
+    bool tryPattern(int pattern, GeneratedChunk& chunk, double& cursor, bool force);
+    float nextSpeed(const Run& r) const;
+    void advance(Run& r) const;
+    void step(Run& r) const;
+    Uint64 removeHits(const Hazard& hazard, double x, Uint64 states) const;
+    void buildJumpArc();
+    void placeScripted();
+    void applyShift(double shift);
+
+    GeneratorConfig config;
+    SDL_Thread* thread;
+    SDL_sem* wake;
+    SDL_atomic_t stopping;
+    SpscRing<GeneratedChunk, READY_CHUNKS> ready;
+    SpscRing<double, SHIFT_SLOTS> shifts;   // Main -> worker: các lần dời gốc
+
+    // Chỉ worker dùng
+    RandomStream rng;
+    AliasTable<OBSTACLE_TYPE_COUNT> obstaclePicker;
+    AliasTable<COIN_TYPE_COUNT> coinPicker;
+    double cursor;
+    Uint32 nextIndex;
+    std::vector<Hazard> pending;      // Vật cản chưa trôi qua người chơi
+    std::vector<Hazard> fixedHazards; // Vật cản kịch bản đứng yên, theo left
+    size_t nextFixed;                 // Cái đầu tiên chưa vào pending
+    std::vector<FallingHazard> falling;
+    std::vector<TrackPoint> fallTrack;
+    Run sim;
+    int jumpArc[MAX_AIR_FRAMES + 1];  // Độ cao đáy sau k frame; jumpArc[airFrames] = 0 (chạm đất)
+    int airFrames;
+    float bobDrop;                    // Chim hạ thấp nhất bao nhiêu khi nhấp nhô
+    int chunksBuilt, patternsRejected, unavoidable;
+    double appliedShift;              // Tổng các lần dời gốc đã áp vào toạ độ worker
+
+    // Chỉ main thread dùng
+    GeneratedChunk current;
+    int currentItem;
+    double totalShift;    // Tổng các lần dời gốc từ lúc start
+    double unposted;      // Phần chưa gửi được vì shifts đầy
+};
+
+#endif // LEVEL_GENERATOR_H_INCLUDED
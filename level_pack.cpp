@@ -0,0 +1,103 @@
+#include "level_pack.h"
+#include <iostream>
+#include <cstring>
+
+// LEVELS_BUILTIN: sinh bởi tools/level_compiler ở bước pre-build (xem Game.cbp)
+#include "levels_builtin.inc"
+
+// ===================== LEVEL PACK IMPLEMENTATION =====================
+
+LevelPack::LevelPack() : base(nullptr), entries(nullptr), count(0) {}
+
+bool LevelPack::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    if (!attach(file.data(), file.size(), path.c_str())) {
+        close();
+        return false;
+    }
+    std::cout << "Level pack " << path << " (" << packTitle << "): " << count << " levels" << std::endl;
+    return true;
+}
+
+bool LevelPack::openBuiltin() {
+    close();
+    if (!attach(reinterpret_cast<const char*>(LEVELS_BUILTIN), sizeof(LEVELS_BUILTIN), "built-in levels")) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LevelPack::close() {
+    file.close();
+    base = nullptr;
+    entries = nullptr;
+    count = 0;
+    packTitle.clear();
+}
+
+bool LevelPack::attach(const char* data, size_t size, const char* source) {
+    if (size < sizeof(LevelPackHeader)) {
+        std::cerr << "LevelPack: " << source << " is too small" << std::endl;
+        return false;
+    }
+
+    LevelPackHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, LEVEL_PACK_MAGIC, sizeof(LEVEL_PACK_MAGIC)) != 0 || header.version != LEVEL_PACK_VERSION) {
+        std::cerr << "LevelPack: " << source << " has wrong magic/version" << std::endl;
+        return false;
+    }
+
+    Uint64 indexEnd = (Uint64)header.indexOffset + (Uint64)header.levelCount * sizeof(LevelIndexEntry);
+    if (header.levelCount == 0 || header.indexOffset % alignof(LevelIndexEntry) != 0 || indexEnd > size) {
+        std::cerr << "LevelPack: " << source << " has a corrupt level index" << std::endl;
+        return false;
+    }
+
+    // Chỉ kiểm tra index (vài chục byte mỗi level); record được kiểm tra khi nạp
+    const LevelIndexEntry* index = reinterpret_cast<const LevelIndexEntry*>(data + header.indexOffset);
+    for (Uint32 i = 0; i < header.levelCount; i++) {
+        const LevelIndexEntry& e = index[i];
+        if ((Uint64)e.recordOffset + e.recordSize > size || e.recordOffset % alignof(LevelRecord) != 0 ||
+            e.name[LEVEL_NAME_LENGTH - 1] != '\0' || e.theme >= LEVEL_THEME_COUNT) {
+            std::cerr << "LevelPack: " << source << " level " << i + 1 << " is out of bounds" << std::endl;
+            return false;
+        }
+    }
+
+    base = data;
+    entries = index;
+    count = header.levelCount;
+    char title[LEVEL_PACK_TITLE_LENGTH + 1];
+    memcpy(title, header.title, LEVEL_PACK_TITLE_LENGTH);
+    title[LEVEL_PACK_TITLE_LENGTH] = '\0';
+    packTitle = title;
+    return true;
+}
+
+bool LevelPack::loadRecord(int index, LevelRecord& record, std::vector<LevelEvent>& events) const {
+    events.clear();
+    if (index < 0 || (Uint32)index >= count) return false;
+
+    const LevelIndexEntry& e = entries[index];
+    if (e.recordSize < sizeof(LevelRecord)) return false;
+    memcpy(&record, base + e.recordOffset, sizeof(record));
+    if (record.eventCount > LEVEL_MAX_EVENTS ||
+        e.recordSize != sizeof(LevelRecord) + record.eventCount * sizeof(LevelEvent)) {
+        std::cerr << "LevelPack: level " << index + 1 << " has a corrupt record" << std::endl;
+        return false;
+    }
+
+    const LevelEvent* source = reinterpret_cast<const LevelEvent*>(base + e.recordOffset + sizeof(LevelRecord));
+    for (Uint32 i = 0; i < record.eventCount; i++) {
+        if (source[i].action >= LEVEL_EVENT_ACTION_COUNT || (i > 0 && source[i].frame < source[i - 1].frame)) {
+            std::cerr << "LevelPack: level " << index + 1 << " event " << i << " is invalid" << std::endl;
+            events.clear();
+            return false;
+        }
+        events.push_back(source[i]);
+    }
+    return true;
+}
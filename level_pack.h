@@ -0,0 +1,103 @@
+#ifndef LEVEL_PACK_H_INCLUDED
+#define LEVEL_PACK_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+
+// Định dạng levels.lvp (little-endian), tạo bởi tools/level_compiler từ file text:
+//   [LevelPackHeader][LevelIndexEntry x levelCount][LevelRecord + LevelEvent x eventCount]...
+// Lúc khởi động chỉ đọc header và index (đủ cho màn chọn level); record của
+// một level chỉ được giải mã khi bắt đầu chơi level đó.
+static const char LEVEL_PACK_MAGIC[4] = { 'D', 'L', 'V', 'L' };
+static const Uint32 LEVEL_PACK_VERSION = 1;
+static const int LEVEL_NAME_LENGTH = 32;
+static const int LEVEL_PACK_TITLE_LENGTH = 32;
+static const int LEVEL_MAX_WEIGHTS = 8;          // >= OBSTACLE_TYPE_COUNT, COIN_TYPE_COUNT
+static const Uint32 LEVEL_MAX_EVENTS = 256;
+static const Uint32 LEVEL_THEME_COUNT = 5;       // MapThemeType: GRASSLAND..VOLCANO
+
+enum LevelRecordFlags {
+    LEVEL_OBSTACLE_WEIGHTS = 1 << 0,   // Không có: bảng mặc định
+    LEVEL_COIN_WEIGHTS     = 1 << 1
+};
+
+// Sự kiện kịch bản: chạy khi thời gian sống (frame) của lượt chơi tới `frame`
+enum LevelEventAction {
+    LEVEL_EVENT_OBSTACLE,   // kind = ObstacleType (không phải METEOR)
+    LEVEL_EVENT_COIN,       // kind = CoinType
+    LEVEL_EVENT_POWERUP,    // kind = PowerUpType
+    LEVEL_EVENT_METEOR,     // Thiên thạch rơi chéo như timer thiên thạch
+    LEVEL_EVENT_ACTION_COUNT
+};
+
+struct LevelPackHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 levelCount;
+    Uint32 indexOffset;
+    char title[LEVEL_PACK_TITLE_LENGTH];
+};
+
+struct LevelIndexEntry {
+    char name[LEVEL_NAME_LENGTH];
+    Uint32 targetScore;
+    Uint32 theme;           // MapThemeType
+    Uint32 recordOffset;
+    Uint32 recordSize;      // sizeof(LevelRecord) + eventCount * sizeof(LevelEvent)
+};
+
+struct LevelRecord {
+    Uint32 spawnInterval, meteorInterval;
+    float baseSpeed, speedIncrement;     // SpeedCurve
+    Uint32 speedInterval;
+    float maxSpeed;
+    Uint16 obstacleWeights[LEVEL_MAX_WEIGHTS];
+    Uint16 coinWeights[LEVEL_MAX_WEIGHTS];
+    Uint32 flags;
+    Uint32 eventCount;      // Các LevelEvent theo ngay sau, xếp theo frame
+};
+
+struct LevelEvent {
+    Uint32 frame;
+    Uint8 action;           // LevelEventAction
+    Uint8 kind;
+    Sint16 lift;            // -1: làn theo bảng loại (power-up: ngẫu nhiên)
+};
+
+SDL_COMPILE_TIME_ASSERT(level_pack_header_size, sizeof(LevelPackHeader) == 48);
+SDL_COMPILE_TIME_ASSERT(level_index_entry_size, sizeof(LevelIndexEntry) == 48);
+SDL_COMPILE_TIME_ASSERT(level_record_size, sizeof(LevelRecord) == 64);
+SDL_COMPILE_TIME_ASSERT(level_event_size, sizeof(LevelEvent) == 8);
+
+// Level pack được mmap một lần (hoặc bản nhúng lúc build); index đọc thẳng từ vùng nhớ đó
+class LevelPack {
+public:
+    LevelPack();
+
+    bool open(const std::string& path);
+    // levels_builtin.inc: cùng image do level_compiler sinh từ levels/main.txt
+    bool openBuiltin();
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    int levelCount() const { return (int)count; }
+    const LevelIndexEntry& entry(int index) const { return entries[index]; }
+    const std::string& title() const { return packTitle; }
+
+    // Kiểm tra cấu trúc rồi chép record (cùng các sự kiện) của một level; false nếu hỏng.
+    // Loại vật cản/xu và trọng số do LevelManager kiểm tra (pack không biết các bảng đó).
+    bool loadRecord(int index, LevelRecord& record, std::vector<LevelEvent>& events) const;
+
+private:
+    bool attach(const char* data, size_t size, const char* source);
+
+    MappedFile file;
+    const char* base;
+    const LevelIndexEntry* entries;
+    Uint32 count;
+    std::string packTitle;
+};
+
+#endif // LEVEL_PACK_H_INCLUDED
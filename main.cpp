@@ -1,8 +1,33 @@
 #include "game.h"
+#include "collision_kernels.h"
+#include "collision_mask.h"
+#include "ecs.h"
+#include "soak_test.h"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
 
 int main(int argc, char* argv[]) {
+    bool stats = false;
+    // --selftest: so kernel va chạm SIMD, mask từng pixel và kho thực thể với bản tham chiếu rồi thoát
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--selftest") == 0) {
+            bool kernelsOk = runCollisionSelfTest(2000);
+            bool masksOk = runCollisionMaskSelfTest(2000);
+            bool entitiesOk = runEntitySelfTest(200000);
+            return kernelsOk && masksOk && entitiesOk ? 0 : 1;
+        }
+        // --soak [giờ]: chạy endless không cửa sổ (mặc định 24 giờ game) rồi thoát
+        if (std::strcmp(argv[i], "--soak") == 0) {
+            double hours = i + 1 < argc ? std::atof(argv[i + 1]) : 0.0;
+            return runSoakTest(hours > 0.0 ? hours : 24.0) ? 0 : 1;
+        }
+        // --stats: in thống kê timer, sự kiện, âm thanh và thực thể khi thoát
+        if (std::strcmp(argv[i], "--stats") == 0) stats = true;
+    }
+
     Game game;
+    game.setStatsLog(stats);
 
     if (!game.initialize()) {
         std::cerr << "Failed to initialize game!" << std::endl;
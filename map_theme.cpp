@@ -134,6 +134,7 @@ void EnvironmentParticle::render(SDL_Renderer* renderer) {
 bool EnvironmentParticle::isDead() const { return lifetime <= 0; }
 
 MapTheme::MapTheme(MapThemeType themeType) : type(themeType), particleSpawnTimer(0) {
+    particles.reserve(MAX_PARTICLES);
     setupTheme();
 }
 
@@ -199,6 +200,7 @@ void MapTheme::update(int screenWidth, int screenHeight, const DayNightCycle& da
 }
 
 void MapTheme::spawnParticles(int screenWidth, int screenHeight, const DayNightCycle& dayNight) {
+    if ((int)particles.size() >= MAX_PARTICLES) return;
     switch (type) {
         case GRASSLAND:
             // Butterflies or leaves
@@ -315,6 +317,19 @@ int MapTheme::getParticleSpawnInterval() const {
     }
 }
 
+// Nhạc riêng của theme, ban đêm có bản riêng. File tuỳ chọn: thiếu thì Game dùng bản ngày / nhạc mặc định
+std::string MapTheme::getMusicPath(bool night) const {
+    const char* track = "grassland";
+    switch (type) {
+        case GRASSLAND: track = "grassland"; break;
+        case DESERT: track = "desert"; break;
+        case FOREST: track = "forest"; break;
+        case MOUNTAIN: track = "mountain"; break;
+        case VOLCANO: track = "volcano"; break;
+    }
+    return std::string("sound/music_") + track + (night ? "_night" : "") + ".ogg";
+}
+
 void MapTheme::renderBackground(SDL_Renderer* renderer, int screenWidth, int screenHeight,
                          const DayNightCycle& dayNight) {
     // Sky gradient
@@ -32,12 +32,16 @@ private:
     int particleSpawnTimer;
 
 public:
+    // Trần số particle: vector cấp phát một lần, chơi lâu không phình thêm
+    static const int MAX_PARTICLES = 256;
+
     MapTheme(MapThemeType themeType = GRASSLAND);
     void setupTheme();
     void setTheme(MapThemeType newType);
     void update(int screenWidth, int screenHeight, const DayNightCycle& dayNight);
     void spawnParticles(int screenWidth, int screenHeight, const DayNightCycle& dayNight);
     int getParticleSpawnInterval() const;
+    std::string getMusicPath(bool night) const;
     void renderBackground(SDL_Renderer* renderer, int screenWidth, int screenHeight,
                          const DayNightCycle& dayNight);
     void renderStars(SDL_Renderer* renderer, int screenWidth, int screenHeight,
@@ -52,6 +56,7 @@ public:
 
     std::string getName() const { return name; }
     MapThemeType getType() const { return type; }
+    int getParticleCount() const { return (int)particles.size(); }
     SDL_Color getGroundColor() const { return groundColor; }
     SDL_Color getAccentColor() const { return accentColor; }
 
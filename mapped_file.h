@@ -0,0 +1,31 @@
+#ifndef MAPPED_FILE_H_INCLUDED
+#define MAPPED_FILE_H_INCLUDED
+
+#include <string>
+#include <cstddef>
+
+// File chỉ đọc được map thẳng vào bộ nhớ (mmap / MapViewOfFile).
+// Con trỏ data() hợp lệ cho tới khi close() hoặc object bị huỷ.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const char* base;
+    size_t length;
+    void* fileHandle;     // HANDLE trên Windows
+    void* mappingHandle;  // HANDLE của file mapping trên Windows
+};
+
+#endif // MAPPED_FILE_H_INCLUDED
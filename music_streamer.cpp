@@ -0,0 +1,422 @@
+#include "music_streamer.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include "wav_pcm.h"
+
+static const float CROSSFADE_SECONDS = 2.0f;
+
+// ===================== MUSIC STREAMER IMPLEMENTATION =====================
+
+MusicStreamer::MusicStreamer()
+    : loader(nullptr), decodeThread(nullptr), feedThread(nullptr),
+      mutex(nullptr), decodeWake(nullptr), stopping(false), running(false),
+      desiredTrack(-1), fadeFrames(0), fadeLength(0), framesRendered(0),
+      ring(nullptr), sampleRate(0), channels(0), framesPlayed(0) {
+    current.track = -1;
+    current.position = 0;
+    fading = current;
+    audible[0].track = audible[1].track = -1;
+    audible[0].startFrame = audible[1].startFrame = 0;
+    SDL_AtomicSet(&paused, 1);
+    SDL_AtomicSet(&playedSequence, 0);
+    SDL_AtomicSet(&playedLow, 0);
+    SDL_AtomicSet(&playedHigh, 0);
+    SDL_AtomicSet(&underruns, 0);
+    SDL_AtomicSet(&crossfades, 0);
+}
+
+MusicStreamer::~MusicStreamer() {
+    stop();
+}
+
+bool MusicStreamer::start(AssetLoader* assetLoader) {
+    if (running) return true;
+
+    int frequency, deviceChannels;
+    Uint16 format;
+    if (!Mix_QuerySpec(&frequency, &format, &deviceChannels) || format != AUDIO_S16SYS) {
+        std::cerr << "MusicStreamer: unsupported audio device, falling back to Mix_Music" << std::endl;
+        return false;
+    }
+
+    mutex = SDL_CreateMutex();
+    decodeWake = SDL_CreateCond();
+    if (!mutex || !decodeWake) {
+        std::cerr << "MusicStreamer: " << SDL_GetError() << std::endl;
+        stop();
+        return false;
+    }
+
+    loader = assetLoader;
+    sampleRate = frequency;
+    channels = deviceChannels;
+    ring = new SpscRing<Sint16, RING_SAMPLES>();
+    feedBuffer.assign(FEED_FRAMES * channels, 0);
+    deckBuffer.assign(FEED_FRAMES * channels, 0);
+    tracks.reserve(16);
+    stopping = false;
+
+    decodeThread = SDL_CreateThread(decodeMain, "MusicDecode", this);
+    feedThread = SDL_CreateThread(feedMain, "MusicFeed", this);
+    if (!decodeThread || !feedThread) {
+        std::cerr << "MusicStreamer: SDL_CreateThread Error: " << SDL_GetError() << std::endl;
+        stop();
+        return false;
+    }
+
+    Mix_HookMusic(hookMusic, this);
+    running = true;
+    return true;
+}
+
+void MusicStreamer::stop() {
+    if (running) Mix_HookMusic(nullptr, nullptr);  // Callback đã dừng khi hàm này trả về
+    running = false;
+
+    if (mutex) {
+        SDL_LockMutex(mutex);
+        stopping = true;
+        SDL_CondBroadcast(decodeWake);
+        SDL_UnlockMutex(mutex);
+    }
+    if (decodeThread) { SDL_WaitThread(decodeThread, nullptr); decodeThread = nullptr; }
+    if (feedThread) { SDL_WaitThread(feedThread, nullptr); feedThread = nullptr; }
+
+    for (Track& track : tracks) releaseTrack(track);
+    tracks.clear();
+    desiredTrack = -1;
+    current.track = fading.track = -1;
+    audible[0].track = audible[1].track = -1;
+
+    delete ring;
+    ring = nullptr;
+    if (decodeWake) { SDL_DestroyCond(decodeWake); decodeWake = nullptr; }
+    if (mutex) { SDL_DestroyMutex(mutex); mutex = nullptr; }
+}
+
+int MusicStreamer::findTrack(const std::string& path) const {
+    for (size_t i = 0; i < tracks.size(); i++) {
+        if (tracks[i].path == path) return (int)i;
+    }
+    return -1;
+}
+
+void MusicStreamer::play(const std::string& path) {
+    if (!running) return;
+
+    SDL_LockMutex(mutex);
+    int index = findTrack(path);
+    if (index < 0) {
+        Track track;
+        track.path = path;
+        track.state = TRACK_EMPTY;
+        track.stream = Source();
+        track.pcm = nullptr;
+        tracks.push_back(std::move(track));
+        index = (int)tracks.size() - 1;
+    }
+    desiredTrack = index;
+    bool needLoad = tracks[index].state == TRACK_EMPTY;
+    if (needLoad) tracks[index].state = TRACK_LOADING;
+    SDL_UnlockMutex(mutex);
+
+    if (needLoad) {
+        loader->requestBytes(path, [this, index](AssetBlob& blob) { onTrackLoaded(index, blob); });
+    }
+}
+
+void MusicStreamer::onTrackLoaded(int index, AssetBlob& blob) {
+    SDL_LockMutex(mutex);
+    Track& track = tracks[index];
+    if (blob.empty()) {
+        track.state = TRACK_FAILED;
+        std::cerr << "MusicStreamer: cannot read " << track.path << std::endl;
+    } else {
+        track.source = std::move(blob);
+        track.state = TRACK_DECODING;
+        SDL_CondSignal(decodeWake);
+    }
+    SDL_UnlockMutex(mutex);
+}
+
+void MusicStreamer::setPaused(bool pause) {
+    SDL_AtomicSet(&paused, pause ? 1 : 0);
+}
+
+int MusicStreamer::decodeMain(void* data) {
+    static_cast<MusicStreamer*>(data)->decodeLoop();
+    return 0;
+}
+
+int MusicStreamer::feedMain(void* data) {
+    static_cast<MusicStreamer*>(data)->feedLoop();
+    return 0;
+}
+
+void MusicStreamer::decodeLoop() {
+    SDL_LockMutex(mutex);
+    while (!stopping) {
+        int job = -1;
+        for (size_t i = 0; i < tracks.size(); i++) {
+            if (tracks[i].state == TRACK_DECODING) { job = (int)i; break; }
+        }
+        if (job < 0) {
+            SDL_CondWait(decodeWake, mutex);
+            continue;
+        }
+
+        // Buffer của AssetBlob không đổi chỗ khi vector tracks cấp phát lại
+        const char* data = tracks[job].source.data;
+        size_t size = tracks[job].source.size;
+        SDL_UnlockMutex(mutex);
+
+        Uint32 startTick = SDL_GetTicks();
+        Source src = Source();
+        Mix_Chunk* pcm = nullptr;
+        bool streamed = openWav(data, size, src);
+        if (!streamed) {
+            pcm = Mix_LoadWAV_RW(SDL_RWFromConstMem(data, (int)size), 1);
+            if (pcm) {
+                src.frames = reinterpret_cast<const Sint16*>(pcm->abuf);
+                src.frameCount = pcm->alen / (Uint32)(sizeof(Sint16) * channels);
+                src.channels = channels;
+            }
+        }
+        Uint32 elapsed = SDL_GetTicks() - startTick;
+
+        SDL_LockMutex(mutex);
+        Track& track = tracks[job];
+        if (!streamed) track.source.clear();
+        if (src.frames) {
+            track.stream = src;
+            track.pcm = pcm;
+            track.state = TRACK_READY;
+            std::cout << "Music: " << (streamed ? "streaming " : "decoded ") << track.path
+                      << " in " << elapsed << " ms" << std::endl;
+        } else {
+            track.state = TRACK_FAILED;
+            std::cerr << "MusicStreamer: cannot decode " << track.path << ": " << Mix_GetError() << std::endl;
+        }
+    }
+    SDL_UnlockMutex(mutex);
+}
+
+// WAV PCM 16-bit phát thẳng từ blob, chỉ cần converter khi khác định dạng thiết bị
+bool MusicStreamer::openWav(const char* data, size_t size, Source& src) const {
+    const char* samples = nullptr;
+    Uint32 bytes = 0;
+    int rate = 0, wavChannels = 0;
+    if (!findWavPcm16(data, size, samples, bytes, rate, wavChannels)) return false;
+
+    src.frames = reinterpret_cast<const Sint16*>(samples);
+    src.frameCount = bytes / (Uint32)(sizeof(Sint16) * wavChannels);
+    src.channels = wavChannels;
+    src.converter = nullptr;
+    if (AUDIO_S16LSB != AUDIO_S16SYS || rate != sampleRate || wavChannels != channels) {
+        src.converter = SDL_NewAudioStream(AUDIO_S16LSB, (Uint8)wavChannels, rate,
+                                           AUDIO_S16SYS, (Uint8)channels, sampleRate);
+        if (!src.converter) {
+            std::cerr << "MusicStreamer: SDL_NewAudioStream Error: " << SDL_GetError() << std::endl;
+            src = Source();
+            return false;
+        }
+    }
+    return true;
+}
+
+void MusicStreamer::releaseTrack(Track& track) {
+    if (track.stream.converter) SDL_FreeAudioStream(track.stream.converter);
+    if (track.pcm) Mix_FreeChunk(track.pcm);
+    track.stream = Source();
+    track.pcm = nullptr;
+    track.source.clear();
+}
+
+// Bỏ nguồn của bài không còn dùng (không phát, không fade, không chờ phát)
+void MusicStreamer::releaseUnused() {
+    for (size_t i = 0; i < tracks.size(); i++) {
+        int index = (int)i;
+        Track& track = tracks[i];
+        if (track.state != TRACK_READY || index == current.track || index == fading.track || index == desiredTrack) {
+            continue;
+        }
+        releaseTrack(track);
+        track.state = TRACK_EMPTY;
+    }
+}
+
+void MusicStreamer::feedLoop() {
+    for (;;) {
+        SDL_LockMutex(mutex);
+        if (stopping) {
+            SDL_UnlockMutex(mutex);
+            break;
+        }
+
+        // Chỉ bắt đầu crossfade mới khi lần trước đã xong
+        if (fading.track < 0 && desiredTrack >= 0 && desiredTrack != current.track &&
+            tracks[desiredTrack].state == TRACK_READY) {
+            fading = current;
+            current.track = desiredTrack;
+            current.position = 0;
+            if (tracks[desiredTrack].stream.converter) SDL_AudioStreamClear(tracks[desiredTrack].stream.converter);
+            fadeFrames = 0;
+            fadeLength = (fading.track >= 0) ? (int)(CROSSFADE_SECONDS * sampleRate) : 0;
+            if (fading.track >= 0) SDL_AtomicAdd(&crossfades, 1);
+
+            audible[1] = audible[0];
+            audible[0].track = current.track;
+            audible[0].startFrame = framesRendered;
+            releaseUnused();
+        }
+        Source currentSrc = (current.track >= 0) ? tracks[current.track].stream : Source();
+        Source fadingSrc = (fading.track >= 0) ? tracks[fading.track].stream : Source();
+        SDL_UnlockMutex(mutex);
+
+        int freeFrames = (ring->capacity() - ring->size()) / channels;
+        if (!currentSrc.frames || freeFrames < FEED_FRAMES) {
+            SDL_Delay(5);
+            continue;
+        }
+
+        renderFrames(feedBuffer.data(), FEED_FRAMES, currentSrc, fadingSrc);
+        ring->write(feedBuffer.data(), FEED_FRAMES * channels);
+        framesRendered += FEED_FRAMES;
+
+        if (fading.track >= 0 && fadeFrames >= fadeLength) {
+            SDL_LockMutex(mutex);
+            fading.track = -1;
+            releaseUnused();
+            SDL_UnlockMutex(mutex);
+        }
+    }
+}
+
+void MusicStreamer::renderFrames(Sint16* out, int frames, const Source& currentSrc, const Source& fadingSrc) {
+    if (!fadingSrc.frames) {
+        mixDeck(current, currentSrc, out, frames, 1.0f, 1.0f, false);
+        return;
+    }
+
+    // Equal-power: cos/sin giữ tổng công suất không đổi trong lúc chuyển bài
+    const float halfPi = 0.5f * (float)M_PI;
+    float x0 = std::min(1.0f, (float)fadeFrames / fadeLength);
+    float x1 = std::min(1.0f, (float)(fadeFrames + frames) / fadeLength);
+    mixDeck(fading, fadingSrc, out, frames, cosf(x0 * halfPi), cosf(x1 * halfPi), false);
+    mixDeck(current, currentSrc, out, frames, sinf(x0 * halfPi), sinf(x1 * halfPi), true);
+    fadeFrames += frames;
+}
+
+// Lấy frames khung định dạng thiết bị từ deck. Bài lặp vô tận: hết nguồn
+// thì quay về đầu (converter nối liền nên chỗ lặp không bị hở)
+void MusicStreamer::readDeck(Deck& deck, const Source& src, Sint16* out, int frames) {
+    if (src.frameCount == 0) {
+        std::fill(out, out + frames * channels, 0);
+        return;
+    }
+
+    if (!src.converter) {
+        for (int done = 0; done < frames;) {
+            int count = (int)std::min<Uint32>((Uint32)(frames - done), src.frameCount - deck.position);
+            const Sint16* from = src.frames + (size_t)deck.position * channels;
+            std::copy(from, from + count * channels, out + done * channels);
+            done += count;
+            deck.position += count;
+            if (deck.position >= src.frameCount) deck.position = 0;
+        }
+        return;
+    }
+
+    int bytes = frames * channels * (int)sizeof(Sint16);
+    while (SDL_AudioStreamAvailable(src.converter) < bytes) {
+        int count = (int)std::min<Uint32>(FEED_FRAMES, src.frameCount - deck.position);
+        const Sint16* from = src.frames + (size_t)deck.position * src.channels;
+        if (SDL_AudioStreamPut(src.converter, from, count * src.channels * (int)sizeof(Sint16)) < 0) break;
+        deck.position += count;
+        if (deck.position >= src.frameCount) deck.position = 0;
+    }
+    int got = std::max(0, SDL_AudioStreamGet(src.converter, out, bytes)) / (int)sizeof(Sint16);
+    std::fill(out + got, out + frames * channels, 0);
+}
+
+void MusicStreamer::mixDeck(Deck& deck, const Source& src, Sint16* out, int frames,
+                            float gainStart, float gainEnd, bool add) {
+    Sint16* block = add ? deckBuffer.data() : out;
+    readDeck(deck, src, block, frames);
+    if (!add && gainStart == 1.0f && gainEnd == 1.0f) return;
+
+    float gainStep = (gainEnd - gainStart) / frames;
+    for (int f = 0; f < frames; f++) {
+        float gain = gainStart + gainStep * f;
+        for (int c = 0; c < channels; c++) {
+            int sample = (int)(block[f * channels + c] * gain);
+            if (add) sample += out[f * channels + c];
+            out[f * channels + c] = (Sint16)std::max(-32768, std::min(32767, sample));
+        }
+    }
+}
+
+void MusicStreamer::hookMusic(void* udata, Uint8* stream, int len) {
+    MusicStreamer* streamer = static_cast<MusicStreamer*>(udata);
+    if (SDL_AtomicGet(&streamer->paused)) return;  // stream đã là im lặng
+
+    int want = len / (int)sizeof(Sint16);
+    int got = streamer->ring->read(reinterpret_cast<Sint16*>(stream), want);
+    // Đã phát rồi mà ring cạn: thread feed không theo kịp
+    if (got < want && (got > 0 || streamer->framesPlayed != 0)) {
+        SDL_AtomicAdd(&streamer->underruns, 1);
+    }
+    if (got > 0) {
+        streamer->framesPlayed += got / streamer->channels;
+        streamer->publishFramesPlayed();
+    }
+}
+
+// Audio thread, người ghi duy nhất
+void MusicStreamer::publishFramesPlayed() {
+    SDL_AtomicAdd(&playedSequence, 1);
+    SDL_AtomicSet(&playedLow, (int)(Uint32)framesPlayed);
+    SDL_AtomicSet(&playedHigh, (int)(Uint32)(framesPlayed >> 32));
+    SDL_AtomicAdd(&playedSequence, 1);
+}
+
+Uint64 MusicStreamer::loadFramesPlayed() const {
+    SDL_atomic_t* sequence = const_cast<SDL_atomic_t*>(&playedSequence);
+    for (;;) {
+        int before = SDL_AtomicGet(sequence);
+        Uint32 low = (Uint32)SDL_AtomicGet(const_cast<SDL_atomic_t*>(&playedLow));
+        Uint32 high = (Uint32)SDL_AtomicGet(const_cast<SDL_atomic_t*>(&playedHigh));
+        if ((before & 1) == 0 && SDL_AtomicGet(sequence) == before) return ((Uint64)high << 32) | low;
+    }
+}
+
+const MusicStreamer::Audible& MusicStreamer::audibleAt(Uint64 played) const {
+    // Bài mới chỉ nghe thấy khi callback đọc tới khung bắt đầu của nó
+    if (audible[0].track >= 0 && played >= audible[0].startFrame) return audible[0];
+    return audible[1];
+}
+
+std::string MusicStreamer::getCurrentPath() const {
+    if (!running) return std::string();
+    SDL_LockMutex(mutex);
+    const Audible& now = audibleAt(loadFramesPlayed());
+    std::string path = (now.track >= 0) ? tracks[now.track].path : std::string();
+    SDL_UnlockMutex(mutex);
+    return path;
+}
+
+double MusicStreamer::getTrackTime() const {
+    if (!running) return 0.0;
+    SDL_LockMutex(mutex);
+    Uint64 played = loadFramesPlayed();
+    const Audible& now = audibleAt(played);
+    double seconds = (now.track >= 0 && played >= now.startFrame) ? (double)(played - now.startFrame) / sampleRate : 0.0;
+    SDL_UnlockMutex(mutex);
+    return seconds;
+}
+
+int MusicStreamer::getBufferedMs() const {
+    if (!running) return 0;
+    return (int)((Sint64)ring->size() / channels * 1000 / sampleRate);
+}
@@ -0,0 +1,131 @@
+#ifndef MUSIC_STREAMER_H_INCLUDED
+#define MUSIC_STREAMER_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <string>
+#include <vector>
+#include "asset_loader.h"
+#include "spsc_ring.h"
+
+// Nhạc nền phát qua Mix_HookMusic từ một ring buffer PCM:
+//  - thread decode: mở bài khi được yêu cầu, không chặn main loop như
+//    Mix_LoadMUS. WAV PCM 16-bit (asset_packer --pcm giải mã sẵn ogg/mp3
+//    thành dạng này) được đọc thẳng từ blob, thường là vùng pack đã mmap;
+//    định dạng nén khác thì đành giải mã cả bài bằng Mix_LoadWAV_RW
+//  - thread feed: mỗi lần lấy một block FEED_FRAMES từ deck hiện tại (và
+//    deck đang fade), đổi sang định dạng thiết bị nếu cần, trộn rồi đổ
+//    trước vào ring ~0.75 s; đổi bài bằng crossfade equal-power
+//  - audio callback chỉ copy từ ring, thiếu dữ liệu thì đếm underrun
+// Chỉ giữ nguồn của bài đang phát, bài đang fade và bài chờ phát.
+class MusicStreamer {
+public:
+    MusicStreamer();
+    ~MusicStreamer();
+
+    // Gọi sau Mix_OpenAudio. Chỉ hỗ trợ thiết bị AUDIO_S16SYS
+    bool start(AssetLoader* loader);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Main thread. Nạp (nếu cần) rồi crossfade sang bài này khi decode xong
+    void play(const std::string& path);
+    void setPaused(bool paused);
+
+    // Bài đang nghe và số giây đã nghe của nó (tăng qua các vòng lặp)
+    std::string getCurrentPath() const;
+    double getTrackTime() const;
+
+    int getUnderrunCount() const { return SDL_AtomicGet(const_cast<SDL_atomic_t*>(&underruns)); }
+    int getBufferedMs() const;
+    int getCrossfadeCount() const { return SDL_AtomicGet(const_cast<SDL_atomic_t*>(&crossfades)); }
+
+private:
+    enum TrackState { TRACK_EMPTY, TRACK_LOADING, TRACK_DECODING, TRACK_READY, TRACK_FAILED };
+
+    // PCM nguồn của một bài; thread feed chép ra dưới mutex rồi dùng ngoài lock
+    struct Source {
+        const Sint16* frames;        // Mẫu xen kẽ, trong blob WAV hoặc pcm->abuf
+        Uint32 frameCount;
+        int channels;
+        SDL_AudioStream* converter;  // nullptr nếu đã đúng định dạng thiết bị
+    };
+
+    struct Track {
+        std::string path;
+        TrackState state;
+        AssetBlob source;    // Byte file; WAV PCM giữ suốt lúc phát, còn lại bỏ sau decode
+        Source stream;
+        Mix_Chunk* pcm;      // Chỉ có khi phải giải mã cả bài
+    };
+
+    // Deck chỉ thread feed dùng
+    struct Deck {
+        int track;           // -1 nếu trống
+        Uint32 position;     // Khung nguồn kế tiếp
+    };
+
+    // Bài được nghe từ khung thứ startFrame (đếm theo callback)
+    struct Audible {
+        int track;
+        Uint64 startFrame;
+    };
+
+    static const int RING_SAMPLES = 1 << 16;  // ~0.75 s stereo 44.1 kHz
+    static const int FEED_FRAMES = 1024;
+
+    static int decodeMain(void* data);
+    static int feedMain(void* data);
+    static void hookMusic(void* udata, Uint8* stream, int len);
+
+    int findTrack(const std::string& path) const;
+    void onTrackLoaded(int track, AssetBlob& blob);
+    void decodeLoop();
+    void feedLoop();
+    bool openWav(const char* data, size_t size, Source& src) const;
+    void renderFrames(Sint16* out, int frames, const Source& currentSrc, const Source& fadingSrc);
+    void readDeck(Deck& deck, const Source& src, Sint16* out, int frames);
+    void mixDeck(Deck& deck, const Source& src, Sint16* out, int frames, float gainStart, float gainEnd, bool add);
+    void releaseTrack(Track& track);
+    void releaseUnused();
+    void publishFramesPlayed();
+    Uint64 loadFramesPlayed() const;
+    const Audible& audibleAt(Uint64 played) const;
+
+    AssetLoader* loader;
+    SDL_Thread* decodeThread;
+    SDL_Thread* feedThread;
+    SDL_mutex* mutex;
+    SDL_cond* decodeWake;
+    bool stopping;
+    bool running;
+
+    std::vector<Track> tracks;   // Theo mutex
+    int desiredTrack;            // Theo mutex
+    Audible audible[2];          // Theo mutex: [0] mới nhất, [1] trước đó
+
+    // Thread feed
+    Deck current;
+    Deck fading;
+    int fadeFrames;              // Đã fade bao nhiêu khung
+    int fadeLength;
+    Uint64 framesRendered;
+    std::vector<Sint16> feedBuffer;
+    std::vector<Sint16> deckBuffer;
+
+    SpscRing<Sint16, RING_SAMPLES>* ring;
+    int sampleRate;
+    int channels;
+    SDL_atomic_t paused;
+    // Số khung đã phát, 64-bit để không quay vòng khi chạy nhiều giờ.
+    // Chỉ audio callback ghi framesPlayed; bản công khai đọc qua seqlock
+    // (playedSequence lẻ khi đang ghi playedLow/playedHigh)
+    Uint64 framesPlayed;
+    SDL_atomic_t playedSequence;
+    SDL_atomic_t playedLow;
+    SDL_atomic_t playedHigh;
+    SDL_atomic_t underruns;
+    SDL_atomic_t crossfades;
+};
+
+#endif // MUSIC_STREAMER_H_INCLUDED
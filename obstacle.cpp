@@ -1,125 +1,68 @@
 #include "obstacle.h"
+#include "entity_tables.h"
 #include <iostream>
 
 
-Obstacle::Obstacle(int startX, int groundY, int obstacleSpeed, ObstacleType obsType) {
-    speed = obstacleSpeed;
-    active = true;
-    type = obsType;
-    rotation = 0;
-    rotationSpeed = 5.0f + (rand() % 10);
-    trailTimer = 0;
-    variant = rand() % 3; // 3 biến thể cho mỗi loại
+void Obstacle::spawn(Archetype& arch, int row, int groundY, const ObstacleSpec& spec, float drift) {
+    const ObstacleParams& p = OBSTACLE_TYPES[spec.type];
+    float y, vy = 0.0f;
+    if (p.laneCount > 0) {
+        y = (float)(groundY - spec.lift);
+    } else {
+        y = (float)spec.skyY;
+        vy = (float)spec.fallSpeed;
+    }
 
-    setupObstacle(startX, groundY);
+    arch.y(row) = y;
+    arch.vx(row) = drift;
+    arch.vy(row) = vy;
+    arch.width(row) = (Sint16)spec.width;
+    arch.height(row) = (Sint16)spec.height;
+    arch.kind(row) = (Uint8)spec.type;
+    arch.variant(row) = (Uint8)spec.variant;
+    arch.flags(row) = ENTITY_ALIVE | p.flags;
 }
 
-void Obstacle::setupObstacle(int startX, int groundY) {
-    x = startX;
+// Hitbox là thân chính; mask chỉ bỏ đi phần trống bên trong hitbox (khoảng
+// giữa các cây xương rồng, phía trên thân chim) nên không bao giờ chết oan hơn.
+// Loại không có hàm bake (xương rồng đơn, thiên thạch, đá) lấp đầy hitbox.
+void Obstacle::bakeShape(CollisionMask& shape, ObstacleType type, int width, int height, int variant) {
+    typedef void (*BakeFn)(CollisionMask&, int, int, int);
+    static const BakeFn bakers[OBSTACLE_TYPE_COUNT] = {
+        nullptr, nullptr, nullptr, &Obstacle::bakeCactusGroup, &Obstacle::bakeBird, nullptr, nullptr
+    };
+    if (bakers[type]) bakers[type](shape, width, height, variant);
+    else shape.reset(0, 0);   // Giữ bộ nhớ cho lần dùng lại
+}
 
-    switch (type) {
-        case CACTUS_SMALL: {
-            width = 15 + (rand() % 10);
-            height = 40 + (rand() % 20);
-            y = groundY;
-            vy = 0;
-            break;
-        }
-        case CACTUS_MEDIUM: {
-            width = 20 + (rand() % 15);
-            height = 60 + (rand() % 25);
-            y = groundY;
-            vy = 0;
-            break;
-        }
-        case CACTUS_LARGE: {
-            width = 25 + (rand() % 20);
-            height = 80 + (rand() % 30);
-            y = groundY;
-            vy = 0;
-            break;
-        }
-        case CACTUS_GROUP: {
-            width = 50 + (rand() % 30);
-            height = 60 + (rand() % 40);
-            y = groundY;
-            vy = 0;
-            break;
-        }
-        case BIRD: {
-            width = 35 + (rand() % 20);
-            height = 25 + (rand() % 15);
-            vy = 0;
-            // Chim bay ở các độ cao khác nhau
-            int heightLevel = rand() % 4;
-            if (heightLevel == 0) y = groundY - 60;
-            else if (heightLevel == 1) y = groundY - 100;
-            else if (heightLevel == 2) y = groundY - 140;
-            else y = groundY - 180;
-            break;
-        }
-        case METEOR: {
-            width = 30 + (rand() % 25);
-            height = 30 + (rand() % 25);
-            y = -50 - (rand() % 100);
-            vy = 3.0f + (rand() % 4);
-            break;
-        }
-        case ROCK: {
-            width = 25 + (rand() % 20);
-            height = 20 + (rand() % 15);
-            y = groundY;
-            vy = 0;
-            break;
-        }
+void Obstacle::bakeCactusGroup(CollisionMask& shape, int width, int height, int variant) {
+    int numCacti = 2 + (variant % 2);
+    shape.reset(width, height);
+    for (int i = 0; i < numCacti; i++) {
+        shape.fillRect(i * (width / numCacti), 0, width / numCacti - 5, height);
     }
 }
 
-void Obstacle::update() {
-    if (type == METEOR) {
-        y += vy;
-        x -= speed / 2;
-        rotation += rotationSpeed;
-        trailTimer++;
-        if (vy < 12) vy += 0.1f;
-        if (y > 500 || x + width < 0) active = false;
-    } else if (type == BIRD) {
-        // Chim bay lượn
-        x -= speed;
-        y += sin(trailTimer * 0.1f) * 2;
-        trailTimer++;
-        if (x + width < 0) active = false;
-    } else {
-        x -= speed;
-        if (x + width < 0) active = false;
-    }
+void Obstacle::bakeBird(CollisionMask& shape, int width, int height, int) {
+    shape.reset(width, height);
+    shape.fillRect(0, height / 2, width, height - height / 2);   // Thân
+    shape.fillRect(width - 10, 0, 15, 15);                      // Đầu
+    shape.fillRect(5, height / 2 - 15, width - 10, 18);         // Cánh ở mọi pha vỗ
 }
 
-void Obstacle::render(SDL_Renderer* renderer) {
-    if (!active) return;
-
-    switch (type) {
-        case CACTUS_SMALL:
-        case CACTUS_MEDIUM:
-        case CACTUS_LARGE:
-            renderCactus(renderer);
-            break;
-        case CACTUS_GROUP:
-            renderCactusGroup(renderer);
-            break;
-        case BIRD:
-            renderBird(renderer);
-            break;
-        case METEOR:
-            renderMeteor(renderer);
-            break;
-        case ROCK:
-            renderRock(renderer);
-            break;
-    }
+void Obstacle::render(SDL_Renderer* renderer, const RenderItem& item) {
+    typedef void (*RenderFn)(SDL_Renderer*, const RenderItem&);
+    static const RenderFn renderers[OBSTACLE_TYPE_COUNT] = {
+        &Obstacle::renderCactus, &Obstacle::renderCactus, &Obstacle::renderCactus,
+        &Obstacle::renderCactusGroup, &Obstacle::renderBird, &Obstacle::renderMeteor, &Obstacle::renderRock
+    };
+    renderers[item.kind](renderer, item);
 }
 
-void Obstacle::renderCactus(SDL_Renderer* renderer) {
+void Obstacle::renderCactus(SDL_Renderer* renderer, const RenderItem& item) {
+    int x = item.x, y = item.y, width = item.width, height = item.height;
+    ObstacleType type = (ObstacleType)item.kind;
+    int variant = item.variant;
     // Màu xương rồng - gradient từ xanh đậm đến xanh nhạt
     SDL_Color cactusDark = {50, 120, 50, 255};
     SDL_Color cactusMedium = {70, 150, 70, 255};
@@ -238,7 +181,9 @@ void Obstacle::renderCactus(SDL_Renderer* renderer) {
     SDL_RenderDrawLine(renderer, x + 1, y - height + 1, x + 1, y - 1); // Cạnh trái
 }
 
-void Obstacle::renderCactusGroup(SDL_Renderer* renderer) {
+void Obstacle::renderCactusGroup(SDL_Renderer* renderer, const RenderItem& item) {
+    int x = item.x, y = item.y, width = item.width, height = item.height;
+    int variant = item.variant;
     SDL_Color cactusColor = {60, 140, 60, 255};
 
     int numCacti = 2 + (variant % 2); // 2 hoặc 3 cây
@@ -265,7 +210,9 @@ void Obstacle::renderCactusGroup(SDL_Renderer* renderer) {
     }
 }
 
-void Obstacle::renderBird(SDL_Renderer* renderer) {
+void Obstacle::renderBird(SDL_Renderer* renderer, const RenderItem& item) {
+    int x = item.x, y = item.y, width = item.width, height = item.height;
+    int variant = item.variant;
     SDL_Color birdColor;
 
     switch (variant) {
@@ -281,7 +228,7 @@ void Obstacle::renderBird(SDL_Renderer* renderer) {
     SDL_Rect head = { x + width - 10, y - height, 15, 15 };
     SDL_RenderFillRect(renderer, &head);
 
-    int wingOffset = (int)(sin(trailTimer * 0.2f) * 5);
+    int wingOffset = (int)(lutSin(item.age * 0.2f) * 5);
     SDL_Rect wing = { x + 5, y - height/2 - 10 + wingOffset, width - 10, 8 };
     SDL_SetRenderDrawColor(renderer, birdColor.r * 0.7f, birdColor.g * 0.7f, birdColor.b * 0.7f, 255);
     SDL_RenderFillRect(renderer, &wing);
@@ -290,8 +237,9 @@ void Obstacle::renderBird(SDL_Renderer* renderer) {
     SDL_RenderDrawPoint(renderer, x + width - 3, y - height + 5);
 }
 
-void Obstacle::renderMeteor(SDL_Renderer* renderer) {
-    if (trailTimer % 2 == 0) {
+void Obstacle::renderMeteor(SDL_Renderer* renderer, const RenderItem& item) {
+    int x = item.x, y = item.y, width = item.width, height = item.height;
+    if ((int)item.age % 2 == 0) {
         for (int i = 1; i <= 4; i++) {
             int alpha = 255 - (i * 50);
             int size = 20 - (i * 3);
@@ -325,7 +273,8 @@ void Obstacle::renderMeteor(SDL_Renderer* renderer) {
     SDL_RenderDrawRect(renderer, &meteor);
 }
 
-void Obstacle::renderRock(SDL_Renderer* renderer) {
+void Obstacle::renderRock(SDL_Renderer* renderer, const RenderItem& item) {
+    int x = item.x, y = item.y, width = item.width, height = item.height;
     SDL_Color rockColor = {120, 120, 120, 255};
     SDL_Color highlightColor = {150, 150, 150, 255};
     SDL_Color shadowColor = {80, 80, 80, 255};
@@ -356,31 +305,3 @@ void Obstacle::renderRock(SDL_Renderer* renderer) {
     SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
     SDL_RenderDrawRect(renderer, &rock);
 }
-
-bool Obstacle::checkCollision(int px, int py, int pwidth, int pheight) {
-    if (!active) return false;
-    SDL_Rect a{ px, py - pheight, pwidth, pheight };
-    SDL_Rect b{ x, y - height, width, height };
-    return SDL_HasIntersection(&a, &b);
-}
-
-void Obstacle::drawCircle(SDL_Renderer* renderer, int cx, int cy, int radius) {
-    for (int dy = -radius; dy <= radius; dy++) {
-        for (int dx = -radius; dx <= radius; dx++) {
-            if (dx*dx + dy*dy <= radius*radius) {
-                SDL_RenderDrawPoint(renderer, cx + dx, cy + dy);
-            }
-        }
-    }
-}
-
-void Obstacle::fillCircle(SDL_Renderer* renderer, int cx, int cy, int radius) {
-    for (int y = -radius; y <= radius; y++) {
-        for (int x = -radius; x <= radius; x++) {
-            if (x*x + y*y <= radius*radius) {
-                SDL_RenderDrawPoint(renderer, cx + x, cy + y);
-            }
-        }
-    }
-}
-
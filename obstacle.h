@@ -7,6 +7,9 @@
 #include <ctime>
 #include <algorithm>
 #include <cmath>
+#include "world_scroll.h"
+#include "collision_mask.h"
+#include "ecs.h"
 // Loại chướng ngại vật
 enum ObstacleType {
     CACTUS_SMALL,      // Xương rồng nhỏ
@@ -15,42 +18,49 @@ enum ObstacleType {
     CACTUS_GROUP,      // Nhóm xương rồng
     BIRD,              // Chim bay
     METEOR,            // Thiên thạch
-    ROCK               // Đá
+    ROCK,              // Đá
+    OBSTACLE_TYPE_COUNT
 };
 
-class Obstacle {
-public:
-    int x, y;
-    int width, height;
-    int speed;
-    bool active;
-    ObstacleType type;
+// Trọng số sinh theo ObstacleType (mặc định lấy từ OBSTACLE_TYPES; level có thể thay)
+struct ObstacleWeights {
+    int weights[OBSTACLE_TYPE_COUNT];
+};
 
-    // Cho thiên thạch và hiệu ứng
-    float vy;
-    float rotation;
-    float rotationSpeed;
-    int trailTimer;
-    int variant; // Biến thể của cùng loại vật cản
+// Kích thước và làn đã chọn của một vật cản (rollObstacleSpec hoặc LevelGenerator)
+struct ObstacleSpec {
+    ObstacleType type;
+    int width, height;
+    int lift;        // Đáy cao hơn mặt đất
+    int variant;
+    int skyY, fallSpeed;   // Chỉ loại rơi (laneCount 0): y đáy lúc sinh, vận tốc rơi ban đầu
+};
 
-    // Constructor
-    Obstacle(int startX, int groundY, int obstacleSpeed, ObstacleType obsType = CACTUS_SMALL);
+// Vật cản là hàng trong archetype ARCH_OBSTACLE của EntityRegistry; lớp này
+// chỉ giữ luật sinh, hình dạng và cách vẽ theo loại (kind = ObstacleType).
+// Kích thước, làn và trọng số sinh nằm trong OBSTACLE_TYPES (entity_tables.h).
+class Obstacle {
+public:
+    // Shape lớn nhất bakeShape() tạo ra (nhóm xương rồng); ObstacleManager giữ sẵn chừng này
+    static const int MAX_SHAPE_WIDTH = 80;
+    static const int MAX_SHAPE_HEIGHT = 100;
 
-    // Public methods
-    void update();
-    void render(SDL_Renderer* renderer);
-    bool checkCollision(int px, int py, int pwidth, int pheight);
+    // Ghi component cho hàng vừa tạo; drift là vận tốc riêng trong thế giới.
+    // Loại không có làn (thiên thạch) sinh trên trời, bỏ qua spec.lift
+    static void spawn(Archetype& arch, int row, int groundY, const ObstacleSpec& spec, float drift = 0.0f);
+    // Hình dạng thật trong hitbox; rỗng = đặc cả hitbox
+    static void bakeShape(CollisionMask& shape, ObstacleType type, int width, int height, int variant);
+    static void render(SDL_Renderer* renderer, const RenderItem& item);
 
 private:
-    // Private helper methods
-    void setupObstacle(int startX, int groundY);
-    void renderCactus(SDL_Renderer* renderer);
-    void renderCactusGroup(SDL_Renderer* renderer);
-    void renderBird(SDL_Renderer* renderer);
-    void renderMeteor(SDL_Renderer* renderer);
-    void renderRock(SDL_Renderer* renderer);
-    void drawCircle(SDL_Renderer* renderer, int cx, int cy, int radius);
-    void fillCircle(SDL_Renderer* renderer, int cx, int cy, int radius);
+    static void bakeCactusGroup(CollisionMask& shape, int width, int height, int variant);
+    static void bakeBird(CollisionMask& shape, int width, int height, int variant);
+
+    static void renderCactus(SDL_Renderer* renderer, const RenderItem& item);
+    static void renderCactusGroup(SDL_Renderer* renderer, const RenderItem& item);
+    static void renderBird(SDL_Renderer* renderer, const RenderItem& item);
+    static void renderMeteor(SDL_Renderer* renderer, const RenderItem& item);
+    static void renderRock(SDL_Renderer* renderer, const RenderItem& item);
 };
 
 
@@ -2,6 +2,8 @@
 #define PLAYER_H_INCLUDED
 
 struct Player {
+    static constexpr float JUMP_VELOCITY = -12.0f;   // vy lúc bắt đầu nhảy
+
     int x, y;
     float width, height;
     int vx;           // Vận tốc ngang
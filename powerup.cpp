@@ -3,53 +3,32 @@
 
 // ===================== POWERUP CLASS IMPLEMENTATION =====================
 
-PowerUp::PowerUp(int startX, int groundY, int gameSpeed, PowerUpType puType) {
-    x = startX;
-    speed = gameSpeed;
-    type = puType;
-    active = true;
-    collected = false;
-    width = 30;
-    height = 30;
-    animFrame = 0.0f;
-    y = groundY - 80 - (rand() % 50); // Vị trí ngẫu nhiên trên không
+void PowerUp::spawn(Archetype& arch, int row, int groundY, PowerUpType type, int lift) {
+    arch.y(row) = (float)(groundY - lift);
+    arch.width(row) = SIZE;
+    arch.height(row) = SIZE;
+    arch.kind(row) = (Uint8)type;
+    arch.flags(row) = ENTITY_ALIVE | ENTITY_COLLECTIBLE;
 }
 
-void PowerUp::update() {
-    x -= speed;
-    animFrame += 0.1f; // Cập nhật animation
-    if (x + width < 0) {
-        active = false;
-    }
-}
-
-void PowerUp::render(SDL_Renderer* renderer) {
-    if (active && !collected) {
-        // Hiệu ứng floating
-        float floatOffset = sin(animFrame) * 3.0f;
-        int currentY = y + (int)floatOffset;
-
-        SDL_Rect rect = { x, currentY - height, width, height };
-
-        // Màu sắc và hiệu ứng dựa trên loại power-up
-        switch (type) {
-            case PowerUpType::SHIELD:
-                renderShieldEffect(renderer, rect);
-                break;
-            case PowerUpType::SPEED_BOOST:
-                renderSpeedBoostEffect(renderer, rect);
-                break;
-            case PowerUpType::COIN_MAGNET:
-                renderCoinMagnetEffect(renderer, rect);
-                break;
-            case PowerUpType::DASH:
-                renderDashEffect(renderer, rect);
-                break;
-        }
-    }
+void PowerUp::render(SDL_Renderer* renderer, const RenderItem& item) {
+    // Hiệu ứng floating; animFrame tăng 0.1 mỗi frame
+    float animFrame = item.age * 0.1f;
+    float floatOffset = lutSin(animFrame) * 3.0f;
+    int currentY = item.y + (int)floatOffset;
+
+    SDL_Rect rect = { item.x, currentY - item.height, item.width, item.height };
+
+    // Màu sắc và hiệu ứng dựa trên loại power-up
+    typedef void (*EffectFn)(SDL_Renderer*, const SDL_Rect&, float);
+    static const EffectFn effects[(int)PowerUpType::COUNT] = {
+        &PowerUp::renderShieldEffect, &PowerUp::renderSpeedBoostEffect,
+        &PowerUp::renderCoinMagnetEffect, &PowerUp::renderDashEffect
+    };
+    effects[item.kind](renderer, rect, animFrame);
 }
 
-void PowerUp::renderShieldEffect(SDL_Renderer* renderer, const SDL_Rect& rect) {
+void PowerUp::renderShieldEffect(SDL_Renderer* renderer, const SDL_Rect& rect, float) {
     SDL_SetRenderDrawColor(renderer, 0, 150, 255, 180);
     SDL_RenderFillRect(renderer, &rect);
     SDL_SetRenderDrawColor(renderer, 100, 200, 255, 255);
@@ -59,7 +38,7 @@ void PowerUp::renderShieldEffect(SDL_Renderer* renderer, const SDL_Rect& rect) {
     SDL_RenderFillRect(renderer, &inner);
 }
 
-void PowerUp::renderSpeedBoostEffect(SDL_Renderer* renderer, const SDL_Rect& rect) {
+void PowerUp::renderSpeedBoostEffect(SDL_Renderer* renderer, const SDL_Rect& rect, float) {
     SDL_SetRenderDrawColor(renderer, 255, 200, 0, 200);
     SDL_RenderFillRect(renderer, &rect);
     SDL_SetRenderDrawColor(renderer, 255, 100, 0, 150);
@@ -77,21 +56,21 @@ void PowerUp::renderSpeedBoostEffect(SDL_Renderer* renderer, const SDL_Rect& rec
     SDL_RenderDrawLine(renderer, rect.x + rect.w - 8, rect.y + 8, rect.x + 8, rect.y + rect.h - 8);
 }
 
-void PowerUp::renderCoinMagnetEffect(SDL_Renderer* renderer, const SDL_Rect& rect) {
+void PowerUp::renderCoinMagnetEffect(SDL_Renderer* renderer, const SDL_Rect& rect, float animFrame) {
     SDL_SetRenderDrawColor(renderer, 200, 100, 255, 180);
     SDL_RenderFillRect(renderer, &rect);
     SDL_SetRenderDrawColor(renderer, 150, 50, 200, 255);
     for (int i = 0; i < 4; i++) {
         float angle = animFrame + i * M_PI / 2;
-        int lineX = rect.x + rect.w/2 + (int)(cos(angle) * 8);
-        int lineY = rect.y + rect.h/2 + (int)(sin(angle) * 8);
+        int lineX = rect.x + rect.w/2 + (int)(lutCos(angle) * 8);
+        int lineY = rect.y + rect.h/2 + (int)(lutSin(angle) * 8);
         SDL_RenderDrawLine(renderer, rect.x + rect.w/2, rect.y + rect.h/2, lineX, lineY);
     }
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderDrawLine(renderer, rect.x + 5, rect.y + rect.h/2, rect.x + rect.w - 5, rect.y + rect.h/2);
 }
 
-void PowerUp::renderDashEffect(SDL_Renderer* renderer, const SDL_Rect& rect) {
+void PowerUp::renderDashEffect(SDL_Renderer* renderer, const SDL_Rect& rect, float) {
     SDL_SetRenderDrawColor(renderer, 150, 150, 200, 200);
     SDL_RenderFillRect(renderer, &rect);
     SDL_SetRenderDrawColor(renderer, 200, 200, 255, 150);
@@ -110,69 +89,118 @@ void PowerUp::renderDashEffect(SDL_Renderer* renderer, const SDL_Rect& rect) {
     SDL_RenderDrawLine(renderer, rect.x + rect.w - 10, rect.y + rect.h - 5, rect.x + rect.w - 5, rect.y + rect.h/2);
 }
 
-bool PowerUp::checkCollision(int px, int py, int pwidth, int pheight) {
-    if (!active || collected) return false;
-    SDL_Rect a{ px, py - pheight, pwidth, pheight };
-    SDL_Rect b{ x, y - height, width, height };
-    return SDL_HasIntersection(&a, &b);
-}
-
 // ===================== POWERUP MANAGER IMPLEMENTATION =====================
 
-PowerUpManager::PowerUpManager(int ground, int gameSpeed, int width)
-    : groundY(ground), speed(gameSpeed), screenWidth(width) {
-    spawnTimer = 0;
-    spawnInterval = 300;
+PowerUpManager::PowerUpManager(EntityRegistry* registry, int ground, const WorldScroll* scroll, int width)
+    : groundY(ground), screenWidth(width), entities(registry), world(scroll), timers(nullptr),
+      atlas(nullptr), icons(nullptr) {
+    reserve(DEFAULT_CAPACITY, DEFAULT_COIN_CAPACITY);
     reset();
 }
 
-PowerUpManager::PowerUpManager(const PowerUpManager& other)
-    : groundY(other.groundY), speed(other.speed), screenWidth(other.screenWidth) {
-    spawnTimer = other.spawnTimer;
-    spawnInterval = other.spawnInterval;
+void PowerUpManager::attach(TimerWheel* wheel) {
+    timers = wheel;
     reset();
 }
 
+void PowerUpManager::reserve(int capacity, int coinCapacity) {
+    entities->reserve(ARCH_POWERUP, capacity);
+    int rows = entities->archetype(ARCH_POWERUP).capacity();
+    hitRects.reserve(rows);
+    hitRows.reserve(rows);
+    renderList.reserve(rows);
+    magnetBatch.reserve(coinCapacity);
+    magnetRows.reserve(coinCapacity);
+    hitMask.reserve(collisionMaskWords(std::max(rows, coinCapacity)));
+}
+
 void PowerUpManager::reset() {
-    powerUps.clear();
+    entities->clear(ARCH_POWERUP);
+    spawnInterval = 300;
+    autoSpawn = true;
     shieldActive = false;
-    shieldTimer = 0;
     speedBoostActive = false;
-    speedBoostTimer = 0;
-    originalSpeed = 0;
     coinMagnetActive = false;
-    coinMagnetTimer = 0;
     dashCharges = 0;
-    dashCooldown = 0;
     dashActive = false;
-    dashTimer = 0;
+    if (timers) {
+        timers->cancelAll(this);
+        spawnTimer = timers->schedule(spawnInterval, this, TIMER_SPAWN);
+    }
+    shieldTimer = speedBoostTimer = coinMagnetTimer = dashCooldown = dashTimer = TimerHandle();
+}
+
+void PowerUpManager::restartTimer(TimerHandle& timer, int ticks, int timerId) {
+    if (!timers) return;
+    timers->cancel(timer);
+    timer = timers->schedule(ticks, this, timerId);
+}
+
+void PowerUpManager::onTimer(int timerId) {
+    switch (timerId) {
+        case TIMER_SPAWN:
+            if (autoSpawn) spawn();
+            spawnInterval = 400 + (rand() % 200);
+            spawnTimer = timers->schedule(spawnInterval, this, TIMER_SPAWN);
+            break;
+        case TIMER_SHIELD:
+            shieldActive = false;
+            break;
+        case TIMER_SPEED_BOOST:
+            speedBoostActive = false;
+            break;
+        case TIMER_MAGNET:
+            coinMagnetActive = false;
+            break;
+        case TIMER_DASH:
+            dashActive = false;
+            break;
+        default:
+            break;   // TIMER_DASH_COOLDOWN: chỉ cần hết hạn
+    }
+}
+
+float PowerUpManager::getRemainingFraction(const TimerHandle& timer, int totalTicks) const {
+    if (!timers) return 0.0f;
+    return (float)timers->getRemaining(timer) / totalTicks;
 }
 
 void PowerUpManager::update(Player& player) {
     update(player, nullptr);
 }
 
-void PowerUpManager::update(Player& player, ScoreManager* scoreManager) {
-    for (auto& pu : powerUps) {
-        pu.update();
-        if (pu.checkCollision(player.x, player.y, player.width, player.height) && !pu.collected) {
-            pu.collected = true;
-            pu.active = false;
-            activate(pu.type, player);
+void PowerUpManager::update(Player& player, ScoreManager* scoreManager, EventBus* events) {
+    Archetype& arch = entities->archetype(ARCH_POWERUP);
+    // SPEED_BOOST: power-up trôi nhanh hơn thế giới, tốc độ cuộn không đổi.
+    // Mọi hàng dời như nhau nên thứ tự theo worldX giữ nguyên
+    if (speedBoostActive) {
+        double drift = (SPEED_BOOST_FACTOR - 1.0f) * world->getSpeed();
+        for (int c = 0; c < arch.chunkCount(); c++) {
+            ArchetypeChunk& k = arch.chunk(c);
+            int n = arch.chunkSize(c);
+            for (int i = 0; i < n; i++) k.worldX[i] -= drift;
         }
     }
 
-    powerUps.erase(
-        std::remove_if(powerUps.begin(), powerUps.end(), [](const PowerUp& p) { return !p.active; }),
-        powerUps.end()
-    );
+    double left = world->toWorld(player.x);
+    entities->setCosmeticLine(ARCH_POWERUP, left);
+    gatherRects(*entities, ARCH_POWERUP, *world, left, left + player.width,
+                ENTITY_ALIVE | ENTITY_COLLECTIBLE, hitRects, hitRows);
 
-    spawnTimer++;
-    if (spawnTimer >= spawnInterval) {
-        spawn();
-        spawnTimer = 0;
-        spawnInterval = 400 + (rand() % 200);
+    if (!hitRows.empty()) {
+        hitMask.resize(collisionMaskWords(hitRects.size()));
+        collideRects(hitRects, CollisionRect::fromRect(player.x, player.y - player.height, player.width, player.height),
+                     hitMask.data());
+    }
+    for (int i = 0; i < (int)hitRows.size(); i++) {
+        if (!collisionMaskTest(hitMask.data(), i)) continue;
+        int row = hitRows[i];
+        PowerUpType type = (PowerUpType)arch.kind(row);
+        arch.flags(row) = (arch.flags(row) | ENTITY_COLLECTED) & ~ENTITY_ALIVE;
+        activate(type, player);
+        if (events) events->publish(GameEvent::powerUpCollected((int)type, type == PowerUpType::SHIELD));
     }
+    runScrollSystem(*entities, ARCH_POWERUP, *world, false);
 
     updateEffects(player, scoreManager);
 }
@@ -181,155 +209,167 @@ void PowerUpManager::activate(PowerUpType type, Player& player) {
     switch (type) {
         case PowerUpType::SHIELD:
             shieldActive = true;
-            shieldTimer = 300;
+            restartTimer(shieldTimer, SHIELD_TICKS, TIMER_SHIELD);
             break;
         case PowerUpType::SPEED_BOOST:
             speedBoostActive = true;
-            speedBoostTimer = 240;
-            if (originalSpeed == 0) {
-                originalSpeed = static_cast<float>(speed);
-            }
-            speed = static_cast<int>(originalSpeed * 1.5f);
+            restartTimer(speedBoostTimer, SPEED_BOOST_TICKS, TIMER_SPEED_BOOST);
             break;
         case PowerUpType::COIN_MAGNET:
             coinMagnetActive = true;
-            coinMagnetTimer = 360;
+            restartTimer(coinMagnetTimer, MAGNET_TICKS, TIMER_MAGNET);
             break;
         case PowerUpType::DASH:
             dashCharges++;
             break;
+        case PowerUpType::COUNT:
+            break;
     }
 }
 
+// Hết hạn hiệu ứng do timer lo; ở đây chỉ còn hiệu ứng cần chạy mỗi frame
 void PowerUpManager::updateEffects(Player& player, ScoreManager* scoreManager) {
-    if (shieldActive) {
-        shieldTimer--;
-        if (shieldTimer <= 0) {
-            shieldActive = false;
-        }
-    }
-
-    if (speedBoostActive) {
-        speedBoostTimer--;
-        if (speedBoostTimer <= 0) {
-            speedBoostActive = false;
-            speed = static_cast<int>(originalSpeed);
-            originalSpeed = 0;
-        }
-    }
-
     if (coinMagnetActive && scoreManager) {
-        coinMagnetTimer--;
         applyCoinMagnetEffect(player, *scoreManager);
-        if (coinMagnetTimer <= 0) {
-            coinMagnetActive = false;
-        }
-    }
-
-    if (dashActive) {
-        dashTimer--;
-        if (dashTimer <= 0) {
-            dashActive = false;
-        }
-    }
-
-    if (dashCooldown > 0) {
-        dashCooldown--;
     }
 }
 
-void PowerUpManager::applyCoinMagnetEffect(Player& player, ScoreManager& scoreManager) {
-    for (auto& coin : scoreManager.coins) {
-        if (!coin.active || coin.collected) continue;
-
-        int coinCenterX = coin.x + coin.width/2;
-        int coinCenterY = coin.y - coin.height/2;
-        int playerCenterX = player.x + player.width/2;
-        int playerCenterY = player.y - player.height/2;
-
-        int distanceX = coinCenterX - playerCenterX;
-        int distanceY = coinCenterY - playerCenterY;
+void PowerUpManager::applyCoinMagnetEffect(Player& player, ScoreManager&) {
+    int playerCenterX = player.x + player.width/2;
+    int playerCenterY = player.y - player.height/2;
+    double centerX = world->toWorld(playerCenterX);
+
+    // Xu nằm trong archetype ARCH_COIN của registry dùng chung với ScoreManager
+    gatherCircles(*entities, ARCH_COIN, *world, centerX - MAGNET_RADIUS, centerX + MAGNET_RADIUS,
+                  ENTITY_ALIVE | ENTITY_COLLECTIBLE, magnetBatch, magnetRows);
+    if (magnetRows.empty()) return;
+
+    // So bình phương khoảng cách trong kernel; chỉ xu bị hút mới cần sqrt để tính lực kéo
+    hitMask.resize(collisionMaskWords(magnetBatch.size()));
+    collideCentersInRadius(magnetBatch, (float)playerCenterX, (float)playerCenterY, (float)MAGNET_RADIUS, hitMask.data());
+
+    Archetype& coins = entities->archetype(ARCH_COIN);
+    bool pulled = false;
+    for (int i = 0; i < (int)magnetRows.size(); i++) {
+        if (!collisionMaskTest(hitMask.data(), i)) continue;
+        int row = magnetRows[i];
+        int distanceX = world->toScreen(coins.worldX(row)) + coins.width(row)/2 - playerCenterX;
+        int distanceY = (int)coins.y(row) - coins.height(row)/2 - playerCenterY;
         float distance = sqrt(distanceX * distanceX + distanceY * distanceY);
 
-        if (distance <= MAGNET_RADIUS) {
-            float pullSpeed = 5.0f + (MAGNET_RADIUS - distance) / 10.0f;
+        float pullSpeed = 5.0f + (MAGNET_RADIUS - distance) / 10.0f;
 
-            if (distanceX > 0) {
-                coin.x -= std::min(static_cast<int>(pullSpeed), distanceX);
-            } else {
-                coin.x += std::min(static_cast<int>(pullSpeed), -distanceX);
-            }
+        if (distanceX > 0) {
+            coins.worldX(row) -= std::min(static_cast<int>(pullSpeed), distanceX);
+        } else {
+            coins.worldX(row) += std::min(static_cast<int>(pullSpeed), -distanceX);
+        }
 
-            if (distanceY > 0) {
-                coin.y -= std::min(static_cast<int>(pullSpeed), distanceY);
-            } else {
-                coin.y += std::min(static_cast<int>(pullSpeed), -distanceY);
-            }
+        if (distanceY > 0) {
+            coins.y(row) -= std::min(static_cast<int>(pullSpeed), distanceY);
+        } else {
+            coins.y(row) += std::min(static_cast<int>(pullSpeed), -distanceY);
         }
+        pulled = true;
     }
+    // Xu bị kéo đổi worldX: xếp lại cho lần tìm sau
+    if (pulled) entities->resort(ARCH_COIN);
 }
 
 void PowerUpManager::spawn() {
-    int typeIndex = rand() % 4;
+    int typeIndex = rand() % (int)PowerUpType::COUNT;
     PowerUpType type = static_cast<PowerUpType>(typeIndex);
-    powerUps.push_back(PowerUp(screenWidth, groundY, speed, type));
+    int lift = PowerUp::MIN_LIFT + rand() % PowerUp::LIFT_RANGE;   // Vị trí ngẫu nhiên trên không
+    spawnAt(world->toWorld(screenWidth), type, lift);
+}
+
+void PowerUpManager::spawnAt(double worldX, PowerUpType type, int lift) {
+    int row = entities->create(ARCH_POWERUP, worldX);
+    if (row < 0) return;
+    PowerUp::spawn(entities->archetype(ARCH_POWERUP), row, groundY, type, lift);
+    entities->noteWidth(ARCH_POWERUP, PowerUp::SIZE);
 }
 
 void PowerUpManager::render(SDL_Renderer* renderer) {
-    for (auto& pu : powerUps) {
-        pu.render(renderer);
-    }
+    buildRenderList(*entities, ARCH_POWERUP, *world, screenWidth, renderList);
+    for (const RenderItem& item : renderList) PowerUp::render(renderer, item);
     renderActiveEffectsUI(renderer);
 }
 
+// Màu icon HUD theo PowerUpType; ô icon vẽ với alpha 200, thanh thời gian đặc
+static const SDL_Color EFFECT_ICON_COLORS[(int)PowerUpType::COUNT] = {
+    {0, 150, 255, 255}, {255, 200, 0, 255}, {200, 100, 255, 255}, {150, 150, 200, 255}
+};
+static const int EFFECT_ICON_SIZE = 20;
+static const int EFFECT_BAR_HEIGHT = 3;
+
 void PowerUpManager::renderActiveEffectsUI(SDL_Renderer* renderer) {
-    int iconSize = 20;
+    if (shieldActive) {
+        renderEffectIcon(renderer, PowerUpType::SHIELD, 0, getRemainingFraction(shieldTimer, SHIELD_TICKS));
+    }
+    if (speedBoostActive) {
+        renderEffectIcon(renderer, PowerUpType::SPEED_BOOST, 1, getRemainingFraction(speedBoostTimer, SPEED_BOOST_TICKS));
+    }
+    if (coinMagnetActive) {
+        renderEffectIcon(renderer, PowerUpType::COIN_MAGNET, 2, getRemainingFraction(coinMagnetTimer, MAGNET_TICKS));
+    }
+    if (dashCharges > 0) {
+        renderEffectIcon(renderer, PowerUpType::DASH, 3, -1.0f);
+    }
+}
+
+void PowerUpManager::renderEffectIcon(SDL_Renderer* renderer, PowerUpType type, int slot, float fraction) {
     int startX = 10;
     int startY = 100;
     int spacing = 25;
+    int t = (int)type;
+    const SDL_Color& color = EFFECT_ICON_COLORS[t];
 
-    if (shieldActive) {
-        SDL_Rect shieldIcon = { startX, startY, iconSize, iconSize };
-        SDL_SetRenderDrawColor(renderer, 0, 150, 255, 200);
-        SDL_RenderFillRect(renderer, &shieldIcon);
-        float shieldPercent = (float)shieldTimer / 300.0f;
-        int shieldWidth = (int)(iconSize * shieldPercent);
-        SDL_Rect shieldTimeBar = { startX, startY + iconSize + 2, shieldWidth, 3 };
-        SDL_SetRenderDrawColor(renderer, 0, 150, 255, 255);
-        SDL_RenderFillRect(renderer, &shieldTimeBar);
-    }
+    SDL_Rect icon = { startX, startY + spacing * slot, EFFECT_ICON_SIZE, EFFECT_ICON_SIZE };
+    SDL_Rect timeBar = { startX, icon.y + EFFECT_ICON_SIZE + 2, (int)(EFFECT_ICON_SIZE * fraction), EFFECT_BAR_HEIGHT };
 
-    if (speedBoostActive) {
-        SDL_Rect speedIcon = { startX, startY + spacing, iconSize, iconSize };
-        SDL_SetRenderDrawColor(renderer, 255, 200, 0, 200);
-        SDL_RenderFillRect(renderer, &speedIcon);
-        float speedPercent = (float)speedBoostTimer / 240.0f;
-        int speedWidth = (int)(iconSize * speedPercent);
-        SDL_Rect speedTimeBar = { startX, startY + spacing + iconSize + 2, speedWidth, 3 };
-        SDL_SetRenderDrawColor(renderer, 255, 200, 0, 255);
-        SDL_RenderFillRect(renderer, &speedTimeBar);
+    // Có atlas thì mọi icon HUD là copy từ cùng một trang (gộp được draw call)
+    if (atlas && icons && icons->hud[t].valid()) {
+        atlas->draw(icons->hud[t], icon);
+        if (fraction >= 0.0f && timeBar.w > 0) atlas->draw(icons->bar[t], timeBar);
+        return;
     }
 
-    if (coinMagnetActive) {
-        SDL_Rect magnetIcon = { startX, startY + spacing * 2, iconSize, iconSize };
-        SDL_SetRenderDrawColor(renderer, 200, 100, 255, 200);
-        SDL_RenderFillRect(renderer, &magnetIcon);
-        float magnetPercent = (float)coinMagnetTimer / 360.0f;
-        int magnetWidth = (int)(iconSize * magnetPercent);
-        SDL_Rect magnetTimeBar = { startX, startY + spacing * 2 + iconSize + 2, magnetWidth, 3 };
-        SDL_SetRenderDrawColor(renderer, 200, 100, 255, 255);
-        SDL_RenderFillRect(renderer, &magnetTimeBar);
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 200);
+    SDL_RenderFillRect(renderer, &icon);
+    if (fraction >= 0.0f) {
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+        SDL_RenderFillRect(renderer, &timeBar);
     }
+}
 
-    if (dashCharges > 0) {
-        SDL_Rect dashIcon = { startX, startY + spacing * 3, iconSize, iconSize };
-        SDL_SetRenderDrawColor(renderer, 150, 150, 200, 200);
-        SDL_RenderFillRect(renderer, &dashIcon);
+void PowerUpManager::bakeIcons(TextureAtlas& atlas, PowerUpIcons& icons) {
+    for (int t = 0; t < (int)PowerUpType::COUNT; t++) {
+        SDL_Color color = EFFECT_ICON_COLORS[t];
+        // Ghi thẳng alpha (không blend) để ô icon giữ đúng alpha 200 khi vẽ ra
+        icons.hud[t] = atlas.bake(EFFECT_ICON_SIZE, EFFECT_ICON_SIZE, [color](SDL_Renderer* r) {
+            SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_NONE);
+            SDL_SetRenderDrawColor(r, color.r, color.g, color.b, 200);
+            SDL_Rect icon = { 0, 0, EFFECT_ICON_SIZE, EFFECT_ICON_SIZE };
+            SDL_RenderFillRect(r, &icon);
+        });
+        // Thanh đặc nên kéo giãn theo phần thời gian còn lại vẫn đúng màu
+        icons.bar[t] = atlas.bake(EFFECT_ICON_SIZE, EFFECT_BAR_HEIGHT, [color](SDL_Renderer* r) {
+            SDL_SetRenderDrawColor(r, color.r, color.g, color.b, 255);
+            SDL_Rect bar = { 0, 0, EFFECT_ICON_SIZE, EFFECT_BAR_HEIGHT };
+            SDL_RenderFillRect(r, &bar);
+        });
     }
 }
 
+void PowerUpManager::setIcons(TextureAtlas* textureAtlas, const PowerUpIcons* hudIcons) {
+    atlas = textureAtlas;
+    icons = hudIcons;
+}
+
 bool PowerUpManager::canDash() const {
-    return dashCharges > 0 && dashCooldown <= 0 && !dashActive;
+    bool coolingDown = timers && timers->isPending(dashCooldown);
+    return dashCharges > 0 && !coolingDown && !dashActive;
 }
 
 void PowerUpManager::useDash() {
@@ -341,21 +381,11 @@ void PowerUpManager::useDash(Player& player) {
     if (canDash()) {
         dashCharges--;
         dashActive = true;
-        dashTimer = 20;
-        dashCooldown = 120;
+        restartTimer(dashTimer, DASH_TICKS, TIMER_DASH);
+        restartTimer(dashCooldown, DASH_COOLDOWN_TICKS, TIMER_DASH_COOLDOWN);
         player.x += 150;
         if (player.x > screenWidth - player.width) {
             player.x = screenWidth - player.width;
         }
     }
 }
-
-void PowerUpManager::setSpeed(int newSpeed) {
-    if (!speedBoostActive) {
-        speed = newSpeed;
-        originalSpeed = static_cast<float>(newSpeed);
-    }
-    for (auto& pu : powerUps) {
-        pu.speed = speed;
-    }
-}
@@ -8,86 +8,130 @@
 #include <cmath>
 #include "player.h"
 #include "score.h"
+#include "timer_wheel.h"
+#include "collision_kernels.h"
 
 // Loại power-up
 enum class PowerUpType {
     SHIELD,       // Khiên bảo vệ
     SPEED_BOOST,  // Tăng tốc
     COIN_MAGNET,  // Hút xu
-    DASH          // Lướt tới
+    DASH,         // Lướt tới
+    COUNT
 };
 
+// Power-up là hàng trong archetype ARCH_POWERUP (kind = PowerUpType)
 class PowerUp {
 public:
-    int x, y;
-    int width, height;
-    int speed;
-    bool active;
-    bool collected;
-    PowerUpType type;
-    float animFrame; // Cho hiệu ứng animation
+    static const int SIZE = 30;
+    // Đáy cao hơn mặt đất MIN_LIFT..MIN_LIFT + LIFT_RANGE - 1
+    static const int MIN_LIFT = 80;
+    static const int LIFT_RANGE = 50;
 
-    PowerUp(int startX, int groundY, int gameSpeed, PowerUpType puType);
-
-    void update();
-    void render(SDL_Renderer* renderer);
-    bool checkCollision(int px, int py, int pwidth, int pheight);
+    static void spawn(Archetype& arch, int row, int groundY, PowerUpType type, int lift);
+    static void render(SDL_Renderer* renderer, const RenderItem& item);
 
 private:
-    void renderShieldEffect(SDL_Renderer* renderer, const SDL_Rect& rect);
-    void renderSpeedBoostEffect(SDL_Renderer* renderer, const SDL_Rect& rect);
-    void renderCoinMagnetEffect(SDL_Renderer* renderer, const SDL_Rect& rect);
-    void renderDashEffect(SDL_Renderer* renderer, const SDL_Rect& rect);
+    // Cùng chữ ký để render() tra bảng theo PowerUpType
+    static void renderShieldEffect(SDL_Renderer* renderer, const SDL_Rect& rect, float animFrame);
+    static void renderSpeedBoostEffect(SDL_Renderer* renderer, const SDL_Rect& rect, float animFrame);
+    static void renderCoinMagnetEffect(SDL_Renderer* renderer, const SDL_Rect& rect, float animFrame);
+    static void renderDashEffect(SDL_Renderer* renderer, const SDL_Rect& rect, float animFrame);
+};
+
+// Icon hiệu ứng đang chạy trên HUD (ô màu và thanh thời gian) vẽ sẵn vào atlas
+struct PowerUpIcons {
+    AtlasHandle hud[(int)PowerUpType::COUNT];
+    AtlasHandle bar[(int)PowerUpType::COUNT];
 };
 
-class PowerUpManager {
+// Mặt tiền của archetype ARCH_POWERUP cùng trạng thái các hiệu ứng đang chạy
+class PowerUpManager : public TimerListener {
 public:
-    std::vector<PowerUp> powerUps;
-    int spawnTimer;
+    TimerHandle spawnTimer;
     int spawnInterval;
     int groundY;
-    int speed;
     int screenWidth;
+    bool autoSpawn;       // false: power-up do LevelGenerator đặt sẵn
+
+    // Trạng thái hiệu ứng; hết hạn bằng timer trên wheel
+    static const int SHIELD_TICKS = 300;
+    static const int SPEED_BOOST_TICKS = 240;
+    static const int MAGNET_TICKS = 360;
+    static const int DASH_TICKS = 20;
+    static const int DASH_COOLDOWN_TICKS = 120;
 
-    // Trạng thái hiệu ứng
     bool shieldActive;
-    int shieldTimer;
+    TimerHandle shieldTimer;
 
     bool speedBoostActive;
-    int speedBoostTimer;
-    float originalSpeed;
+    TimerHandle speedBoostTimer;
+    static constexpr float SPEED_BOOST_FACTOR = 1.5f;   // Power-up trôi nhanh gấp bấy nhiêu lần thế giới
 
     bool coinMagnetActive;
-    int coinMagnetTimer;
+    TimerHandle coinMagnetTimer;
     static const int MAGNET_RADIUS = 150;
 
     int dashCharges;
-    int dashCooldown;
+    TimerHandle dashCooldown;
     bool dashActive;
-    int dashTimer;
+    TimerHandle dashTimer;
+
+    PowerUpManager(EntityRegistry* registry, int ground, const WorldScroll* scroll, int width);
 
-    PowerUpManager(int ground, int gameSpeed, int width);
-    PowerUpManager(const PowerUpManager& other);
+    // Hẹn timer spawn (gọi lại sau mỗi lần tạo mới PowerUpManager)
+    void attach(TimerWheel* wheel);
+    void onTimer(int timerId) override;
+    // Sức chứa archetype power-up và bộ đệm nam châm (cỡ archetype xu); chỉ tăng
+    void reserve(int capacity, int coinCapacity);
 
-    void reset();
+    void reset();   // Giữ sức chứa
     void update(Player& player);
-    void update(Player& player, ScoreManager* scoreManager);
+    void update(Player& player, ScoreManager* scoreManager, EventBus* events = nullptr);
     void activate(PowerUpType type, Player& player);
     void updateEffects(Player& player, ScoreManager* scoreManager);
+    // Phần còn lại (0..1) của hiệu ứng, cho thanh thời gian trên UI
+    float getRemainingFraction(const TimerHandle& timer, int totalTicks) const;
     void applyCoinMagnetEffect(Player& player, ScoreManager& scoreManager);
     void spawn();
+    // Power-up đã chọn sẵn (LevelGenerator) ở worldX
+    void spawnAt(double worldX, PowerUpType type, int lift);
     void render(SDL_Renderer* renderer);
     void renderActiveEffectsUI(SDL_Renderer* renderer);
+    static void bakeIcons(TextureAtlas& atlas, PowerUpIcons& icons);
+    void setIcons(TextureAtlas* textureAtlas, const PowerUpIcons* hudIcons);
     bool canDash() const;
     void useDash();
     void useDash(Player& player);
-    void setSpeed(int newSpeed);
-
     bool isShieldActive() const { return shieldActive; }
     bool isSpeedBoostActive() const { return speedBoostActive; }
     bool isCoinMagnetActive() const { return coinMagnetActive; }
     bool isDashActive() const { return dashActive; }
     int getDashCharges() const { return dashCharges; }
+
+private:
+    enum { TIMER_SPAWN, TIMER_SHIELD, TIMER_SPEED_BOOST, TIMER_MAGNET, TIMER_DASH, TIMER_DASH_COOLDOWN };
+
+    void restartTimer(TimerHandle& timer, int ticks, int timerId);
+    // Icon HUD thứ slot (từ trên xuống); fraction < 0: không có thanh thời gian
+    void renderEffectIcon(SDL_Renderer* renderer, PowerUpType type, int slot, float fraction);
+
+    static const int DEFAULT_CAPACITY = 4;
+    static const int DEFAULT_COIN_CAPACITY = 32;
+
+    EntityRegistry* entities;
+    const WorldScroll* world;
+    TimerWheel* timers;
+    TextureAtlas* atlas;
+    const PowerUpIcons* icons;
+
+    // Bộ đệm kiểm tra nhặt power-up và nam châm theo lô, danh sách vẽ
+    RectBatch hitRects;
+    std::vector<int> hitRows;
+    CircleBatch magnetBatch;
+    std::vector<int> magnetRows;
+    std::vector<Uint32> hitMask;
+    std::vector<RenderItem> renderList;
 };
 
 #endif // POWERUP_H_INCLUDED
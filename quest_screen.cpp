@@ -111,8 +111,8 @@ void QuestScreen::render(SDL_Renderer* renderer, TTF_Font* fontBig, TTF_Font* fo
         uiRenderer.drawEnhancedGlassPanel(questRect, bgColor);
 
         // Quest title and description
-        uiRenderer.renderTextLeft(quest.title, questRect.x + 15, questRect.y + 12, fontSmall, white);
-        uiRenderer.renderTextLeft(quest.description, questRect.x + 15, questRect.y + 37,
+        uiRenderer.renderTextLeft(quest.title(), questRect.x + 15, questRect.y + 12, fontSmall, white);
+        uiRenderer.renderTextLeft(quest.description(), questRect.x + 15, questRect.y + 37,
                                  fontTiny, {220, 220, 220, 255});
 
         // Progress Bar with enhanced style
@@ -129,13 +129,13 @@ void QuestScreen::render(SDL_Renderer* renderer, TTF_Font* fontBig, TTF_Font* fo
 
             // Progress text
             std::string progText = std::to_string(quest.currentProgress) + "/" +
-                                  std::to_string(quest.requirement);
+                                  std::to_string(quest.requirement());
             uiRenderer.renderTextLeft(progText, questRect.x + 225, questRect.y + 60, fontTiny, white);
         }
 
         // Reward info
-        std::string rewardText = "Reward: " + std::to_string(quest.coinReward) +
-                                " coins, " + std::to_string(quest.xpReward) + " XP";
+        std::string rewardText = "Reward: " + std::to_string(quest.coinReward()) +
+                                " coins, " + std::to_string(quest.xpReward()) + " XP";
         uiRenderer.renderTextLeft(rewardText, questRect.x + 15, questRect.y + 70, fontTiny, orange);
 
         // Status button with enhanced style
@@ -227,8 +227,8 @@ bool QuestScreen::handleInput(SDL_Event& e, QuestSystem& questSystem, Player& pl
         if (mx >= statusBtn.x && mx <= statusBtn.x + statusBtn.w && my >= statusBtn.y && my <= statusBtn.y + statusBtn.h) {
             if (quest.isCompleted && !quest.rewardClaimed) {
                 // Claim reward
-                player.totalCoins += quest.coinReward;
-                player.addXp(quest.xpReward);
+                player.totalCoins += quest.coinReward();
+                player.addXp(quest.xpReward());
                 quest.rewardClaimed = true;
                 questSystem.saveProgress();
             }
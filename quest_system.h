@@ -11,38 +11,60 @@
 #include <random>
 #include <chrono>
 #include "player.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
+#include "content_db.h"
 
+// Tên, mô tả, ngưỡng và thưởng nằm trong content DB (QuestDef);
+// Quest chỉ giữ con trỏ tới def cùng tiến độ thay đổi được
 struct Quest {
-    int id;
-    std::string title, description;
+    enum Type { COLLECT_COINS, REACH_SCORE, COMPLETE_LEVEL, COLLECT_POWERUPS, REACH_COMBO, SURVIVE_TIME, JUMP_COUNT, NO_DAMAGE, TYPE_COUNT };
+
+    const QuestDef* def;
+    int currentProgress;
     bool isCompleted, isActive, rewardClaimed;
-    enum Type { COLLECT_COINS, REACH_SCORE, COMPLETE_LEVEL, COLLECT_POWERUPS, REACH_COMBO, SURVIVE_TIME, JUMP_COUNT, NO_DAMAGE } type;
-    int requirement, currentProgress;
-    int coinReward, xpReward;
-    bool isAccumulative;
-
-    Quest(int qid, const std::string& t, const std::string& desc, Type qtype, int req, int coins, int xp, bool accumulative = false)
-        : id(qid), title(t), description(desc), isCompleted(false), isActive(false), rewardClaimed(false),
-          type(qtype), requirement(req), currentProgress(0), coinReward(coins), xpReward(xp),
-          isAccumulative(accumulative) {}
-
-    float getProgressPercent() const { return requirement == 0 ? 0.0f : (float)currentProgress / requirement; }
-    bool checkCompletion() { if (!isCompleted && currentProgress >= requirement) isCompleted = true; return isCompleted; }
+
+    explicit Quest(const QuestDef& questDef)
+        : def(&questDef), currentProgress(0), isCompleted(false), isActive(false), rewardClaimed(false) {}
+
+    int id() const { return def->id; }
+    Type type() const { return (Type)def->type; }
+    int requirement() const { return def->requirement; }
+    int coinReward() const { return def->coinReward; }
+    int xpReward() const { return def->xpReward; }
+    bool isAccumulative() const { return def->accumulative != 0; }
+    const char* title() const { return gameContent().text(def->title); }
+    const char* description() const { return gameContent().text(def->description); }
+
+    float getProgressPercent() const { return (float)currentProgress / requirement(); }
+    bool checkCompletion() { if (!isCompleted && currentProgress >= requirement()) isCompleted = true; return isCompleted; }
 };
 
-class QuestSystem {
+SDL_COMPILE_TIME_ASSERT(quest_type_count, Quest::TYPE_COUNT == CONTENT_QUEST_TYPES);
+
+class QuestSystem : public GameEventListener, public TimerListener {
 public:
     std::vector<Quest> dailyQuests, mainQuests;
-    std::vector<Quest> dailyQuestPool;
-    std::vector<Quest> mainQuestPool;
+    std::vector<const QuestDef*> dailyQuestPool;   // Trỏ vào content DB
+    std::vector<const QuestDef*> mainQuestPool;
 
-    int notificationTimer;
-    std::string notificationText;
+    TimerHandle notificationTimer;
+    std::string notificationText;   // Rỗng khi không có thông báo
     int sessionCoinsCollected, sessionScore, sessionPowerupsCollected, sessionMaxCombo, sessionSurvivalTime, sessionJumpCount, sessionLevelsCompleted;
     bool sessionNoDamage;
 
+    // Quest chưa hoàn thành theo loại (trỏ vào dailyQuests/mainQuests, dựng lại
+    // sau mỗi lần reset/load). Bộ đếm nào đổi thì chỉ đánh dấu loại của nó;
+    // updateQuests chỉ duyệt các loại bị đánh dấu, quest xong thì rời index.
+    std::vector<Quest*> questsByType[Quest::TYPE_COUNT];
+    Uint32 dirtyTypes;
+    // Tổng tích luỹ của player lần trước (đổi cả ngoài gameplay: thưởng, shop)
+    int seenTotalCoins, seenTotalPowerups, seenBestCombo, seenLevelsCompleted;
+
     QuestSystem() {
-        notificationTimer = 0;
+        timers = nullptr;
+        dirtyTypes = 0;
+        seenTotalCoins = seenTotalPowerups = seenBestCombo = seenLevelsCompleted = -1;
         initializeQuests();
         resetSessionStats();
 
@@ -55,56 +77,66 @@ public:
     void resetSessionStats() {
         sessionCoinsCollected = 0; sessionScore = 0; sessionPowerupsCollected = 0; sessionMaxCombo = 0;
         sessionSurvivalTime = 0; sessionJumpCount = 0; sessionNoDamage = true; sessionLevelsCompleted = 0;
+        markAllDirty();
+    }
+
+    void markDirty(Quest::Type type) { dirtyTypes |= 1u << type; }
+    void markAllDirty() { dirtyTypes = (1u << Quest::TYPE_COUNT) - 1; }
+
+    void rebuildQuestIndex() {
+        for (int t = 0; t < Quest::TYPE_COUNT; t++) questsByType[t].clear();
+        for (auto& quest : dailyQuests) if (!quest.isCompleted) questsByType[quest.type()].push_back(&quest);
+        for (auto& quest : mainQuests) if (!quest.isCompleted) questsByType[quest.type()].push_back(&quest);
+        seenTotalCoins = seenTotalPowerups = seenBestCombo = seenLevelsCompleted = -1;
+        markAllDirty();
     }
 
     void initializeQuests() {
-        dailyQuestPool = {
-            Quest(0, "Thu Thập Nhanh", "Thu thập 50 xu trong 1 lần chạy", Quest::COLLECT_COINS, 50, 50, 25, false),
-            Quest(1, "Thợ Săn Điểm", "Đạt 100 điểm trong 1 lần chạy", Quest::REACH_SCORE, 100, 40, 20, false),
-            Quest(2, "Nhảy Nhót", "Nhảy 20 lần trong 1 lần chạy", Quest::JUMP_COUNT, 20, 30, 15, false),
-            Quest(3, "Tăng Lực", "Thu thập 3 vật phẩm hỗ trợ", Quest::COLLECT_POWERUPS, 3, 60, 30, false),
-            Quest(4, "Combo Ngắn", "Đạt 5x combo", Quest::REACH_COMBO, 5, 50, 25, false),
-            Quest(5, "Sinh Tồn", "Sống sót 1 phút (60s) trong 1 lần chạy", Quest::SURVIVE_TIME, 1, 40, 20, false),
-            Quest(6, "Tay Săn Xu", "Thu thập 100 xu trong 1 lần chạy", Quest::COLLECT_COINS, 100, 100, 50, false),
-            Quest(7, "Chuyên Gia Né Tránh", "Đạt 150 điểm mà không nhận sát thương", Quest::NO_DAMAGE, 150, 150, 75, false),
-            Quest(8, "Vua Combo", "Đạt 10x combo", Quest::REACH_COMBO, 10, 100, 50, false),
-            Quest(9, "Marathon Mini", "Sống sót 2 phút (120s)", Quest::SURVIVE_TIME, 2, 80, 40, false)
-        };
-
-        // [SỬA] Mở rộng Main Quest Pool (tất cả đều là 'true' - tích lũy)
-        mainQuestPool = {
-            Quest(100, "Bước Đầu Tiên", "Hoàn thành 1 màn chơi (bất kỳ)", Quest::COMPLETE_LEVEL, 1, 75, 50, true),
-            Quest(101, "Giàu Có", "Thu thập tổng cộng 200 xu", Quest::COLLECT_COINS, 200, 150, 75, true),
-            Quest(102, "Chuyên Gia", "Hoàn thành tổng cộng 5 màn chơi", Quest::COMPLETE_LEVEL, 5, 200, 100, true),
-            Quest(103, "Triệu Phú Xu", "Thu thập tổng cộng 1000 xu", Quest::COLLECT_COINS, 1000, 500, 250, true),
-            // [THÊM]
-            Quest(104, "Nhà Sưu Tầm", "Thu thập tổng cộng 50 vật phẩm", Quest::COLLECT_POWERUPS, 50, 200, 100, true),
-            Quest(105, "Bậc Thầy Combo", "Đạt 20x combo (cao nhất)", Quest::REACH_COMBO, 20, 250, 150, true),
-            Quest(106, "Người Du Hành", "Hoàn thành tổng cộng 10 màn chơi", Quest::COMPLETE_LEVEL, 10, 400, 200, true),
-            Quest(107, "Kho Bạc", "Thu thập tổng cộng 5000 xu", Quest::COLLECT_COINS, 5000, 1000, 500, true)
-        };
+        const ContentDB& content = gameContent();
+        dailyQuestPool.clear();
+        mainQuestPool.clear();
+        for (int i = 0; i < content.questCount(); i++) {
+            const QuestDef& def = content.quest(i);
+            (def.pool == QUEST_POOL_DAILY ? dailyQuestPool : mainQuestPool).push_back(&def);
+        }
     }
 
     void updateQuests(Player& player) {
-        for (auto& quest : dailyQuests) if (!quest.isCompleted) updateQuestProgress(quest, player);
-        for (auto& quest : mainQuests) if (!quest.isCompleted) updateQuestProgress(quest, player);
+        if (player.totalCoins != seenTotalCoins) { seenTotalCoins = player.totalCoins; markDirty(Quest::COLLECT_COINS); }
+        if (player.totalPowerupsCollected != seenTotalPowerups) { seenTotalPowerups = player.totalPowerupsCollected; markDirty(Quest::COLLECT_POWERUPS); }
+        if (player.bestComboAchieved != seenBestCombo) { seenBestCombo = player.bestComboAchieved; markDirty(Quest::REACH_COMBO); }
+        if (player.totalLevelsCompleted != seenLevelsCompleted) { seenLevelsCompleted = player.totalLevelsCompleted; markDirty(Quest::COMPLETE_LEVEL); }
+
+        for (int t = 0; dirtyTypes != 0 && t < Quest::TYPE_COUNT; t++) {
+            if (!(dirtyTypes & (1u << t))) continue;
+            dirtyTypes &= ~(1u << t);
+            std::vector<Quest*>& bucket = questsByType[t];
+            for (size_t i = 0; i < bucket.size();) {
+                updateQuestProgress(*bucket[i], player);
+                if (bucket[i]->isCompleted) {
+                    bucket[i] = bucket.back();
+                    bucket.pop_back();
+                } else {
+                    i++;
+                }
+            }
+        }
 
-        if (notificationTimer > 0) notificationTimer--;
     }
 
     void updateQuestProgress(Quest& quest, Player& player) {
-        switch (quest.type) {
+        switch (quest.type()) {
             case Quest::COLLECT_COINS:
-                quest.currentProgress = quest.isAccumulative ? player.totalCoins : std::max(quest.currentProgress, sessionCoinsCollected);
+                quest.currentProgress = quest.isAccumulative() ? player.totalCoins : std::max(quest.currentProgress, sessionCoinsCollected);
                 break;
             case Quest::REACH_SCORE:
                 quest.currentProgress = std::max(quest.currentProgress, sessionScore);
                 break;
             case Quest::COLLECT_POWERUPS:
-                quest.currentProgress = quest.isAccumulative ? player.totalPowerupsCollected : std::max(quest.currentProgress, sessionPowerupsCollected);
+                quest.currentProgress = quest.isAccumulative() ? player.totalPowerupsCollected : std::max(quest.currentProgress, sessionPowerupsCollected);
                 break;
             case Quest::REACH_COMBO:
-                quest.currentProgress = quest.isAccumulative ? player.bestComboAchieved : std::max(quest.currentProgress, sessionMaxCombo);
+                quest.currentProgress = quest.isAccumulative() ? player.bestComboAchieved : std::max(quest.currentProgress, sessionMaxCombo);
                 break;
             case Quest::SURVIVE_TIME:
                 quest.currentProgress = std::max(quest.currentProgress, sessionSurvivalTime / 60);
@@ -113,7 +145,7 @@ public:
                 quest.currentProgress = std::max(quest.currentProgress, sessionJumpCount);
                 break;
             case Quest::COMPLETE_LEVEL:
-                quest.currentProgress = quest.isAccumulative ? player.totalLevelsCompleted : std::max(quest.currentProgress, sessionLevelsCompleted);
+                quest.currentProgress = quest.isAccumulative() ? player.totalLevelsCompleted : std::max(quest.currentProgress, sessionLevelsCompleted);
                 break;
             case Quest::NO_DAMAGE:
                 if (!sessionNoDamage) {
@@ -122,28 +154,55 @@ public:
                     quest.currentProgress = sessionScore;
                 }
                 break;
+            default:
+                break;
         }
-        if (quest.checkCompletion() && !quest.rewardClaimed) showNotification("Quest Completed: " + quest.title);
+        if (quest.checkCompletion() && !quest.rewardClaimed) showNotification(std::string("Quest Completed: ") + quest.title());
     }
 
     void activateQuest(int questId, bool isDaily) {
         auto& questList = isDaily ? dailyQuests : mainQuests;
-        for (auto& quest : questList) if (quest.id == questId) { quest.isActive = true; break; }
+        for (auto& quest : questList) if (quest.id() == questId) { quest.isActive = true; break; }
     }
 
-    void showNotification(const std::string& text) { notificationText = text; notificationTimer = 180; }
+    void attach(TimerWheel* wheel) { timers = wheel; }
 
-    void onCoinCollected() { sessionCoinsCollected++; }
-    void onScoreUpdate(int score) { sessionScore = score; }
-    void onPowerupCollected() { sessionPowerupsCollected++; }
-    void onComboUpdate(int combo) { if (combo > sessionMaxCombo) sessionMaxCombo = combo; }
-    void onSurvivalTimeUpdate() { sessionSurvivalTime++; }
-    void onJump() { sessionJumpCount++; }
-    void onDamageTaken() { sessionNoDamage = false; }
-    void onLevelComplete() { sessionLevelsCompleted++; }
+    // Hiện 180 frame; chưa gắn wheel (lúc nạp tiến độ) thì bỏ qua
+    void showNotification(const std::string& text) {
+        if (!timers) return;
+        notificationText = text;
+        timers->cancel(notificationTimer);
+        notificationTimer = timers->schedule(180, this, 0);
+    }
+    void onTimer(int timerId) override { notificationText.clear(); }
+
+    void onCoinCollected() { sessionCoinsCollected++; markDirty(Quest::COLLECT_COINS); }
+    void onScoreUpdate(int score) {
+        if (score == sessionScore) return;
+        sessionScore = score;
+        markDirty(Quest::REACH_SCORE);
+        markDirty(Quest::NO_DAMAGE);
+    }
+    void onPowerupCollected() { sessionPowerupsCollected++; markDirty(Quest::COLLECT_POWERUPS); }
+    void onComboUpdate(int combo) { if (combo > sessionMaxCombo) { sessionMaxCombo = combo; markDirty(Quest::REACH_COMBO); } }
+    void onSurvivalTimeUpdate() { if (++sessionSurvivalTime % 60 == 0) markDirty(Quest::SURVIVE_TIME); }
+    void onJump() { sessionJumpCount++; markDirty(Quest::JUMP_COUNT); }
+    void onDamageTaken() { sessionNoDamage = false; markDirty(Quest::NO_DAMAGE); }
+    void onLevelComplete() { sessionLevelsCompleted++; markDirty(Quest::COMPLETE_LEVEL); }
+
+    void onGameEvent(const GameEvent& event) override {
+        switch (event.type) {
+            case EVENT_COIN_COLLECTED: onCoinCollected(); break;
+            case EVENT_POWERUP_COLLECTED: onPowerupCollected(); break;
+            case EVENT_JUMP: onJump(); break;
+            case EVENT_HIT: onDamageTaken(); break;
+            case EVENT_LEVEL_COMPLETE: onLevelComplete(); break;
+            default: break;
+        }
+    }
 
     void renderNotification(SDL_Renderer* renderer, TTF_Font* font, int screenWidth) {
-        if (notificationTimer > 0) {
+        if (!notificationText.empty()) {
             // Render logic
         }
     }
@@ -170,9 +229,11 @@ public:
         // 4. Chọn 3 nhiệm vụ đầu tiên từ danh sách đã xáo trộn
         int numToSelect = std::min(3, (int)dailyQuestPool.size()); // Chọn 3 hoặc ít hơn nếu pool nhỏ
         for (int i = 0; i < numToSelect; ++i) {
-            dailyQuests.push_back(dailyQuestPool[indices[i]]); // Thêm BẢN SAO vào danh sách active
+            dailyQuests.push_back(Quest(*dailyQuestPool[indices[i]]));
         }
 
+        rebuildQuestIndex();
+
         // 5. Lưu lại danh sách nhiệm vụ mới (rỗng)
         if (!isInitialLoad) {
             saveProgress();
@@ -184,9 +245,9 @@ public:
         std::ofstream file("quests.dat");
         if (!file.is_open()) return;
         file << dailyQuests.size() << "\n";
-        for (const auto& q : dailyQuests) file << q.id << " " << q.isActive << " " << q.isCompleted << " " << q.rewardClaimed << " " << q.currentProgress << "\n";
+        for (const auto& q : dailyQuests) file << q.id() << " " << q.isActive << " " << q.isCompleted << " " << q.rewardClaimed << " " << q.currentProgress << "\n";
         file << mainQuests.size() << "\n";
-        for (const auto& q : mainQuests) file << q.id << " " << q.isActive << " " << q.isCompleted << " " << q.rewardClaimed << " " << q.currentProgress << "\n";
+        for (const auto& q : mainQuests) file << q.id() << " " << q.isActive << " " << q.isCompleted << " " << q.rewardClaimed << " " << q.currentProgress << "\n";
         file.close();
     }
 
@@ -204,7 +265,7 @@ public:
             if (file.fail()) break;
             // Tìm quest trong danh sách active dailyQuests và cập nhật
             for (auto& q : dailyQuests) {
-                if (q.id == id) {
+                if (q.id() == id) {
                     q.isActive = isActive; q.isCompleted = isCompleted; q.rewardClaimed = rewardClaimed; q.currentProgress = currentProgress;
                     break;
                 }
@@ -221,13 +282,14 @@ public:
             if (file.fail()) break;
             // Tìm quest trong danh sách active mainQuests và cập nhật
             for (auto& q : mainQuests) {
-                if (q.id == id) {
+                if (q.id() == id) {
                     q.isActive = isActive; q.isCompleted = isCompleted; q.rewardClaimed = rewardClaimed; q.currentProgress = currentProgress;
                     break;
                 }
             }
         }
         file.close();
+        rebuildQuestIndex();
     }
 
     int getActiveQuestCount() {
@@ -260,7 +322,7 @@ public:
             if (!quest.isCompleted) {
                 bool already_added = false;
                 for(Quest* q_ptr : displayList) {
-                    if (q_ptr->id == quest.id) {
+                    if (q_ptr->id() == quest.id()) {
                         already_added = true;
                         break;
                     }
@@ -299,15 +361,20 @@ public:
         // 4. Chọn 3 nhiệm vụ đầu tiên từ danh sách đã xáo trộn
         int numToSelect = std::min(3, (int)mainQuestPool.size()); // Chọn 3 hoặc ít hơn nếu pool nhỏ
         for (int i = 0; i < numToSelect; ++i) {
-            mainQuests.push_back(mainQuestPool[indices[i]]); // Thêm BẢN SAO vào danh sách active
+            mainQuests.push_back(Quest(*mainQuestPool[indices[i]]));
         }
 
+        rebuildQuestIndex();
+
         // 5. Lưu lại danh sách nhiệm vụ mới (rỗng)
         if (!isInitialLoad) {
             saveProgress();
             std::cout << "Main Quests have been reset with new random quests." << std::endl;
         }
     }
+
+private:
+    TimerWheel* timers;
 };
 
 #endif // QUEST_SYSTEM_H_INCLUDED
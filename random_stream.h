@@ -0,0 +1,51 @@
+#ifndef RANDOM_STREAM_H_INCLUDED
+#define RANDOM_STREAM_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <cstdlib>
+
+// rand() toàn cục, chỉ dùng trên main thread (spawn theo timer/nhạc)
+struct LibcRandom {
+    // 0..n-1 đều nhau (n <= RAND_MAX + 1): bỏ phần đuôi không chia hết cho n
+    int below(int n) {
+        long range = (long)RAND_MAX + 1;
+        long limit = range - range % n;
+        int r;
+        do r = rand(); while (r >= limit);
+        return r % n;
+    }
+};
+
+// Dòng số ngẫu nhiên riêng có seed (xorshift32): cùng seed cho cùng dãy,
+// không đụng trạng thái rand() nên dùng được trên thread khác
+class RandomStream {
+public:
+    explicit RandomStream(Uint32 seed = 1) { reseed(seed); }
+
+    void reseed(Uint32 seed) {
+        // Trộn seed (hằng của splitmix32) để seed gần nhau vẫn cho dãy khác hẳn; state không được là 0
+        seed = (seed ^ (seed >> 16)) * 0x7feb352dU;
+        seed = (seed ^ (seed >> 15)) * 0x846ca68bU;
+        state = (seed ^ (seed >> 16)) | 1U;
+    }
+
+    Uint32 next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // 0..n-1 đều nhau: bỏ các giá trị dưới 2^32 mod n để phần còn lại chia hết cho n
+    int below(int n) {
+        Uint32 threshold = (0U - (Uint32)n) % (Uint32)n;
+        Uint32 r;
+        do r = next(); while (r < threshold);
+        return (int)(r % (Uint32)n);
+    }
+
+private:
+    Uint32 state;
+};
+
+#endif // RANDOM_STREAM_H_INCLUDED
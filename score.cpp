@@ -1,114 +1,124 @@
 #include "score.h"
+#include "entity_tables.h"
 #include <iostream>
 
 // ===================== COIN CLASS IMPLEMENTATION =====================
 
-Coin::Coin(int startX, int groundY, int coinSpeed, CoinType coinType) {
-    x = startX;
-    speed = coinSpeed;
-    active = true;
-    collected = false;
-    type = coinType;
-    animFrame = 0;
-    animSpeed = 0.15f;
-    rotation = 0;
-    scale = 1.0f;
-    scalingUp = true;
-    glowIntensity = 0.0f;
-
-    setupCoin(groundY);
+void Coin::spawn(Archetype& arch, int row, int groundY, CoinType type, int lift) {
+    const CoinParams& p = COIN_TYPES[type];
+
+    arch.y(row) = (float)(groundY - lift);
+    arch.width(row) = (Sint16)p.size;
+    arch.height(row) = (Sint16)p.size;
+    arch.kind(row) = (Uint8)type;
+    arch.flags(row) = ENTITY_ALIVE | ENTITY_COLLECTIBLE;
 }
 
-void Coin::setupCoin(int groundY) {
-    if (type == SILVER_COIN) {
-        value = 5;
-        width = 22; height = 22;
-        y = groundY - 60;
-    }
-    else if (type == GOLD_COIN) {
-        value = 20;
-        width = 28; height = 28;
-        y = groundY - 130;
-    }
-    else if (type == XP_COIN) {
-        value = 0;
-        xpValue = 25;
-        width = 24; height = 24;
-        y = groundY - 90;
-    }
-    else { // NORMAL_COIN
-        value = 10;
-        width = 20; height = 20;
-        int heightLevel = rand() % 3;
-        if (heightLevel == 0) y = groundY - 70;
-        else if (heightLevel == 1) y = groundY - 100;
-        else y = groundY - 120;
-    }
+int Coin::getValue(CoinType type) {
+    return COIN_TYPES[type].value;
 }
 
-void Coin::update() {
-    x -= speed;
-    animFrame += animSpeed;
-    rotation += 2.0f;
-    if (rotation >= 360) rotation = 0;
-
-    // Pulsing scale effect
-    if (scalingUp) {
-        scale += 0.02f;
-        if (scale >= 1.2f) scalingUp = false;
-    } else {
-        scale -= 0.02f;
-        if (scale <= 0.8f) scalingUp = true;
-    }
+int Coin::getXpValue(CoinType type) {
+    return COIN_TYPES[type].xpValue;
+}
 
-    // Glow effect
-    glowIntensity = 0.5f + 0.5f * sin(animFrame * 2.0f);
+int Coin::getSize(CoinType type) {
+    return COIN_TYPES[type].size;
+}
 
-    if (x + width < 0) active = false;
+// Nhịp scale 0.8..1.2, bước 0.02 mỗi frame, bắt đầu từ 1.0 đang tăng
+float Coin::scaleAt(float age) {
+    float u = fmodf(age + 10.0f, 40.0f);
+    float tri = u < 20.0f ? u - 10.0f : 30.0f - u;
+    return 1.0f + 0.02f * tri;
 }
 
-void Coin::render(SDL_Renderer* renderer) {
-    if (active && !collected) {
-        // Floating animation
-        float floatOffset = sin(animFrame) * 5.0f;
-        int currentY = y + (int)floatOffset;
+void Coin::render(SDL_Renderer* renderer, const RenderItem& item, TextureAtlas* atlas, const CoinSprites* sprites) {
+    CoinType type = (CoinType)item.kind;
+    float animFrame = animFrameAt(item.age);
+    float scale = scaleAt(item.age);
+    float glow = glowAt(item.age);
+    float rotation = rotationAt(item.age);
+
+    // Floating animation
+    float floatOffset = lutSin(animFrame) * 5.0f;
+    int currentY = item.y + (int)floatOffset;
+
+    // Calculate scaled dimensions
+    int scaledWidth = (int)(item.width * scale);
+    int scaledHeight = (int)(item.height * scale);
+    int drawX = item.x + (item.width - scaledWidth) / 2;
+    int drawY = currentY - scaledHeight + (item.height - scaledHeight) / 2;
+
+    if (atlas && sprites && sprites->body[type].valid()) {
+        renderSprites(*atlas, *sprites, type, glow, rotation, drawX, drawY, scaledWidth, scaledHeight);
+        return;
+    }
+
+    // Render glow effect
+    renderGlow(renderer, type, glow, drawX, drawY, scaledWidth, scaledHeight);
 
-        // Calculate scaled dimensions
-        int scaledWidth = (int)(width * scale);
-        int scaledHeight = (int)(height * scale);
-        int drawX = x + (width - scaledWidth) / 2;
-        int drawY = currentY - scaledHeight + (height - scaledHeight) / 2;
+    // Render coin body
+    renderCoinBody(renderer, type, drawX, drawY, scaledWidth, scaledHeight);
 
-        // Render glow effect
-        renderGlow(renderer, drawX, drawY, scaledWidth, scaledHeight);
+    // Render shine effect
+    renderShine(renderer, rotation, drawX, drawY, scaledWidth, scaledHeight);
+}
+
+void Coin::renderSprites(TextureAtlas& atlas, const CoinSprites& sprites, CoinType type,
+                         float glow, float rotation, int x, int y, int w, int h) {
+    // Cùng bố cục với renderGlow/renderCoinBody/renderShine nhưng mỗi phần là một lần copy từ atlas
+    SDL_Rect glowDst = {x - GLOW_MARGIN, y - GLOW_MARGIN, w + 2 * GLOW_MARGIN + 1, h + 2 * GLOW_MARGIN + 1};
+    atlas.draw(sprites.glow[type], glowDst, (Uint8)(255 * glow));
+
+    SDL_Rect bodyDst = {x, y, w + 1, h + 1};
+    atlas.draw(sprites.body[type], bodyDst);
 
-        // Render coin body
-        renderCoinBody(renderer, drawX, drawY, scaledWidth, scaledHeight);
+    float shineAngle = rotation * M_PI / 180.0f;
+    int shineX = x + w/2 + (int)(lutCos(shineAngle) * (w/4));
+    int shineY = y + h/2 + (int)(lutSin(shineAngle) * (h/4));
+    int shineSize = w/4;
+    SDL_Rect shineDst = {shineX - shineSize, shineY - shineSize, 2 * shineSize + 1, 2 * shineSize + 1};
+    atlas.draw(sprites.shine, shineDst, 200);
 
-        // Render shine effect
-        renderShine(renderer, drawX, drawY, scaledWidth, scaledHeight);
+    int spotSize = shineSize/2;
+    for (int i = 0; i < 2; i++) {
+        float spotAngle = shineAngle + M_PI + (i * M_PI/2);
+        int spotX = x + w/2 + (int)(lutCos(spotAngle) * (w/3));
+        int spotY = y + h/2 + (int)(lutSin(spotAngle) * (h/3));
+        SDL_Rect spotDst = {spotX - spotSize, spotY - spotSize, 2 * spotSize + 1, 2 * spotSize + 1};
+        atlas.draw(sprites.shine, spotDst, 150);
     }
 }
 
-void Coin::renderGlow(SDL_Renderer* renderer, int x, int y, int w, int h) {
-    SDL_Color glowColor;
-    int baseAlpha = (int)(80 * glowIntensity);
-
-    switch (type) {
-        case SILVER_COIN:
-            glowColor = {200, 200, 255, (Uint8)baseAlpha};
-            break;
-        case GOLD_COIN:
-            glowColor = {255, 255, 100, (Uint8)baseAlpha};
-            break;
-        case XP_COIN:
-            glowColor = {200, 100, 255, (Uint8)baseAlpha};
-            break;
-        default: // NORMAL_COIN
-            glowColor = {255, 220, 100, (Uint8)baseAlpha};
-            break;
+void Coin::bakeSprites(TextureAtlas& atlas, CoinSprites& sprites) {
+    for (int i = 0; i < COIN_TYPE_COUNT; i++) {
+        CoinType t = (CoinType)i;
+        int size = (int)ceil(getSize(t) * 1.2f); // Kích thước lớn nhất của nhịp scale
+
+        sprites.body[t] = atlas.bake(size + 1, size + 1, [t, size](SDL_Renderer* r) {
+            SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_BLEND);
+            renderCoinBody(r, t, 0, 0, size, size);
+        });
+
+        // Quầng sáng ghi thẳng alpha (không blend) để các vòng giữ đúng màu
+        int glowSize = size + 2 * GLOW_MARGIN + 1;
+        sprites.glow[t] = atlas.bake(glowSize, glowSize, [t, size](SDL_Renderer* r) {
+            SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_NONE);
+            renderGlow(r, t, 1.0f, GLOW_MARGIN, GLOW_MARGIN, size, size);
+        });
     }
 
+    sprites.shine = atlas.bake(33, 33, [](SDL_Renderer* r) {
+        SDL_SetRenderDrawColor(r, 255, 255, 255, 255);
+        fillCircle(r, 16, 16, 16);
+    });
+}
+
+void Coin::renderGlow(SDL_Renderer* renderer, CoinType type, float glow, int x, int y, int w, int h) {
+    SDL_Color glowColor = COIN_TYPES[type].glow;
+    glowColor.a = (Uint8)(int)(80 * glow);
+
     // Draw multiple concentric circles for glow
     for (int i = 3; i >= 1; i--) {
         int glowSize = i * 4;
@@ -117,31 +127,9 @@ void Coin::renderGlow(SDL_Renderer* renderer, int x, int y, int w, int h) {
     }
 }
 
-void Coin::renderCoinBody(SDL_Renderer* renderer, int x, int y, int w, int h) {
-    SDL_Color baseColor, highlightColor, shadowColor;
-
-    switch (type) {
-        case SILVER_COIN:
-            baseColor = {192, 192, 192, 255};
-            highlightColor = {240, 240, 240, 255};
-            shadowColor = {150, 150, 150, 255};
-            break;
-        case GOLD_COIN:
-            baseColor = {255, 215, 0, 255};
-            highlightColor = {255, 255, 150, 255};
-            shadowColor = {205, 175, 0, 255};
-            break;
-        case XP_COIN:
-            baseColor = {138, 43, 226, 255}; // Violet
-            highlightColor = {186, 85, 211, 255}; // Orchid
-            shadowColor = {75, 0, 130, 255}; // Indigo
-            break;
-        default: // NORMAL_COIN
-            baseColor = {255, 200, 0, 255};
-            highlightColor = {255, 255, 100, 255};
-            shadowColor = {205, 150, 0, 255};
-            break;
-    }
+void Coin::renderCoinBody(SDL_Renderer* renderer, CoinType type, int x, int y, int w, int h) {
+    const CoinParams& p = COIN_TYPES[type];
+    SDL_Color baseColor = p.base, highlightColor = p.highlight, shadowColor = p.shadow;
 
     // Main coin body with gradient
     drawGradientCircle(renderer, x + w/2, y + h/2, w/2, baseColor, highlightColor);
@@ -155,11 +143,11 @@ void Coin::renderCoinBody(SDL_Renderer* renderer, int x, int y, int w, int h) {
     drawCircle(renderer, x + w/2, y + h/2, w/3);
 }
 
-void Coin::renderShine(SDL_Renderer* renderer, int x, int y, int w, int h) {
+void Coin::renderShine(SDL_Renderer* renderer, float rotation, int x, int y, int w, int h) {
     // Shine effect based on rotation
     float shineAngle = rotation * M_PI / 180.0f;
-    int shineX = x + w/2 + (int)(cos(shineAngle) * (w/4));
-    int shineY = y + h/2 + (int)(sin(shineAngle) * (h/4));
+    int shineX = x + w/2 + (int)(lutCos(shineAngle) * (w/4));
+    int shineY = y + h/2 + (int)(lutSin(shineAngle) * (h/4));
     int shineSize = w/4;
 
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 200);
@@ -169,8 +157,8 @@ void Coin::renderShine(SDL_Renderer* renderer, int x, int y, int w, int h) {
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 150);
     for (int i = 0; i < 2; i++) {
         float spotAngle = shineAngle + M_PI + (i * M_PI/2);
-        int spotX = x + w/2 + (int)(cos(spotAngle) * (w/3));
-        int spotY = y + h/2 + (int)(sin(spotAngle) * (h/3));
+        int spotX = x + w/2 + (int)(lutCos(spotAngle) * (w/3));
+        int spotY = y + h/2 + (int)(lutSin(spotAngle) * (h/3));
         fillCircle(renderer, spotX, spotY, shineSize/2);
     }
 }
@@ -215,86 +203,114 @@ void Coin::drawGradientCircle(SDL_Renderer* renderer, int cx, int cy, int radius
     }
 }
 
-bool Coin::checkCollision(int px, int py, int pwidth, int pheight) {
-    if (!active || collected) return false;
-
-    // Simple circle-rectangle collision
-    int coinCenterX = x + width/2;
-    int coinCenterY = y - height/2;
-    int coinRadius = width/2;
-
-    int closestX = std::max(px, std::min(coinCenterX, px + pwidth));
-    int closestY = std::max(py - pheight, std::min(coinCenterY, py));
+// ===================== SCORE MANAGER IMPLEMENTATION =====================
 
-    int distanceX = coinCenterX - closestX;
-    int distanceY = coinCenterY - closestY;
+ScoreManager::ScoreManager(EntityRegistry* registry, int ground, const WorldScroll* scroll, int width)
+    : entities(registry), world(scroll), timers(nullptr), atlas(nullptr), sprites(nullptr) {
+    groundY = ground; screenWidth = width;
+    setSpawnWeights(nullptr);
+    reserve(DEFAULT_CAPACITY);
+    reset();
+    srand(time(NULL));
+}
 
-    return (distanceX * distanceX + distanceY * distanceY) <= (coinRadius * coinRadius);
+void ScoreManager::attach(TimerWheel* wheel) {
+    timers = wheel;
+    scheduleTimers();
 }
 
-// ===================== SCORE MANAGER IMPLEMENTATION =====================
+void ScoreManager::scheduleTimers() {
+    if (!timers) return;
+    timers->cancelAll(this);
+    spawnTimer = timers->schedule(spawnInterval, this, TIMER_SPAWN);
+    distanceTimer = timers->schedule(DISTANCE_TICKS, this, TIMER_DISTANCE);
+}
 
-ScoreManager::ScoreManager(int ground, int gameSpeed, int width) {
-    groundY = ground; speed = gameSpeed; screenWidth = width;
-    spawnTimer = 0; spawnInterval = 120;
-    distanceCounter = 0;
-    reset();
-    srand(time(NULL));
+void ScoreManager::reserve(int capacity) {
+    entities->reserve(ARCH_COIN, capacity);
+    int rows = entities->archetype(ARCH_COIN).capacity();
+    hitBatch.reserve(rows);
+    hitRows.reserve(rows);
+    hitMask.reserve(collisionMaskWords(rows));
+    renderList.reserve(rows);
 }
 
 void ScoreManager::reset() {
-    coins.clear();
-    spawnTimer = 0;
+    entities->clear(ARCH_COIN);
+    spawnInterval = 120;
+    autoSpawn = true;
     currentScore = 0; highScore = 0; distanceScore = 0;
-    coinScore = 0; totalCoinsCollected = 0; distanceCounter = 0;
+    coinScore = 0; totalCoinsCollected = 0;
+    scheduleTimers();
 }
 
-void ScoreManager::update(Player& player) {
-    for (auto& coin : coins) {
-        coin.update();
-        if (coin.checkCollision(player.x, player.y, player.width, player.height) && !coin.collected) {
-            coin.collected = true;
-            coin.active = false;
-            coinScore += coin.value;
-            currentScore += coin.value;
-            player.totalCoins++;
-            player.addXp(coin.xpValue);
-            totalCoinsCollected++;
-        }
+void ScoreManager::update(Player& player, EventBus* events) {
+    // Gom xu trong cửa sổ quanh người chơi rồi kiểm tra cả lô một lần
+    double left = world->toWorld(player.x);
+    entities->setCosmeticLine(ARCH_COIN, left);
+    gatherCircles(*entities, ARCH_COIN, *world, left, left + player.width,
+                  ENTITY_ALIVE | ENTITY_COLLECTIBLE, hitBatch, hitRows);
+
+    if (!hitRows.empty()) {
+        hitMask.resize(collisionMaskWords(hitBatch.size()));
+        collideCircles(hitBatch, CollisionRect::fromRect(player.x, player.y - player.height, player.width, player.height),
+                       hitMask.data());
+    }
+    Archetype& arch = entities->archetype(ARCH_COIN);
+    for (int i = 0; i < (int)hitRows.size(); i++) {
+        if (!collisionMaskTest(hitMask.data(), i)) continue;
+        int row = hitRows[i];
+        CoinType type = (CoinType)arch.kind(row);
+        int value = Coin::getValue(type);
+        arch.flags(row) = (arch.flags(row) | ENTITY_COLLECTED) & ~ENTITY_ALIVE;
+        coinScore += value;
+        currentScore += value;
+        player.totalCoins++;
+        player.addXp(Coin::getXpValue(type));
+        totalCoinsCollected++;
+        if (events) events->publish(GameEvent::coinCollected(type, value));
     }
-    coins.erase(std::remove_if(coins.begin(), coins.end(), [](const Coin& c) { return !c.active; }), coins.end());
+    runScrollSystem(*entities, ARCH_COIN, *world, false);
+    if (currentScore > highScore) highScore = currentScore;
+}
 
-    spawnTimer++;
-    if (spawnTimer >= spawnInterval) {
-        spawnCoin();
-        spawnTimer = 0;
+void ScoreManager::onTimer(int timerId) {
+    if (timerId == TIMER_SPAWN) {
+        if (autoSpawn) spawnCoin();
         spawnInterval = 100 + (rand() % 80);
+        spawnTimer = timers->schedule(spawnInterval, this, TIMER_SPAWN);
+    } else if (timerId == TIMER_DISTANCE) {
+        distanceScore++; currentScore++;
+        if (currentScore > highScore) highScore = currentScore;
+        distanceTimer = timers->schedule(DISTANCE_TICKS, this, TIMER_DISTANCE);
     }
+}
 
-    distanceCounter++;
-    if (distanceCounter >= 30) {
-        distanceScore++; currentScore++; distanceCounter = 0;
-    }
-    if (currentScore > highScore) highScore = currentScore;
+void ScoreManager::setSpawnWeights(const CoinWeights* weights) {
+    typePicker.build((weights ? *weights : DEFAULT_COIN_WEIGHTS).weights);
 }
 
 void ScoreManager::spawnCoin() {
-    int randVal = rand() % 100;
-    CoinType type = NORMAL_COIN;
-    if (randVal < 45) type = NORMAL_COIN;
-    else if (randVal < 70) type = SILVER_COIN;
-    else if (randVal < 85) type = GOLD_COIN;
-    else type = XP_COIN;
-    coins.emplace_back(screenWidth, groundY, speed, type);
+    LibcRandom rng;
+    CoinType type = (CoinType)typePicker.sample(rng);
+    spawnCoinAt(world->toWorld(screenWidth), type, rollCoinLift(type, rng));
+}
+
+void ScoreManager::spawnCoinAt(double worldX, CoinType type, int lift) {
+    int row = entities->create(ARCH_COIN, worldX);
+    if (row < 0) return;
+    Coin::spawn(entities->archetype(ARCH_COIN), row, groundY, type, lift);
+    entities->noteWidth(ARCH_COIN, Coin::getSize(type));
 }
 
 void ScoreManager::render(SDL_Renderer* renderer) {
-    for (auto& coin : coins) coin.render(renderer);
+    buildRenderList(*entities, ARCH_COIN, *world, screenWidth, renderList);
+    for (const RenderItem& item : renderList) Coin::render(renderer, item, atlas, sprites);
 }
 
-void ScoreManager::setSpeed(int newSpeed) {
-    speed = newSpeed;
-    for (auto& coin : coins) coin.speed = newSpeed;
+void ScoreManager::setSprites(TextureAtlas* textureAtlas, const CoinSprites* coinSprites) {
+    atlas = textureAtlas;
+    sprites = coinSprites;
 }
 
 int ScoreManager::getCurrentScore() const {
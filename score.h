@@ -8,70 +8,121 @@
 #include <algorithm>
 #include <cmath>
 #include "player.h"
+#include "texture_atlas.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
+#include "world_scroll.h"
+#include "ecs.h"
+#include "collision_kernels.h"
+#include "alias_table.h"
 
 enum CoinType {
     NORMAL_COIN,
     SILVER_COIN,
     GOLD_COIN,
-    XP_COIN
+    XP_COIN,
+    COIN_TYPE_COUNT
 };
 
+// Trọng số sinh theo CoinType (mặc định lấy từ COIN_TYPES; level có thể thay)
+struct CoinWeights {
+    int weights[COIN_TYPE_COUNT];
+};
+
+// Sprite coin vẽ sẵn vào atlas một lần thay cho vẽ từng pixel mỗi frame
+struct CoinSprites {
+    AtlasHandle body[COIN_TYPE_COUNT];
+    AtlasHandle glow[COIN_TYPE_COUNT];
+    AtlasHandle shine;
+};
+
+// Xu là hàng trong archetype ARCH_COIN (kind = CoinType); lớp này chỉ giữ
+// luật sinh, giá trị và cách vẽ. Hiệu ứng (xoay, nhịp scale, quầng sáng)
+// tính thẳng từ tuổi (frame, theo AnimationClock) nên không cần trạng thái riêng.
 class Coin {
 public:
-    int x, y;
-    int width, height;
-    int speed;
-    bool active;
-    bool collected;
-    CoinType type;
-    int value;
-    int xpValue;
-    float animFrame;
-    float animSpeed;
-    float rotation;
-    float scale;
-    bool scalingUp;
-    float glowIntensity;
+    // lift: tâm làn cao hơn mặt đất (rollCoinLift hoặc LevelGenerator)
+    static void spawn(Archetype& arch, int row, int groundY, CoinType type, int lift);
+    static int getValue(CoinType type);
+    static int getXpValue(CoinType type);
+    static int getSize(CoinType type);
 
-    // Constructor
-    Coin(int startX, int groundY, int coinSpeed, CoinType coinType = NORMAL_COIN);
+    static void render(SDL_Renderer* renderer, const RenderItem& item,
+                       TextureAtlas* atlas = nullptr, const CoinSprites* sprites = nullptr);
 
-    // Public methods
-    void update();
-    void render(SDL_Renderer* renderer);
-    bool checkCollision(int px, int py, int pwidth, int pheight);
+    static void bakeSprites(TextureAtlas& atlas, CoinSprites& sprites);
 
 private:
+    static const int GLOW_MARGIN = 12;  // Quầng sáng rộng hơn thân coin mỗi phía
+
+    // Trạng thái hiệu ứng ở tuổi age (frame)
+    static float animFrameAt(float age) { return age * 0.15f; }
+    static float rotationAt(float age) { return fmodf(age * 2.0f, 360.0f); }
+    static float scaleAt(float age);
+    static float glowAt(float age) { return 0.5f + 0.5f * lutSin(animFrameAt(age) * 2.0f); }
+
     // Private helper methods
-    void setupCoin(int groundY);
-    void renderGlow(SDL_Renderer* renderer, int x, int y, int w, int h);
-    void renderCoinBody(SDL_Renderer* renderer, int x, int y, int w, int h);
-    void renderShine(SDL_Renderer* renderer, int x, int y, int w, int h);
-    void drawCircle(SDL_Renderer* renderer, int cx, int cy, int radius);
-    void fillCircle(SDL_Renderer* renderer, int cx, int cy, int radius);
-    void drawGradientCircle(SDL_Renderer* renderer, int cx, int cy, int radius,
-                          SDL_Color centerColor, SDL_Color edgeColor);
+    static void renderSprites(TextureAtlas& atlas, const CoinSprites& sprites, CoinType type,
+                              float glow, float rotation, int x, int y, int w, int h);
+    static void renderGlow(SDL_Renderer* renderer, CoinType type, float glow, int x, int y, int w, int h);
+    static void renderCoinBody(SDL_Renderer* renderer, CoinType type, int x, int y, int w, int h);
+    static void renderShine(SDL_Renderer* renderer, float rotation, int x, int y, int w, int h);
+    static void drawCircle(SDL_Renderer* renderer, int cx, int cy, int radius);
+    static void fillCircle(SDL_Renderer* renderer, int cx, int cy, int radius);
+    static void drawGradientCircle(SDL_Renderer* renderer, int cx, int cy, int radius,
+                                   SDL_Color centerColor, SDL_Color edgeColor);
 };
 
-class ScoreManager {
+// Mặt tiền của archetype ARCH_COIN: điểm số, timer spawn, nhặt xu, vẽ
+class ScoreManager : public TimerListener {
 public:
     int currentScore, highScore, distanceScore, coinScore, totalCoinsCollected;
-    std::vector<Coin> coins;
-    int spawnTimer, spawnInterval, groundY, speed, screenWidth, distanceCounter;
+    TimerHandle spawnTimer, distanceTimer;
+    int spawnInterval, groundY, screenWidth;
+    bool autoSpawn;  // false: xu do BeatScheduler gọi spawnCoin()
 
     // Constructor
-    ScoreManager(int ground, int gameSpeed, int width);
+    ScoreManager(EntityRegistry* registry, int ground, const WorldScroll* scroll, int width);
+
+    // Hẹn timer spawn xu và điểm quãng đường (gọi lại sau mỗi lần tạo mới ScoreManager)
+    void attach(TimerWheel* wheel);
+    // Sức chứa archetype và bộ đệm va chạm; chỉ tăng, gọi lúc vào level
+    void reserve(int capacity);
+    // Bảng trọng số loại xu của level (nullptr: mặc định)
+    void setSpawnWeights(const CoinWeights* weights);
 
     // Public methods
-    void reset();
-    void update(Player& player);
+    void reset();   // Giữ sức chứa
+    void update(Player& player, EventBus* events = nullptr);
     void render(SDL_Renderer* renderer);
-    void setSpeed(int newSpeed);
     int getCurrentScore() const;
+    void spawnCoin();
+    // Xu đã chọn sẵn (LevelGenerator) ở worldX
+    void spawnCoinAt(double worldX, CoinType type, int lift);
+    void onTimer(int timerId) override;
+
+    // Vẽ coin từ atlas; gọi lại sau mỗi lần tạo mới ScoreManager
+    void setSprites(TextureAtlas* textureAtlas, const CoinSprites* coinSprites);
 
 private:
-    // Private helper methods
-    void spawnCoin();
+    enum { TIMER_SPAWN, TIMER_DISTANCE };
+    static const int DISTANCE_TICKS = 30;   // +1 điểm mỗi 30 frame
+    static const int DEFAULT_CAPACITY = 32;
+
+    void scheduleTimers();
+
+    EntityRegistry* entities;
+    const WorldScroll* world;
+    TimerWheel* timers;
+    TextureAtlas* atlas;
+    const CoinSprites* sprites;
+    AliasTable<COIN_TYPE_COUNT> typePicker;
+
+    // Bộ đệm kiểm tra nhặt xu theo lô và danh sách vẽ
+    CircleBatch hitBatch;
+    std::vector<int> hitRows;
+    std::vector<Uint32> hitMask;
+    std::vector<RenderItem> renderList;
 };
 
 #endif // SCORE_H_INCLUDED
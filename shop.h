@@ -8,21 +8,31 @@
 #include <string>
 #include <functional>
 #include <iostream>
+#include <cstring>
 #include "player.h"
 #include "ui_renderer.h"
+#include "asset_loader.h"
+#include "texture_atlas.h"
+#include "skin_cache.h"
+#include "content_db.h"
 
+// Mọi dino dùng chung một ảnh gốc xám; mỗi skin chỉ khác SkinPalette
+static const char* DINO_BASE_SPRITE = "image/dino_base.png";
+
+SDL_COMPILE_TIME_ASSERT(shop_palette_keys, SKIN_PALETTE_KEYS == CONTENT_PALETTE_KEYS);
+
+// Tên, giá, ảnh gốc và palette nằm trong content DB (ShopItemDef)
 struct ShopItem {
-    int id;
-    std::string name;
-    std::string description;
-    int price;
+    const ShopItemDef* def;
     bool isOwned;
-    SDL_Texture* texture;
-    SDL_Texture* previewTexture;
 
-    ShopItem(int itemId, const std::string& itemName, const std::string& desc, int itemPrice)
-        : id(itemId), name(itemName), description(desc), price(itemPrice),
-          isOwned(false), texture(nullptr), previewTexture(nullptr) {}
+    explicit ShopItem(const ShopItemDef& itemDef) : def(&itemDef), isOwned(false) {}
+
+    int id() const { return def->id; }
+    int price() const { return def->price; }
+    const char* name() const { return gameContent().text(def->name); }
+    const char* description() const { return gameContent().text(def->description); }
+    const char* baseSprite() const { return gameContent().text(def->baseSprite); }
 };
 
 class Shop {
@@ -30,45 +40,49 @@ public:
     std::vector<ShopItem> items;
     int selectedIndex;
     int scrollOffset;
+    SkinCache skins;
 
     Shop() : selectedIndex(0), scrollOffset(0) {}
 
-    void initialize(SDL_Renderer* renderer) {
+    // Skin không nạp ở đây: skin trang bị nạp qua requestEquippedSkin(),
+    // thumbnail nạp khi mở shop (onOpen)
+    void initialize(SDL_Renderer* renderer, TextureAtlas* atlas, AssetLoader* loader, size_t textureBudget) {
+        const ContentDB& content = gameContent();
         items.clear();
-        items.emplace_back(0, "Red Dragon", "Fierce red dragon", 100);
-        items.emplace_back(1, "Blue Raptor", "Fast blue raptor", 150);
-        items.emplace_back(2, "Golden Rex", "Legendary golden T-Rex", 300);
-        items.emplace_back(3, "Purple Ghost", "Mysterious ghost dino", 200);
-        items.emplace_back(4, "Green Turtle", "Slow but steady", 80);
-        items.emplace_back(5, "Rainbow Dino", "Colorful party dino", 500);
+        items.reserve(content.shopItemCount());
+        for (int i = 0; i < content.shopItemCount(); i++) items.push_back(ShopItem(content.shopItem(i)));
 
         items[0].isOwned = true;
-        loadTextures(renderer);
+
+        skins.initialize(renderer, atlas, loader, textureBudget);
+        for (const auto& item : items) {
+            SkinPalette palette;
+            memcpy(palette.keys, item.def->palette, sizeof(palette.keys));
+            skins.addSkin(item.baseSprite(), palette);
+        }
     }
 
-    void loadTextures(SDL_Renderer* renderer) {
-        const char* skinFiles[] = { "image/dino_red.png", "image/dino_blue.png", "image/dino_gold.png", "image/dino_purple.png", "image/dino_green.png", "image/dino_pink.png"};
-        SDL_Color skinColors[] = { {255,50,50,255}, {50,100,255,255}, {255,215,0,255}, {150,50,200,255}, {34,139,34,255}, {255,100,200,255} };
+    void requestEquippedSkin(int index) {
+        skins.pin(index);
+    }
 
-        for (size_t i = 0; i < items.size(); i++) {
-            items[i].texture = IMG_LoadTexture(renderer, skinFiles[i]);
-            if (!items[i].texture) {
-                std::cerr << "Warning: Could not load " << skinFiles[i] << ". Creating fallback texture." << std::endl;
-                items[i].texture = createColoredTexture(renderer, skinColors[i], 40, 60);
-            }
-            items[i].previewTexture = items[i].texture;
-        }
+    void onOpen() {
+        for (size_t i = 0; i < items.size(); i++) skins.request((int)i, SKIN_THUMB);
+        skins.logUsage("shop opened");
+    }
+
+    void onClose() {
+        skins.logUsage("shop closed");
     }
 
-    SDL_Texture* createColoredTexture(SDL_Renderer* renderer, SDL_Color color, int w, int h) {
-        SDL_Texture* tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
-        if (tex) {
-            SDL_SetRenderTarget(renderer, tex);
-            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-            SDL_RenderClear(renderer);
-            SDL_SetRenderTarget(renderer, nullptr);
+    // Vẽ skin ở tier cần dùng; chưa nạp xong thì vẽ ô màu placeholder
+    void drawSkin(SDL_Renderer* renderer, size_t index, SkinTier tier, const SDL_Rect& dst) {
+        if (index >= items.size()) return;
+        if (!skins.draw((int)index, tier, dst)) {
+            const SDL_Color& c = items[index].def->palette[2];
+            SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+            SDL_RenderFillRect(renderer, &dst);
         }
-        return tex;
     }
 
     // Helper function moved to main.cpp, but can be kept here if preferred
@@ -132,13 +146,11 @@ public:
             uiRenderer.drawEnhancedGlassPanel(itemRect, bgColor);
 
             // Preview texture
-            if (items[i].previewTexture) {
-                SDL_Rect pv = {(int)(x + itemWidth/2 - 30), (int)(y + 20), 60, 90};
-                SDL_RenderCopy(renderer, items[i].previewTexture, nullptr, &pv);
-            }
+            SDL_Rect pv = {(int)(x + itemWidth/2 - 30), (int)(y + 20), 60, 90};
+            drawSkin(renderer, i, SKIN_THUMB, pv);
 
             // Item name
-            uiRenderer.renderTextCentered(items[i].name, x + itemWidth/2, y + 125, fontTiny, white);
+            uiRenderer.renderTextCentered(items[i].name(), x + itemWidth/2, y + 125, fontTiny, white);
 
             // Status/Price button
             SDL_FRect statusBtn = {x + 10, y + itemHeight - 40, itemWidth - 20, 30};
@@ -154,12 +166,12 @@ public:
                     btnText = "EQUIP";
                 }
             } else {
-                if (player.totalCoins >= items[i].price) {
+                if (player.totalCoins >= items[i].price()) {
                     btnColor = {50, 150, 255, 255};
                 } else {
                     btnColor = {150, 50, 50, 255};
                 }
-                btnText = "BUY: " + std::to_string(items[i].price);
+                btnText = "BUY: " + std::to_string(items[i].price());
             }
 
             uiRenderer.renderEnhancedButton(statusBtn, hovered, btnText, fontTiny, btnColor);
@@ -187,12 +199,13 @@ public:
                     if (items[i].isOwned) {
                         player.equippedSkinIndex = i;
                         equippedSkinIndex = i;
-                    } else if (player.totalCoins >= items[i].price) {
-                        player.totalCoins -= items[i].price;
+                    } else if (player.totalCoins >= items[i].price()) {
+                        player.totalCoins -= items[i].price();
                         items[i].isOwned = true;
                         player.equippedSkinIndex = i;
                         equippedSkinIndex = i;
                     }
+                    skins.pin(player.equippedSkinIndex);
                     saveCallback();
                     break;
                 }
@@ -202,10 +215,7 @@ public:
     }
 
     void cleanup() {
-        for (auto& item : items) {
-            if (item.texture) { SDL_DestroyTexture(item.texture); item.texture = nullptr; }
-            item.previewTexture = nullptr;
-        }
+        skins.cleanup();
         items.clear();
     }
 };
@@ -0,0 +1,333 @@
+#include "skin_cache.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+// Mức xám ứng với từng màu khoá của SkinPalette
+static const int PALETTE_LEVELS[SKIN_PALETTE_KEYS] = { 0, 64, 128, 192, 255 };
+
+// Thu nhỏ ảnh gốc về cỡ maxSize bằng trung bình vùng (mức xám tính theo
+// trọng số alpha để viền không bị tối). Kết quả là RGBA32, R = G = B = mức xám.
+static SDL_Surface* downscaleBase(SDL_Surface* source, int maxSize) {
+    SDL_Surface* src = SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!src) return nullptr;
+
+    float fit = std::min(1.0f, (float)maxSize / std::max(src->w, src->h));
+    int w = std::max(1, (int)(src->w * fit));
+    int h = std::max(1, (int)(src->h * fit));
+    SDL_Surface* dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (dst) {
+        SDL_LockSurface(src);
+        SDL_LockSurface(dst);
+        for (int y = 0; y < h; y++) {
+            int y0 = y * src->h / h, y1 = std::max(y0 + 1, (y + 1) * src->h / h);
+            Uint8* out = static_cast<Uint8*>(dst->pixels) + y * dst->pitch;
+            for (int x = 0; x < w; x++) {
+                int x0 = x * src->w / w, x1 = std::max(x0 + 1, (x + 1) * src->w / w);
+                long sumV = 0, sumA = 0, count = 0;
+                for (int sy = y0; sy < y1; sy++) {
+                    const Uint8* row = static_cast<const Uint8*>(src->pixels) + sy * src->pitch;
+                    for (int sx = x0; sx < x1; sx++) {
+                        const Uint8* p = row + sx * 4;
+                        sumV += p[0] * p[3];
+                        sumA += p[3];
+                        count++;
+                    }
+                }
+                Uint8 v = sumA ? (Uint8)(sumV / sumA) : 0;
+                out[x * 4 + 0] = v;
+                out[x * 4 + 1] = v;
+                out[x * 4 + 2] = v;
+                out[x * 4 + 3] = (Uint8)(sumA / count);
+            }
+        }
+        SDL_UnlockSurface(dst);
+        SDL_UnlockSurface(src);
+    }
+    SDL_FreeSurface(src);
+    return dst;
+}
+
+// Tô màu ảnh gốc xám qua bảng 256 màu nội suy từ palette
+static SDL_Surface* recolour(SDL_Surface* base, const SkinPalette& palette) {
+    SDL_Color ramp[256];
+    for (int k = 0; k + 1 < SKIN_PALETTE_KEYS; k++) {
+        const SDL_Color& a = palette.keys[k];
+        const SDL_Color& b = palette.keys[k + 1];
+        int from = PALETTE_LEVELS[k], to = PALETTE_LEVELS[k + 1];
+        for (int v = from; v <= to; v++) {
+            float t = (float)(v - from) / (to - from);
+            ramp[v] = { (Uint8)(a.r + (b.r - a.r) * t), (Uint8)(a.g + (b.g - a.g) * t),
+                        (Uint8)(a.b + (b.b - a.b) * t), 255 };
+        }
+    }
+
+    SDL_Surface* out = SDL_CreateRGBSurfaceWithFormat(0, base->w, base->h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!out) return nullptr;
+    for (int y = 0; y < base->h; y++) {
+        const Uint8* src = static_cast<const Uint8*>(base->pixels) + y * base->pitch;
+        Uint8* dst = static_cast<Uint8*>(out->pixels) + y * out->pitch;
+        for (int x = 0; x < base->w; x++) {
+            const SDL_Color& c = ramp[src[x * 4]];
+            dst[x * 4 + 0] = c.r;
+            dst[x * 4 + 1] = c.g;
+            dst[x * 4 + 2] = c.b;
+            dst[x * 4 + 3] = src[x * 4 + 3];
+        }
+    }
+    return out;
+}
+
+// ===================== SKIN CACHE IMPLEMENTATION =====================
+
+SkinCache::SkinCache()
+    : renderer(nullptr), atlas(nullptr), loader(nullptr),
+      budget(0), residentBytes(0), pinnedSkin(-1), useClock(0) {}
+
+void SkinCache::initialize(SDL_Renderer* targetRenderer, TextureAtlas* textureAtlas, AssetLoader* assetLoader, size_t budgetBytes) {
+    cleanup();
+    renderer = targetRenderer;
+    atlas = (textureAtlas && textureAtlas->isReady()) ? textureAtlas : nullptr;
+    loader = assetLoader;
+    budget = budgetBytes;
+}
+
+void SkinCache::cleanup() {
+    for (auto& skin : skins) {
+        for (auto& slot : skin.tiers) release(slot);
+    }
+    for (auto& base : bases) {
+        if (base.surface) SDL_FreeSurface(base.surface);
+    }
+    skins.clear();
+    bases.clear();
+    residentBytes = 0;
+    pinnedSkin = -1;
+}
+
+int SkinCache::addSkin(const char* basePath, const SkinPalette& palette) {
+    SkinEntry entry;
+    entry.base = -1;
+    for (size_t i = 0; i < bases.size(); i++) {
+        if (strcmp(bases[i].path, basePath) == 0) entry.base = (int)i;
+    }
+    if (entry.base < 0) {
+        BaseSprite base;
+        base.path = basePath;
+        base.surface = nullptr;
+        base.loading = false;
+        base.failed = false;
+        bases.push_back(base);
+        entry.base = (int)bases.size() - 1;
+    }
+
+    entry.palette = palette;
+    for (auto& slot : entry.tiers) {
+        slot.texture = nullptr;
+        slot.bytes = 0;
+        slot.lastUsed = 0;
+        slot.waiting = false;
+    }
+    skins.push_back(entry);
+    return (int)skins.size() - 1;
+}
+
+void SkinCache::setBudget(size_t bytes) {
+    budget = bytes;
+    evictFor(0);
+}
+
+void SkinCache::pin(int skin) {
+    pinnedSkin = skin;
+    request(skin, SKIN_FULL);
+}
+
+int SkinCache::tierMaxSize(SkinTier tier) {
+    return tier == SKIN_FULL ? 128 : 64;  // Vẽ ra 100x100 trong game, 60x90 trong shop
+}
+
+bool SkinCache::isResident(const TierSlot& slot) const {
+    return slot.sprite.valid() || slot.texture;
+}
+
+void SkinCache::request(int skin, SkinTier tier) {
+    if (skin < 0 || skin >= (int)skins.size()) return;
+
+    TierSlot& slot = skins[skin].tiers[tier];
+    if (isResident(slot) || slot.waiting) return;
+
+    BaseSprite& base = bases[skins[skin].base];
+    if (base.surface) {
+        createTier(skin, tier);
+        return;
+    }
+    if (base.failed || !loader) return;
+
+    slot.waiting = true;
+    if (!base.loading) {
+        base.loading = true;
+        int baseIndex = skins[skin].base;
+        loader->requestImage(base.path, [this, baseIndex](SDL_Surface* surface) {
+            onBaseLoaded(baseIndex, surface);
+        });
+    }
+}
+
+void SkinCache::onBaseLoaded(int baseIndex, SDL_Surface* surface) {
+    if (baseIndex >= (int)bases.size()) {
+        if (surface) SDL_FreeSurface(surface);
+        return;
+    }
+    BaseSprite& base = bases[baseIndex];
+    base.loading = false;
+    if (surface) {
+        base.surface = downscaleBase(surface, tierMaxSize(SKIN_FULL));
+        SDL_FreeSurface(surface);
+    }
+    if (!base.surface) {
+        std::cerr << "Warning: Could not load " << base.path << ". Keeping placeholder." << std::endl;
+        base.failed = true;
+    }
+
+    for (size_t i = 0; i < skins.size(); i++) {
+        if (skins[i].base != baseIndex) continue;
+        for (int t = 0; t < SKIN_TIER_COUNT; t++) {
+            if (!skins[i].tiers[t].waiting) continue;
+            skins[i].tiers[t].waiting = false;
+            if (base.surface) createTier((int)i, (SkinTier)t);
+        }
+    }
+}
+
+void SkinCache::createTier(int skin, SkinTier tier) {
+    SkinEntry& entry = skins[skin];
+    TierSlot& slot = entry.tiers[tier];
+
+    SDL_Surface* coloured = recolour(bases[entry.base].surface, entry.palette);
+    if (!coloured) return;
+
+    float fit = std::min(1.0f, (float)tierMaxSize(tier) / std::max(coloured->w, coloured->h));
+    int w = std::max(1, (int)(coloured->w * fit));
+    int h = std::max(1, (int)(coloured->h * fit));
+    size_t bytes = (size_t)w * h * 4;
+
+    evictFor(bytes);
+
+    if (atlas) {
+        slot.sprite = atlas->add(coloured, w, h);
+    } else if (w == coloured->w && h == coloured->h) {
+        slot.texture = SDL_CreateTextureFromSurface(renderer, coloured);
+    } else {
+        SDL_Surface* scaled = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+        if (scaled) {
+            SDL_SetSurfaceBlendMode(coloured, SDL_BLENDMODE_NONE);
+            SDL_BlitScaled(coloured, nullptr, scaled, nullptr);
+            slot.texture = SDL_CreateTextureFromSurface(renderer, scaled);
+            SDL_FreeSurface(scaled);
+        }
+    }
+    SDL_FreeSurface(coloured);
+
+    if (!isResident(slot)) {
+        std::cerr << "Warning: No texture memory for skin " << skin << ". Keeping placeholder." << std::endl;
+        return;
+    }
+    slot.bytes = bytes;
+    slot.lastUsed = useClock;
+    residentBytes += bytes;
+}
+
+void SkinCache::release(TierSlot& slot) {
+    if (slot.sprite.valid() && atlas) atlas->remove(slot.sprite);
+    if (slot.texture) SDL_DestroyTexture(slot.texture);
+    slot.sprite = AtlasHandle();
+    slot.texture = nullptr;
+    residentBytes -= std::min(residentBytes, slot.bytes);
+    slot.bytes = 0;
+}
+
+void SkinCache::evictFor(size_t incomingBytes) {
+    while (residentBytes + incomingBytes > budget) {
+        TierSlot* oldest = nullptr;
+        int oldestSkin = -1, oldestTier = 0;
+        for (size_t i = 0; i < skins.size(); i++) {
+            for (int t = 0; t < SKIN_TIER_COUNT; t++) {
+                TierSlot& slot = skins[i].tiers[t];
+                if (!isResident(slot)) continue;
+                if ((int)i == pinnedSkin && t == SKIN_FULL) continue;
+                if (!oldest || slot.lastUsed < oldest->lastUsed) {
+                    oldest = &slot;
+                    oldestSkin = (int)i;
+                    oldestTier = t;
+                }
+            }
+        }
+        if (!oldest) break;  // Chỉ còn skin đang pin: chấp nhận vượt budget
+
+        std::cout << "Skin cache: evicted skin " << oldestSkin
+                  << (oldestTier == SKIN_FULL ? " (full)" : " (thumb)") << std::endl;
+        release(*oldest);
+    }
+}
+
+bool SkinCache::draw(int skin, SkinTier tier, const SDL_Rect& dst) {
+    if (skin < 0 || skin >= (int)skins.size()) return false;
+    useClock++;
+
+    TierSlot* slot = &skins[skin].tiers[tier];
+    if (!isResident(*slot)) {
+        request(skin, tier);
+        // Tạm dùng tier còn lại nếu đã có
+        if (!isResident(*slot)) slot = &skins[skin].tiers[tier == SKIN_FULL ? SKIN_THUMB : SKIN_FULL];
+        if (!isResident(*slot)) return false;
+    }
+
+    slot->lastUsed = useClock;
+    if (slot->sprite.valid()) {
+        atlas->draw(slot->sprite, dst);
+    } else {
+        SDL_RenderCopy(renderer, slot->texture, nullptr, &dst);
+    }
+    return true;
+}
+
+const CollisionMask* SkinCache::getCollisionMask(int skin, int w, int h) {
+    if (skin < 0 || skin >= (int)skins.size()) return nullptr;
+    BaseSprite& base = bases[skins[skin].base];
+    if (!base.surface) return nullptr;
+
+    if (base.mask.getWidth() != w || base.mask.getHeight() != h) {
+        base.mask = CollisionMask::fromAlpha(base.surface, w, h);
+        if (base.mask.empty()) return nullptr;
+        std::cout << "Collision mask for " << base.path << ": " << w << "x" << h << ", "
+                  << base.mask.countSet() * 100 / (w * h) << "% solid, "
+                  << base.mask.getBytes() << " bytes" << std::endl;
+    }
+    return &base.mask;
+}
+
+int SkinCache::getResidentCount() const {
+    int count = 0;
+    for (const auto& skin : skins) {
+        for (const auto& slot : skin.tiers) {
+            if (isResident(slot)) count++;
+        }
+    }
+    return count;
+}
+
+void SkinCache::logUsage(const char* reason) const {
+    size_t baseBytes = 0;
+    for (const auto& base : bases) {
+        if (base.surface) baseBytes += (size_t)base.surface->pitch * base.surface->h;
+    }
+
+    std::cout << "Skin cache (" << reason << "): " << getResidentCount() << " textures, "
+              << residentBytes / 1024 << " KB / " << budget / 1024 << " KB budget, "
+              << bases.size() << " base sprite(s) " << baseBytes / 1024 << " KB";
+    if (atlas) {
+        std::cout << ", atlas " << atlas->getPageCount() << " page(s) = "
+                  << atlas->getPageBytes() / 1024 << " KB VRAM";
+    }
+    std::cout << std::endl;
+}
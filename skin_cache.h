@@ -0,0 +1,101 @@
+#ifndef SKIN_CACHE_H_INCLUDED
+#define SKIN_CACHE_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include "asset_loader.h"
+#include "texture_atlas.h"
+#include "collision_mask.h"
+
+// Mức chi tiết của một skin trong bộ nhớ texture
+enum SkinTier {
+    SKIN_THUMB = 0,  // Ô lưới trong shop
+    SKIN_FULL = 1,   // Nhân vật trong game
+    SKIN_TIER_COUNT
+};
+
+// Bảng màu của một skin: màu tại các mức xám 0, 64, 128, 192, 255 của ảnh
+// gốc, nội suy tuyến tính ở giữa. Mức 128 là màu thân chính.
+static const int SKIN_PALETTE_KEYS = 5;
+
+struct SkinPalette {
+    SDL_Color keys[SKIN_PALETTE_KEYS];
+};
+
+// Nạp skin theo nhu cầu. Mỗi skin = một ảnh gốc xám (dùng chung giữa nhiều
+// skin, decode một lần) + một SkinPalette; texture được tô màu lúc tạo.
+// Chỉ tier nào được vẽ/yêu cầu mới được tạo. Tổng dung lượng texture giữ
+// dưới budget bằng cách bỏ bản ít dùng nhất (LRU); skin đang trang bị được pin.
+class SkinCache {
+public:
+    SkinCache();
+
+    void initialize(SDL_Renderer* renderer, TextureAtlas* atlas, AssetLoader* loader, size_t budgetBytes);
+    void cleanup();
+
+    // basePath chỉ được giữ con trỏ, phải sống lâu hơn cache (chuỗi trong content DB)
+    int addSkin(const char* basePath, const SkinPalette& palette);
+    void setBudget(size_t bytes);
+    void pin(int skin);
+
+    // Tạo tier nếu chưa có; nạp ảnh gốc trước nếu cần
+    void request(int skin, SkinTier tier);
+
+    // Vẽ tier mong muốn, hoặc tier khác nếu mới chỉ có tier đó.
+    // Trả về false khi chưa có gì (đã tự request), người gọi vẽ placeholder.
+    bool draw(int skin, SkinTier tier, const SDL_Rect& dst);
+
+    // Mask va chạm từ alpha của ảnh gốc, co giãn về cỡ vẽ w x h (tạo lần đầu
+    // gọi, dùng chung giữa các skin cùng ảnh). nullptr khi ảnh gốc chưa nạp.
+    const CollisionMask* getCollisionMask(int skin, int w, int h);
+
+    size_t getResidentBytes() const { return residentBytes; }
+    size_t getBudget() const { return budget; }
+    int getResidentCount() const;
+    void logUsage(const char* reason) const;
+
+private:
+    struct TierSlot {
+        AtlasHandle sprite;      // Khi có atlas
+        SDL_Texture* texture;    // Khi không có atlas
+        size_t bytes;
+        Uint64 lastUsed;
+        bool waiting;            // Đang chờ ảnh gốc
+    };
+
+    struct SkinEntry {
+        int base;
+        SkinPalette palette;
+        TierSlot tiers[SKIN_TIER_COUNT];
+    };
+
+    // Ảnh gốc xám, thu nhỏ sẵn về cỡ tier lớn nhất (RGBA32: R = mức xám)
+    struct BaseSprite {
+        const char* path;
+        SDL_Surface* surface;
+        CollisionMask mask;
+        bool loading;
+        bool failed;
+    };
+
+    static int tierMaxSize(SkinTier tier);
+
+    void onBaseLoaded(int base, SDL_Surface* surface);
+    void createTier(int skin, SkinTier tier);
+    void release(TierSlot& slot);
+    void evictFor(size_t incomingBytes);
+    bool isResident(const TierSlot& slot) const;
+
+    SDL_Renderer* renderer;
+    TextureAtlas* atlas;
+    AssetLoader* loader;
+    std::vector<BaseSprite> bases;
+    std::vector<SkinEntry> skins;
+    size_t budget;
+    size_t residentBytes;
+    int pinnedSkin;
+    Uint64 useClock;  // Tăng mỗi lần vẽ, dùng làm thời điểm cho LRU
+};
+
+#endif // SKIN_CACHE_H_INCLUDED
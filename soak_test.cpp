@@ -0,0 +1,140 @@
+#include "soak_test.h"
+#include "game.h"
+#include <iostream>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+static const int SOAK_SCREEN_WIDTH = 800;
+static const int SOAK_SCREEN_HEIGHT = 600;
+static const int FRAMES_PER_HOUR = 60 * 60 * 60;
+static const int SAMPLES = 24;                          // Số lần đo, chia đều cả phiên
+static const size_t RSS_GROWTH_LIMIT = 1024 * 1024;     // Sau mẫu đầu RSS được tăng tối đa 1 MB
+static const double FRAME_TIME_GROWTH = 1.5;            // Mẫu cuối so với mẫu thứ hai (tốc độ đã gần trần)
+static const double FRAME_TIME_SLACK_US = 2.0;          // Bỏ qua nhiễu khi frame chỉ vài µs
+static const int JUMP_PERIOD = 75;                      // Người chơi tự nhảy mỗi ngần này frame
+
+// Bộ nhớ thường trú của tiến trình (byte), 0 nếu không đọc được
+static size_t residentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize;
+#else
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    long pages = 0, resident = 0;
+    int read = std::fscanf(statm, "%ld %ld", &pages, &resident);
+    std::fclose(statm);
+    return read == 2 ? (size_t)resident * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#endif
+}
+
+static int totalCapacity(EntityRegistry& entities) {
+    return entities.archetype(ARCH_OBSTACLE).capacity() + entities.archetype(ARCH_COIN).capacity() +
+           entities.archetype(ARCH_POWERUP).capacity();
+}
+
+// Game thật không cửa sổ (Game::initializeHeadless), mỗi frame gọi đúng Game::update
+bool runSoakTest(double hours) {
+    long long totalFrames = (long long)(hours * FRAMES_PER_HOUR);
+    if (totalFrames < SAMPLES) {
+        std::cerr << "Soak test: session too short (" << hours << " h)" << std::endl;
+        return false;
+    }
+    long long sampleFrames = totalFrames / SAMPLES;
+
+    Game game(SOAK_SCREEN_WIDTH, SOAK_SCREEN_HEIGHT, true);
+    if (!game.initializeHeadless()) return false;
+    game.invulnerable = true;
+    game.startEndless();
+    game.mapTheme.setTheme(VOLCANO);   // Theme nhiều particle nhất
+    bool generated = game.levelGenerator.isRunning();
+
+    std::cout << "Soak test: " << hours << " h (" << totalFrames << " frames), "
+              << (generated ? "generated" : "timer") << " spawns" << std::endl;
+
+    SDL_Event jump;
+    SDL_zero(jump);
+    jump.type = SDL_KEYDOWN;
+    jump.key.keysym.sym = SDLK_SPACE;
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    double frameMicros[SAMPLES];
+    size_t rss[SAMPLES];
+    int capacityAfterFirst = 0;
+    int maxParticles = 0;
+    long long rebases = 0, stalls = 0;
+    bool ok = true;
+
+    for (int sample = 0; sample < SAMPLES && game.state == GameState::PLAYING; sample++) {
+        Uint64 begin = SDL_GetPerformanceCounter();
+        Uint64 stalled = 0;
+        for (long long f = 0; f < sampleFrames; f++) {
+            // Người chơi tự nhảy qua đúng đường input của bàn phím
+            if (game.player.isOnGround && game.animClock.now() % JUMP_PERIOD == 0) game.handlePlayingInput(jump);
+
+            // Không giới hạn 60 fps nên có thể vượt worker: chờ (không tính vào thời gian frame)
+            // để màn luôn đủ vật như khi chơi thật
+            while (!game.levelGenerator.isAhead(game.world.toWorld(SOAK_SCREEN_WIDTH) + DifficultyManager::ENDLESS_MAX_SPEED)) {
+                Uint64 waitBegin = SDL_GetPerformanceCounter();
+                SDL_Delay(1);
+                stalled += SDL_GetPerformanceCounter() - waitBegin;
+                stalls++;
+            }
+
+            double offset = game.world.getOffset();
+            game.update();
+            if (game.world.getOffset() < offset) rebases++;
+            if (game.mapTheme.getParticleCount() > maxParticles) maxParticles = game.mapTheme.getParticleCount();
+        }
+        Uint64 elapsed = SDL_GetPerformanceCounter() - begin - stalled;
+        frameMicros[sample] = elapsed * 1e6 / frequency / sampleFrames;
+        rss[sample] = residentBytes();
+        if (sample == 0) capacityAfterFirst = totalCapacity(game.entities);
+
+        std::cout << "Soak " << hours * (sample + 1) / SAMPLES << " h: rss " << rss[sample] / 1024
+                  << " KB, frame " << frameMicros[sample] << " us, speed " << game.difficultyManager.getSpeed()
+                  << ", offset " << (long long)game.world.getOffset() << ", score " << game.scoreManager.getCurrentScore()
+                  << ", best combo " << game.comboSystem.getMaxCombo() << std::endl;
+    }
+    if (game.state != GameState::PLAYING) {
+        std::cerr << "Soak test: game left the PLAYING state" << std::endl;
+        return false;
+    }
+    game.levelGenerator.stop();
+
+    std::cout << "Soak test: " << game.ignoredHits << " obstacle hits ignored, " << rebases << " rebases, "
+              << stalls << " waits for the generator, peak " << maxParticles << " particles" << std::endl;
+
+    if (rss[0] && rss[SAMPLES - 1] > rss[0] + RSS_GROWTH_LIMIT) {
+        std::cerr << "Soak test: RSS grew from " << rss[0] / 1024 << " KB to " << rss[SAMPLES - 1] / 1024 << " KB" << std::endl;
+        ok = false;
+    }
+    if (frameMicros[SAMPLES - 1] > frameMicros[1] * FRAME_TIME_GROWTH + FRAME_TIME_SLACK_US) {
+        std::cerr << "Soak test: frame time grew from " << frameMicros[1] << " us to "
+                  << frameMicros[SAMPLES - 1] << " us" << std::endl;
+        ok = false;
+    }
+    if (totalCapacity(game.entities) != capacityAfterFirst) {
+        std::cerr << "Soak test: entity pools grew from " << capacityAfterFirst << " to "
+                  << totalCapacity(game.entities) << " rows" << std::endl;
+        ok = false;
+    }
+    if (maxParticles > MapTheme::MAX_PARTICLES || game.world.getOffset() >= WorldScroll::REBASE_DISTANCE) {
+        std::cerr << "Soak test: particles or scroll offset not bounded" << std::endl;
+        ok = false;
+    }
+    if (game.difficultyManager.getSpeed() > DifficultyManager::ENDLESS_MAX_SPEED) {
+        std::cerr << "Soak test: speed " << game.difficultyManager.getSpeed() << " passed the endless cap" << std::endl;
+        ok = false;
+    }
+
+    std::cout << "Soak test: " << (ok ? "passed" : "FAILED") << std::endl;
+    return ok;
+}
@@ -0,0 +1,11 @@
+#ifndef SOAK_TEST_H_INCLUDED
+#define SOAK_TEST_H_INCLUDED
+
+// Chạy chế độ endless không cửa sổ trong `hours` giờ game (60 frame/giây, chạy
+// nhanh hết mức) qua đúng Game::update: sinh màn, cuộn, dời gốc, va chạm,
+// power-up, combo, quest, achievement, particle môi trường; âm thanh và vẽ là
+// no-op. Người chơi tự nhảy đều đặn và không chết. Trả false nếu bộ nhớ (RSS), sức chứa
+// pool hay thời gian trung bình mỗi frame tăng dần theo thời gian chơi.
+bool runSoakTest(double hours);
+
+#endif // SOAK_TEST_H_INCLUDED
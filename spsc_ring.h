@@ -0,0 +1,80 @@
+#ifndef SPSC_RING_H_INCLUDED
+#define SPSC_RING_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+
+// Hàng đợi vòng một producer / một consumer, không khoá và không cấp phát.
+// Mỗi phía chỉ ghi chỉ số của mình; SDL_AtomicGet/Set là full barrier nên
+// phần tử được ghi xong trước khi consumer thấy head mới.
+// CAPACITY phải là luỹ thừa của 2.
+template <typename T, int CAPACITY>
+class SpscRing {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() {
+        SDL_AtomicSet(&head, 0);
+        SDL_AtomicSet(&tail, 0);
+    }
+
+    // Chỉ gọi từ producer. Trả về false khi đầy (phần tử bị bỏ)
+    bool push(const T& item) {
+        unsigned h = (unsigned)SDL_AtomicGet(&head);
+        unsigned t = (unsigned)SDL_AtomicGet(&tail);
+        if (h - t >= (unsigned)CAPACITY) return false;
+        items[h & (CAPACITY - 1)] = item;
+        SDL_AtomicSet(&head, (int)(h + 1));
+        return true;
+    }
+
+    // Chỉ gọi từ consumer
+    bool pop(T& item) {
+        unsigned t = (unsigned)SDL_AtomicGet(&tail);
+        unsigned h = (unsigned)SDL_AtomicGet(&head);
+        if (t == h) return false;
+        item = items[t & (CAPACITY - 1)];
+        SDL_AtomicSet(&tail, (int)(t + 1));
+        return true;
+    }
+
+    // Ghi/đọc theo khối (PCM). Trả về số phần tử thực sự ghi/đọc được
+    int write(const T* src, int count) {
+        unsigned h = (unsigned)SDL_AtomicGet(&head);
+        unsigned t = (unsigned)SDL_AtomicGet(&tail);
+        int n = std::min(count, CAPACITY - (int)(h - t));
+        int start = (int)(h & (CAPACITY - 1));
+        int first = std::min(n, CAPACITY - start);
+        std::copy(src, src + first, items + start);
+        std::copy(src + first, src + n, items);
+        SDL_AtomicSet(&head, (int)(h + n));
+        return n;
+    }
+
+    int read(T* dst, int count) {
+        unsigned t = (unsigned)SDL_AtomicGet(&tail);
+        unsigned h = (unsigned)SDL_AtomicGet(&head);
+        int n = std::min(count, (int)(h - t));
+        int start = (int)(t & (CAPACITY - 1));
+        int first = std::min(n, CAPACITY - start);
+        std::copy(items + start, items + start + first, dst);
+        std::copy(items, items + (n - first), dst + first);
+        SDL_AtomicSet(&tail, (int)(t + n));
+        return n;
+    }
+
+    int size() const {
+        unsigned h = (unsigned)SDL_AtomicGet(const_cast<SDL_atomic_t*>(&head));
+        unsigned t = (unsigned)SDL_AtomicGet(const_cast<SDL_atomic_t*>(&tail));
+        return (int)(h - t);
+    }
+
+    int capacity() const { return CAPACITY; }
+
+private:
+    T items[CAPACITY];
+    SDL_atomic_t head;  // Producer ghi
+    SDL_atomic_t tail;  // Consumer ghi
+};
+
+#endif // SPSC_RING_H_INCLUDED
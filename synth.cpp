@@ -0,0 +1,207 @@
+#include "synth.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+// wave, startFreq, endFreq, step, stepTime, duration, attack, noiseMix, volume
+const Synth::PatchDef Synth::PATCHES[PATCH_COUNT] = {
+    { WAVE_SQUARE,   300.0f,  600.0f, false, 0.0f,  0.12f, 0.003f, 0.0f, 0.22f },  // JUMP
+    { WAVE_SQUARE,   988.0f, 1319.0f, true,  0.05f, 0.22f, 0.002f, 0.0f, 0.18f },  // COIN
+    { WAVE_TRIANGLE, 220.0f,  880.0f, false, 0.0f,  0.45f, 0.020f, 0.0f, 0.35f },  // SHIELD
+    { WAVE_SINE,     160.0f,   40.0f, false, 0.0f,  0.70f, 0.010f, 0.6f, 0.45f }   // METEOR
+};
+
+// std::min trong mix() nhận tham chiếu nên cần định nghĩa ngoài lớp
+const int Synth::SYNTH_BLOCK;
+
+// ===================== SYNTH IMPLEMENTATION =====================
+
+Synth::Synth()
+    : sampleRate(0), channels(0), voiceOrder(0), running(false),
+      triggeredCount(0), droppedCount(0) {
+    for (auto& voice : voices) voice.active = false;
+    SDL_AtomicSet(&stolenCount, 0);
+}
+
+Synth::~Synth() {
+    stop();
+}
+
+bool Synth::start() {
+    int frequency, deviceChannels;
+    Uint16 format;
+    if (!Mix_QuerySpec(&frequency, &format, &deviceChannels)) {
+        std::cerr << "Synth: audio device not open" << std::endl;
+        return false;
+    }
+    if (format != AUDIO_S16SYS || deviceChannels < 1) {
+        std::cerr << "Synth: unsupported device format " << format << ", using sampled effects" << std::endl;
+        return false;
+    }
+
+    sampleRate = frequency;
+    channels = deviceChannels;
+    for (auto& voice : voices) voice.active = false;
+    Mix_SetPostMix(postMix, this);
+    running = true;
+    return true;
+}
+
+void Synth::stop() {
+    if (!running) return;
+    Mix_SetPostMix(nullptr, nullptr);  // Khoá audio bên trong, callback đã dừng khi trả về
+    running = false;
+}
+
+bool Synth::trigger(SynthPatch patch, float pitch, float gain) {
+    if (!running || patch < 0 || patch >= PATCH_COUNT) return false;
+
+    SynthCommand cmd = { patch, pitch, gain };
+    if (!commands.push(cmd)) {
+        droppedCount++;
+        return false;
+    }
+    triggeredCount++;
+    return true;
+}
+
+void Synth::postMix(void* udata, Uint8* stream, int len) {
+    Synth* synth = static_cast<Synth*>(udata);
+    synth->mix(reinterpret_cast<Sint16*>(stream), len / (int)(sizeof(Sint16) * synth->channels));
+}
+
+void Synth::startVoice(const SynthCommand& cmd) {
+    int slot = -1;
+    for (int v = 0; v < MAX_VOICES; v++) {
+        if (!voices[v].active) { slot = v; break; }
+        if (slot < 0 || voices[v].order < voices[slot].order) slot = v;
+    }
+    if (voices[slot].active) SDL_AtomicAdd(&stolenCount, 1);
+
+    Voice& voice = voices[slot];
+    voice.active = true;
+    voice.patch = cmd.patch;
+    voice.pitch = cmd.pitch;
+    voice.gain = cmd.gain;
+    voice.time = 0.0f;
+    voice.phase = 0.0f;
+    voice.filtered = 0.0f;
+    voice.noise = 0x9E3779B9u ^ voiceOrder;
+    voice.order = voiceOrder++;
+}
+
+float Synth::envelopeAt(const PatchDef& def, float time) const {
+    if (time <= 0.0f) return 0.0f;
+    if (time < def.attack) return time / def.attack;
+    float k = 1.0f - (time - def.attack) / (def.duration - def.attack);
+    return k > 0.0f ? k * k : 0.0f;
+}
+
+// Một khối: tần số và biên độ đầu/cuối khối tính một lần, bên trong chỉ
+// còn phép toán trên mảng float. Vòng lặp luôn chạy đủ SYNTH_BLOCK (số lần
+// cố định thì -O2 cũng vector hoá); khối cuối ngắn hơn chỉ dùng `frames` mẫu đầu.
+void Synth::renderVoice(Voice& voice, int frames) {
+    const PatchDef& def = PATCHES[voice.patch];
+    float blockTime = (float)frames / sampleRate;
+    float mid = voice.time + 0.5f * blockTime;
+
+    float freq;
+    if (def.step) {
+        freq = (mid < def.stepTime) ? def.startFreq : def.endFreq;
+    } else {
+        float k = std::min(mid / def.duration, 1.0f);
+        freq = def.startFreq * powf(def.endFreq / def.startFreq, k);
+    }
+    float inc = freq * voice.pitch / sampleRate;
+
+    float envStart = envelopeAt(def, voice.time) * def.volume * voice.gain;
+    float envEnd = envelopeAt(def, voice.time + blockTime) * def.volume * voice.gain;
+    float envStep = (envEnd - envStart) / frames;
+
+    // Oscillator: pha tính trực tiếp từ chỉ số mẫu, không phụ thuộc mẫu trước.
+    // Pha luôn dương nên cắt phần nguyên bằng ép kiểu (vector hoá được, floorf thì không)
+    const float phase0 = voice.phase;
+    switch (def.wave) {
+        case WAVE_SQUARE:
+            for (int i = 0; i < SYNTH_BLOCK; i++) {
+                float p = phase0 + inc * i;
+                p -= (float)(int)p;
+                waveBlock[i] = (p < 0.5f) ? 1.0f : -1.0f;
+            }
+            break;
+        case WAVE_TRIANGLE:
+            for (int i = 0; i < SYNTH_BLOCK; i++) {
+                float p = phase0 + inc * i;
+                p -= (float)(int)p;
+                waveBlock[i] = 4.0f * fabsf(p - 0.5f) - 1.0f;
+            }
+            break;
+        case WAVE_SINE:
+            for (int i = 0; i < SYNTH_BLOCK; i++) {
+                float p = phase0 + inc * i;
+                p -= (float)(int)p;
+                float q = 2.0f * p - 1.0f;              // sin(2πp) = -sin(πq)
+                waveBlock[i] = -4.0f * q * (1.0f - fabsf(q));
+            }
+            break;
+    }
+
+    // Noise lọc thông thấp là đệ quy nên để vòng riêng, chỉ patch cần mới chạy
+    if (def.noiseMix > 0.0f) {
+        float toneMix = 1.0f - def.noiseMix;
+        float cutoff = 0.25f * (1.0f - std::min(mid / def.duration, 1.0f)) + 0.02f;
+        float filtered = voice.filtered;
+        Uint32 noise = voice.noise;
+        for (int i = 0; i < frames; i++) {
+            noise = noise * 1664525u + 1013904223u;
+            float white = (float)(noise >> 8) * (1.0f / (float)(1 << 23)) - 1.0f;
+            filtered += (white - filtered) * cutoff;
+            waveBlock[i] = waveBlock[i] * toneMix + filtered * def.noiseMix;
+        }
+        voice.filtered = filtered;
+        voice.noise = noise;
+    }
+
+    for (int i = 0; i < SYNTH_BLOCK; i++) {
+        mixBlock[i] += waveBlock[i] * (envStart + envStep * i);
+    }
+
+    voice.phase = phase0 + inc * frames;
+    voice.phase -= (float)(int)voice.phase;
+    voice.time += blockTime;
+    if (voice.time >= def.duration) voice.active = false;
+}
+
+void Synth::mix(Sint16* out, int frames) {
+    SynthCommand cmd;
+    while (commands.pop(cmd)) startVoice(cmd);
+
+    for (int done = 0; done < frames; done += SYNTH_BLOCK) {
+        int count = std::min(SYNTH_BLOCK, frames - done);
+
+        bool any = false;
+        std::fill(mixBlock, mixBlock + SYNTH_BLOCK, 0.0f);
+        for (auto& voice : voices) {
+            if (!voice.active) continue;
+            renderVoice(voice, count);
+            any = true;
+        }
+        if (!any) continue;
+
+        // Cộng vào luồng đã trộn (interleaved), bão hoà về Sint16
+        Sint16* frame = out + done * channels;
+        if (channels == 2) {
+            for (int j = 0; j < count * 2; j++) {
+                int sample = frame[j] + (int)(mixBlock[j >> 1] * 32767.0f);
+                frame[j] = (Sint16)std::max(-32768, std::min(32767, sample));
+            }
+        } else {
+            for (int c = 0; c < channels; c++) {
+                for (int i = 0; i < count; i++) {
+                    int sample = frame[i * channels + c] + (int)(mixBlock[i] * 32767.0f);
+                    frame[i * channels + c] = (Sint16)std::max(-32768, std::min(32767, sample));
+                }
+            }
+        }
+    }
+}
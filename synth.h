@@ -0,0 +1,95 @@
+#ifndef SYNTH_H_INCLUDED
+#define SYNTH_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include "spsc_ring.h"
+
+// Âm tạo trực tiếp trong audio callback, không cần file
+enum SynthPatch {
+    PATCH_JUMP,
+    PATCH_COIN,     // pitch tăng theo combo
+    PATCH_SHIELD,
+    PATCH_METEOR,
+    PATCH_COUNT
+};
+
+struct SynthCommand {
+    int patch;
+    float pitch;  // Hệ số nhân tần số, 1 = gốc
+    float gain;
+};
+
+// Synth nhỏ (oscillator + envelope + noise) chạy trong post-mix callback của
+// SDL_mixer, cộng thẳng vào luồng đã trộn. Game thread chỉ đẩy lệnh vào
+// SpscRing; callback không khoá, không cấp phát. Mỗi voice được tạo theo
+// khối SYNTH_BLOCK mẫu với tần số/envelope cố định trong khối để vòng lặp
+// là các phép toán float thẳng hàng mà compiler vector hoá được.
+class Synth {
+public:
+    Synth();
+    ~Synth();
+
+    // Gọi sau Mix_OpenAudio. Chỉ hỗ trợ thiết bị AUDIO_S16SYS; false nếu khác
+    bool start();
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Game thread. False khi hàng đợi đầy
+    bool trigger(SynthPatch patch, float pitch = 1.0f, float gain = 1.0f);
+
+    int getTriggeredCount() const { return triggeredCount; }
+    int getDroppedCount() const { return droppedCount; }
+    int getStolenCount() const { return SDL_AtomicGet(const_cast<SDL_atomic_t*>(&stolenCount)); }
+
+private:
+    enum Wave { WAVE_SQUARE, WAVE_TRIANGLE, WAVE_SINE };
+
+    struct PatchDef {
+        Wave wave;
+        float startFreq;
+        float endFreq;
+        bool step;          // Nhảy tần ở stepTime thay vì quét mũ
+        float stepTime;
+        float duration;
+        float attack;
+        float noiseMix;     // Tỉ lệ noise qua lọc thông thấp
+        float volume;
+    };
+
+    struct Voice {
+        bool active;
+        int patch;
+        float pitch;
+        float gain;
+        float time;         // Giây đã phát
+        float phase;        // 0..1
+        float filtered;     // Trạng thái lọc noise
+        Uint32 noise;
+        Uint32 order;       // Thứ tự bắt đầu, để cướp voice cũ nhất
+    };
+
+    static const int MAX_VOICES = 8;
+    static const int SYNTH_BLOCK = 64;
+    static const PatchDef PATCHES[PATCH_COUNT];
+
+    static void postMix(void* udata, Uint8* stream, int len);
+    void mix(Sint16* out, int frames);
+    void startVoice(const SynthCommand& cmd);
+    void renderVoice(Voice& voice, int frames);  // Cộng vào mixBlock
+    float envelopeAt(const PatchDef& def, float time) const;
+
+    SpscRing<SynthCommand, 64> commands;
+    Voice voices[MAX_VOICES];
+    float mixBlock[SYNTH_BLOCK];
+    float waveBlock[SYNTH_BLOCK];
+    int sampleRate;
+    int channels;
+    Uint32 voiceOrder;
+    bool running;
+    int triggeredCount;
+    int droppedCount;
+    SDL_atomic_t stolenCount;
+};
+
+#endif // SYNTH_H_INCLUDED
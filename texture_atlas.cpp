@@ -0,0 +1,419 @@
+#include "texture_atlas.h"
+#include <iostream>
+#include <algorithm>
+
+// ===================== TEXTURE ATLAS IMPLEMENTATION =====================
+
+TextureAtlas::TextureAtlas()
+    : renderer(nullptr), pageSize(0), maxPages(0), wastedArea(0),
+      previousTarget(nullptr), previousBlend(SDL_BLENDMODE_NONE), previousColor{0, 0, 0, 0} {}
+
+TextureAtlas::~TextureAtlas() {
+    cleanup();
+}
+
+bool TextureAtlas::initialize(SDL_Renderer* targetRenderer, int size, int pageLimit) {
+    cleanup();
+    if (!targetRenderer || !SDL_RenderTargetSupported(targetRenderer)) {
+        std::cerr << "TextureAtlas: render targets not supported. Using separate textures." << std::endl;
+        return false;
+    }
+    renderer = targetRenderer;
+    pageSize = size;
+    maxPages = pageLimit;
+    return true;
+}
+
+void TextureAtlas::cleanup() {
+    for (auto& slot : slots) releaseSource(slot);
+    destroyPages(pages);
+    slots.clear();
+    freeIds.clear();
+    wastedArea = 0;
+    renderer = nullptr;
+}
+
+// Trang trống, trong suốt
+SDL_Texture* TextureAtlas::createPageTexture() {
+    SDL_Texture* tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, pageSize, pageSize);
+    if (!tex) {
+        std::cerr << "TextureAtlas: SDL_CreateTexture Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    SDL_Texture* prev = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, tex);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderTarget(renderer, prev);
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+    return tex;
+}
+
+bool TextureAtlas::createPage(std::vector<AtlasPage>& target) {
+    SDL_Texture* tex = createPageTexture();
+    if (!tex) return false;
+
+    AtlasPage page;
+    page.texture = tex;
+    page.skyline.push_back({0, 0, pageSize});
+    target.push_back(page);
+    return true;
+}
+
+void TextureAtlas::destroyPages(std::vector<AtlasPage>& target) {
+    for (auto& page : target) {
+        if (page.texture) SDL_DestroyTexture(page.texture);
+    }
+    target.clear();
+}
+
+// Đáy thấp nhất nếu đặt khối w x h bắt đầu tại node index, -1 nếu không vừa
+int TextureAtlas::skylineFit(const AtlasPage& page, size_t index, int w, int h) const {
+    int x = page.skyline[index].x;
+    if (x + w > pageSize) return -1;
+
+    int y = page.skyline[index].y;
+    int widthLeft = w;
+    for (size_t i = index; widthLeft > 0; i++) {
+        if (i >= page.skyline.size()) return -1;
+        y = std::max(y, page.skyline[i].y);
+        if (y + h > pageSize) return -1;
+        widthLeft -= page.skyline[i].w;
+    }
+    return y;
+}
+
+bool TextureAtlas::allocateOnPage(AtlasPage& page, int w, int h, SDL_Rect& rect) {
+    std::vector<SkylineNode>& sky = page.skyline;
+
+    // Bottom-left: chọn chỗ có đỉnh thấp nhất, hoà thì chọn node hẹp hơn
+    int bestIndex = -1, bestBottom = pageSize + 1, bestWidth = pageSize + 1, bestY = 0;
+    for (size_t i = 0; i < sky.size(); i++) {
+        int y = skylineFit(page, i, w, h);
+        if (y < 0) continue;
+        if (y + h < bestBottom || (y + h == bestBottom && sky[i].w < bestWidth)) {
+            bestIndex = (int)i;
+            bestBottom = y + h;
+            bestWidth = sky[i].w;
+            bestY = y;
+        }
+    }
+    if (bestIndex < 0) return false;
+
+    rect = {sky[bestIndex].x, bestY, w, h};
+    sky.insert(sky.begin() + bestIndex, {rect.x, bestY + h, w});
+
+    // Cắt các node bị khối mới che
+    for (size_t i = bestIndex + 1; i < sky.size();) {
+        int prevRight = sky[i - 1].x + sky[i - 1].w;
+        if (sky[i].x >= prevRight) break;
+        int shrink = prevRight - sky[i].x;
+        sky[i].x += shrink;
+        sky[i].w -= shrink;
+        if (sky[i].w > 0) break;
+        sky.erase(sky.begin() + i);
+    }
+
+    // Gộp các node liền nhau cùng độ cao
+    for (size_t i = 0; i + 1 < sky.size();) {
+        if (sky[i].y == sky[i + 1].y) {
+            sky[i].w += sky[i + 1].w;
+            sky.erase(sky.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+    return true;
+}
+
+bool TextureAtlas::allocate(std::vector<AtlasPage>& target, int w, int h, int& pageIndex, SDL_Rect& rect) {
+    if (w > pageSize || h > pageSize) return false;
+
+    for (size_t i = 0; i < target.size(); i++) {
+        if (allocateOnPage(target[i], w, h, rect)) {
+            pageIndex = (int)i;
+            return true;
+        }
+    }
+    if ((int)target.size() >= maxPages || !createPage(target)) return false;
+
+    pageIndex = (int)target.size() - 1;
+    return allocateOnPage(target.back(), w, h, rect);
+}
+
+bool TextureAtlas::allocateSlot(int w, int h, AtlasSlot& slot) {
+    int pageIndex;
+    SDL_Rect area;
+    bool ok = allocate(pages, w + 2 * PADDING, h + 2 * PADDING, pageIndex, area);
+    if (!ok && wastedArea > 0 && repack()) {
+        ok = allocate(pages, w + 2 * PADDING, h + 2 * PADDING, pageIndex, area);
+    }
+    if (!ok) {
+        std::cerr << "TextureAtlas: no room for " << w << "x" << h << " sprite" << std::endl;
+        return false;
+    }
+
+    slot.page = pageIndex;
+    slot.rect = {area.x + PADDING, area.y + PADDING, w, h};
+    slot.alive = true;
+    slot.source = nullptr;
+    slot.painter = nullptr;
+    return true;
+}
+
+void TextureAtlas::beginDraw(const AtlasSlot& slot) {
+    previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_GetRenderDrawBlendMode(renderer, &previousBlend);
+    SDL_GetRenderDrawColor(renderer, &previousColor.r, &previousColor.g, &previousColor.b, &previousColor.a);
+
+    SDL_SetRenderTarget(renderer, pages[slot.page].texture);
+
+    // RenderClear bỏ qua viewport nên xoá vùng bằng FillRect không blend
+    SDL_Rect area = {slot.rect.x - PADDING, slot.rect.y - PADDING, slot.rect.w + 2 * PADDING, slot.rect.h + 2 * PADDING};
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderFillRect(renderer, &area);
+
+    SDL_RenderSetViewport(renderer, &slot.rect);
+    SDL_Rect clip = {0, 0, slot.rect.w, slot.rect.h};
+    SDL_RenderSetClipRect(renderer, &clip);
+}
+
+void TextureAtlas::endDraw() {
+    SDL_RenderSetClipRect(renderer, nullptr);
+    SDL_RenderSetViewport(renderer, nullptr);
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetRenderDrawBlendMode(renderer, previousBlend);
+    SDL_SetRenderDrawColor(renderer, previousColor.r, previousColor.g, previousColor.b, previousColor.a);
+}
+
+void TextureAtlas::uploadSurface(const AtlasSlot& slot, SDL_Surface* surface) {
+    SDL_Texture* staging = SDL_CreateTextureFromSurface(renderer, surface);
+    if (!staging) {
+        std::cerr << "TextureAtlas: SDL_CreateTextureFromSurface Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    // Chép nguyên alpha vào trang; lọc tuyến tính khi thu nhỏ ảnh lớn
+    SDL_SetTextureBlendMode(staging, SDL_BLENDMODE_NONE);
+    if (surface->w != slot.rect.w || surface->h != slot.rect.h) {
+        SDL_SetTextureScaleMode(staging, SDL_ScaleModeLinear);
+    }
+
+    beginDraw(slot);
+    SDL_Rect dst = {0, 0, slot.rect.w, slot.rect.h};
+    SDL_RenderCopy(renderer, staging, nullptr, &dst);
+    endDraw();
+
+    SDL_DestroyTexture(staging);
+}
+
+int TextureAtlas::storeSlot(const AtlasSlot& slot) {
+    if (freeIds.empty()) {
+        slots.push_back(slot);
+        return (int)slots.size() - 1;
+    }
+    int id = freeIds.back();
+    freeIds.pop_back();
+    slots[id] = slot;
+    return id;
+}
+
+void TextureAtlas::releaseSource(AtlasSlot& slot) {
+    if (slot.source) SDL_FreeSurface(slot.source);   // Trả tham chiếu giữ trong add()/replace()
+    slot.source = nullptr;
+    slot.painter = nullptr;
+}
+
+AtlasHandle TextureAtlas::add(SDL_Surface* surface, int w, int h) {
+    if (!renderer || !surface) return AtlasHandle();
+    if (w <= 0 || h <= 0) { w = surface->w; h = surface->h; }
+
+    AtlasSlot slot;
+    if (!allocateSlot(w, h, slot)) return AtlasHandle();
+    surface->refcount++;
+    slot.source = surface;
+
+    int id = storeSlot(slot);
+    uploadSurface(slot, surface);
+    return AtlasHandle(id);
+}
+
+AtlasHandle TextureAtlas::bake(int w, int h, const std::function<void(SDL_Renderer*)>& draw) {
+    if (!renderer || w <= 0 || h <= 0) return AtlasHandle();
+
+    AtlasSlot slot;
+    if (!allocateSlot(w, h, slot)) return AtlasHandle();
+    slot.painter = draw;
+
+    int id = storeSlot(slot);
+    beginDraw(slot);
+    draw(renderer);
+    endDraw();
+    return AtlasHandle(id);
+}
+
+bool TextureAtlas::replace(AtlasHandle handle, SDL_Surface* surface, int w, int h) {
+    if (!renderer || !surface || !handle.valid() || handle.id >= (int)slots.size() || !slots[handle.id].alive) return false;
+    if (w <= 0 || h <= 0) { w = surface->w; h = surface->h; }
+
+    const SDL_Rect old = slots[handle.id].rect;
+    if (w <= old.w && h <= old.h) {
+        // Vừa chỗ cũ: xoá vùng cũ rồi ghi đè tại chỗ
+        beginDraw(slots[handle.id]);
+        endDraw();
+        slots[handle.id].rect.w = w;
+        slots[handle.id].rect.h = h;
+        wastedArea += old.w * old.h - w * h;
+    } else {
+        AtlasSlot moved;
+        if (!allocateSlot(w, h, moved)) return false;
+        // allocateSlot có thể đã repack, lấy lại kích thước vùng cũ sau đó
+        const SDL_Rect& current = slots[handle.id].rect;
+        wastedArea += (current.w + 2 * PADDING) * (current.h + 2 * PADDING);
+        slots[handle.id].page = moved.page;
+        slots[handle.id].rect = moved.rect;
+    }
+
+    releaseSource(slots[handle.id]);
+    surface->refcount++;
+    slots[handle.id].source = surface;
+    uploadSurface(slots[handle.id], surface);
+    return true;
+}
+
+void TextureAtlas::remove(AtlasHandle handle) {
+    if (!handle.valid() || handle.id >= (int)slots.size() || !slots[handle.id].alive) return;
+    AtlasSlot& slot = slots[handle.id];
+    slot.alive = false;
+    releaseSource(slot);
+    wastedArea += (slot.rect.w + 2 * PADDING) * (slot.rect.h + 2 * PADDING);
+    freeIds.push_back(handle.id);
+}
+
+bool TextureAtlas::getRegion(AtlasHandle handle, AtlasRegion& out) const {
+    if (!renderer || !handle.valid() || handle.id >= (int)slots.size() || !slots[handle.id].alive) return false;
+
+    const AtlasSlot& slot = slots[handle.id];
+    if (!pages[slot.page].texture) return false;   // restore() không tạo lại được trang
+    out.page = pages[slot.page].texture;
+    out.rect = slot.rect;
+    out.u0 = (float)slot.rect.x / pageSize;
+    out.v0 = (float)slot.rect.y / pageSize;
+    out.u1 = (float)(slot.rect.x + slot.rect.w) / pageSize;
+    out.v1 = (float)(slot.rect.y + slot.rect.h) / pageSize;
+    return true;
+}
+
+void TextureAtlas::draw(AtlasHandle handle, const SDL_Rect& dst, Uint8 alpha) {
+    AtlasRegion region;
+    if (!getRegion(handle, region)) return;
+
+    if (alpha != 255) SDL_SetTextureAlphaMod(region.page, alpha);
+    SDL_RenderCopy(renderer, region.page, &region.rect, &dst);
+    if (alpha != 255) SDL_SetTextureAlphaMod(region.page, 255);
+}
+
+bool TextureAtlas::repack() {
+    if (!renderer) return false;
+
+    // Xếp lại từ vùng cao nhất xuống cho skyline kín hơn
+    std::vector<int> order;
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].alive) order.push_back((int)i);
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        if (slots[a].rect.h != slots[b].rect.h) return slots[a].rect.h > slots[b].rect.h;
+        return slots[a].rect.w > slots[b].rect.w;
+    });
+
+    std::vector<AtlasPage> fresh;
+    std::vector<AtlasSlot> placed(slots.size());
+    for (int id : order) {
+        int pageIndex;
+        SDL_Rect area;
+        const SDL_Rect& r = slots[id].rect;
+        if (!allocate(fresh, r.w + 2 * PADDING, r.h + 2 * PADDING, pageIndex, area)) {
+            std::cerr << "TextureAtlas: repack failed, keeping current layout" << std::endl;
+            destroyPages(fresh);
+            return false;
+        }
+        placed[id].page = pageIndex;
+        placed[id].rect = {area.x + PADDING, area.y + PADDING, r.w, r.h};
+        placed[id].alive = true;
+    }
+
+    // Copy trên GPU từ trang cũ sang trang mới, không cần ảnh gốc
+    SDL_Texture* prev = SDL_GetRenderTarget(renderer);
+    for (auto& page : pages) SDL_SetTextureBlendMode(page.texture, SDL_BLENDMODE_NONE);
+    for (size_t p = 0; p < fresh.size(); p++) {
+        SDL_SetRenderTarget(renderer, fresh[p].texture);
+        for (int id : order) {
+            if (placed[id].page != (int)p) continue;
+            SDL_RenderCopy(renderer, pages[slots[id].page].texture, &slots[id].rect, &placed[id].rect);
+        }
+    }
+    SDL_SetRenderTarget(renderer, prev);
+
+    destroyPages(pages);
+    pages.swap(fresh);
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].alive) {
+            slots[i].page = placed[i].page;
+            slots[i].rect = placed[i].rect;
+        } else {
+            slots[i].page = -1;
+        }
+    }
+    wastedArea = 0;
+
+    std::cout << "TextureAtlas: repacked " << order.size() << " sprites into "
+              << pages.size() << " page(s)" << std::endl;
+    return true;
+}
+
+bool TextureAtlas::restore() {
+    if (!renderer) return false;
+
+    // Texture cũ có thể đã mất hẳn (DEVICE_RESET): tạo trang mới, giữ nguyên skyline
+    bool ok = true;
+    for (auto& page : pages) {
+        if (page.texture) SDL_DestroyTexture(page.texture);
+        page.texture = createPageTexture();
+        if (!page.texture) ok = false;
+    }
+
+    int redrawn = 0;
+    for (const auto& slot : slots) {
+        if (!slot.alive || !pages[slot.page].texture) continue;
+        if (slot.source) {
+            uploadSurface(slot, slot.source);
+        } else if (slot.painter) {
+            beginDraw(slot);
+            slot.painter(renderer);
+            endDraw();
+        }
+        redrawn++;
+    }
+
+    std::cout << "TextureAtlas: restored " << redrawn << " sprites on " << pages.size() << " page(s)" << std::endl;
+    return ok;
+}
+
+int TextureAtlas::getLiveCount() const {
+    int count = 0;
+    for (const auto& slot : slots) {
+        if (slot.alive) count++;
+    }
+    return count;
+}
+
+float TextureAtlas::getOccupancy() const {
+    if (pages.empty()) return 0.0f;
+    long used = 0;
+    for (const auto& slot : slots) {
+        if (slot.alive) used += (long)(slot.rect.w + 2 * PADDING) * (slot.rect.h + 2 * PADDING);
+    }
+    return (float)used / ((float)pageSize * pageSize * pages.size());
+}
@@ -0,0 +1,117 @@
+#ifndef TEXTURE_ATLAS_H_INCLUDED
+#define TEXTURE_ATLAS_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <functional>
+
+// Handle tới một vùng trong atlas, giữ nguyên qua replace() và repack().
+// Sau remove() id được cấp lại cho lần add()/bake() sau nên phải bỏ handle cũ.
+struct AtlasHandle {
+    int id;
+
+    AtlasHandle() : id(-1) {}
+    explicit AtlasHandle(int slotId) : id(slotId) {}
+    bool valid() const { return id >= 0; }
+};
+
+// Vị trí hiện tại của một handle: trang texture, rect pixel và UV (0..1)
+struct AtlasRegion {
+    SDL_Texture* page;
+    SDL_Rect rect;
+    float u0, v0, u1, v1;
+};
+
+// Atlas texture lúc chạy: gom skin, icon và sprite vẽ thủ tục vào vài
+// trang lớn (xếp kiểu skyline) để các lần vẽ liên tiếp dùng chung texture
+// và SDL gộp được thành ít draw call.
+//
+// Trang là texture TARGET nên cần SDL_RENDERER_TARGETTEXTURE; initialize()
+// trả về false nếu không có, khi đó người dùng tự vẽ bằng texture riêng.
+// Driver có thể làm mất nội dung trang (SDL_RENDER_TARGETS_RESET/DEVICE_RESET),
+// nên mỗi vùng giữ surface gốc hoặc hàm vẽ của nó để restore() vẽ lại.
+class TextureAtlas {
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+
+    bool initialize(SDL_Renderer* renderer, int pageSize = 1024, int maxPages = 4);
+    void cleanup();
+    bool isReady() const { return renderer != nullptr; }
+
+    // Chép surface vào atlas, scale về w x h nếu > 0. Atlas giữ một tham chiếu
+    // (refcount) tới surface cho restore() nên không được sửa surface sau đó.
+    AtlasHandle add(SDL_Surface* surface, int w = 0, int h = 0);
+
+    // Vẽ một lần vào vùng w x h. Trong draw(), viewport đã dời về góc vùng
+    // nên toạ độ tính từ (0, 0); vùng bắt đầu trong suốt. draw được giữ lại
+    // để vẽ lại khi restore().
+    AtlasHandle bake(int w, int h, const std::function<void(SDL_Renderer*)>& draw);
+
+    // Đổi nội dung của handle (vd placeholder -> PNG thật), handle giữ nguyên
+    bool replace(AtlasHandle handle, SDL_Surface* surface, int w = 0, int h = 0);
+    void remove(AtlasHandle handle);
+
+    bool getRegion(AtlasHandle handle, AtlasRegion& out) const;
+    void draw(AtlasHandle handle, const SDL_Rect& dst, Uint8 alpha = 255);
+
+    // Dồn các vùng còn dùng sang trang mới (copy trên GPU) để lấy lại chỗ
+    // của vùng đã remove/replace. add() tự gọi khi hết chỗ.
+    bool repack();
+
+    // Tạo lại mọi trang rồi vẽ lại các vùng còn dùng, bố cục và handle giữ
+    // nguyên. Gọi khi nhận SDL_RENDER_TARGETS_RESET hoặc SDL_RENDER_DEVICE_RESET.
+    bool restore();
+
+    int getPageCount() const { return (int)pages.size(); }
+    size_t getPageBytes() const { return pages.size() * (size_t)pageSize * pageSize * 4; }
+    int getLiveCount() const;
+    float getOccupancy() const;
+
+private:
+    struct SkylineNode {
+        int x, y, w;
+    };
+
+    struct AtlasPage {
+        SDL_Texture* texture;
+        std::vector<SkylineNode> skyline;
+    };
+
+    struct AtlasSlot {
+        int page;
+        SDL_Rect rect;
+        bool alive;
+        SDL_Surface* source;                            // add()/replace(): ảnh gốc
+        std::function<void(SDL_Renderer*)> painter;     // bake(): hàm vẽ
+    };
+
+    static const int PADDING = 1;  // Viền trong suốt chống lem khi scale
+
+    SDL_Texture* createPageTexture();
+    bool createPage(std::vector<AtlasPage>& target);
+    void destroyPages(std::vector<AtlasPage>& target);
+    bool allocate(std::vector<AtlasPage>& target, int w, int h, int& pageIndex, SDL_Rect& rect);
+    bool allocateOnPage(AtlasPage& page, int w, int h, SDL_Rect& rect);
+    int skylineFit(const AtlasPage& page, size_t index, int w, int h) const;
+    bool allocateSlot(int w, int h, AtlasSlot& slot);
+
+    void beginDraw(const AtlasSlot& slot);  // Xoá vùng về trong suốt rồi trỏ target vào đó
+    void endDraw();
+    void uploadSurface(const AtlasSlot& slot, SDL_Surface* surface);
+    int storeSlot(const AtlasSlot& slot);   // Lấy id từ freeIds nếu có
+    void releaseSource(AtlasSlot& slot);
+
+    SDL_Renderer* renderer;
+    int pageSize;
+    int maxPages;
+    std::vector<AtlasPage> pages;
+    std::vector<AtlasSlot> slots;
+    std::vector<int> freeIds;   // Id của slot đã remove, cấp lại trước khi nới slots
+    int wastedArea;  // Diện tích của vùng đã bỏ, lấy lại được khi repack
+    SDL_Texture* previousTarget;
+    SDL_BlendMode previousBlend;
+    SDL_Color previousColor;
+};
+
+#endif // TEXTURE_ATLAS_H_INCLUDED
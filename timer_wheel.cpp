@@ -0,0 +1,190 @@
+#include "timer_wheel.h"
+#include <iostream>
+
+// ===================== TIMER WHEEL IMPLEMENTATION =====================
+
+TimerWheel::TimerWheel()
+    : nodes(SENTINELS), freeList(-1), current(0), pending(0),
+      scheduledCount(0), firedCount(0), cancelledCount(0), cascadedCount(0) {
+    for (int i = 0; i < SENTINELS; i++) {
+        nodes[i].prev = nodes[i].next = i;
+        nodes[i].expires = 0;
+        nodes[i].generation = 0;
+        nodes[i].listener = nullptr;
+        nodes[i].timerId = -1;
+    }
+}
+
+TimerHandle TimerWheel::schedule(Uint32 ticks, TimerListener* listener, int timerId) {
+    TimerHandle handle;
+    if (!listener) return handle;
+    if (ticks == 0) ticks = 1;
+
+    int index = allocNode();
+    Node& n = nodes[index];
+    n.expires = current + ticks - 1;
+    n.listener = listener;
+    n.timerId = timerId;
+    place(index);
+
+    pending++;
+    scheduledCount++;
+    handle.node = index;
+    handle.generation = n.generation;
+    return handle;
+}
+
+bool TimerWheel::cancel(TimerHandle& handle) {
+    if (!isPending(handle)) {
+        handle = TimerHandle();
+        return false;
+    }
+    unlink(handle.node);
+    freeNode(handle.node);
+    pending--;
+    cancelledCount++;
+    handle = TimerHandle();
+    return true;
+}
+
+int TimerWheel::cancelAll(TimerListener* listener) {
+    int cancelled = 0;
+    for (int i = SENTINELS; i < (int)nodes.size(); i++) {
+        if (nodes[i].listener == listener && listener) {
+            unlink(i);
+            freeNode(i);
+            cancelled++;
+        }
+    }
+    pending -= cancelled;
+    cancelledCount += cancelled;
+    return cancelled;
+}
+
+void TimerWheel::clear() {
+    for (int i = SENTINELS; i < (int)nodes.size(); i++) {
+        if (nodes[i].listener) {
+            unlink(i);
+            freeNode(i);
+        }
+    }
+    pending = 0;
+}
+
+void TimerWheel::advance() {
+    Uint32 tick = current;
+
+    // Tầng 0 quay hết vòng: đổ ô kế tiếp của tầng trên xuống (lan lên nếu tầng đó cũng hết vòng)
+    if ((tick & (SLOTS - 1)) == 0) {
+        for (int level = 1; level < LEVELS; level++) {
+            cascade(level);
+            if (((tick >> (SLOT_BITS * level)) & (SLOTS - 1)) != 0) break;
+        }
+    }
+
+    // Chuyển ô hiện tại sang danh sách FIRING để callback hẹn lại vào đúng ô này được an toàn
+    int head = tick & (SLOTS - 1);
+    while (nodes[head].next != head) {
+        int index = nodes[head].next;
+        unlink(index);
+        link(FIRING, index);
+    }
+    current = tick + 1;
+
+    while (nodes[FIRING].next != FIRING) {
+        int index = nodes[FIRING].next;
+        TimerListener* listener = nodes[index].listener;
+        int timerId = nodes[index].timerId;
+        unlink(index);
+        freeNode(index);
+        pending--;
+        firedCount++;
+        listener->onTimer(timerId);
+    }
+}
+
+bool TimerWheel::isPending(const TimerHandle& handle) const {
+    if (handle.node < SENTINELS || handle.node >= (int)nodes.size()) return false;
+    const Node& n = nodes[handle.node];
+    return n.listener && n.generation == handle.generation;
+}
+
+Uint32 TimerWheel::getRemaining(const TimerHandle& handle) const {
+    if (!isPending(handle)) return 0;
+    return nodes[handle.node].expires - current + 1;
+}
+
+void TimerWheel::logStats() const {
+    std::cout << "Timers: tick " << current << ", " << pending << " pending, "
+              << scheduledCount << " scheduled, " << firedCount << " fired, "
+              << cancelledCount << " cancelled, " << cascadedCount << " cascaded, "
+              << (nodes.size() - SENTINELS) << " nodes" << std::endl;
+}
+
+int TimerWheel::allocNode() {
+    if (freeList != -1) {
+        int index = freeList;
+        freeList = nodes[index].next;
+        return index;
+    }
+    Node n;
+    n.generation = 0;
+    n.listener = nullptr;
+    nodes.push_back(n);
+    return (int)nodes.size() - 1;
+}
+
+void TimerWheel::freeNode(int index) {
+    Node& n = nodes[index];
+    n.listener = nullptr;
+    n.generation++;
+    n.prev = -1;
+    n.next = freeList;
+    freeList = index;
+}
+
+void TimerWheel::place(int index) {
+    Node& n = nodes[index];
+    Sint32 delta = (Sint32)(n.expires - current);
+    if (delta < 0) {
+        // Quá hạn (chỉ khi đổ tầng): chạy ở tick đang xử lý
+        n.expires = current;
+        delta = 0;
+    }
+
+    int level = 0;
+    while (level < LEVELS - 1 && (Uint32)delta >= (1u << (SLOT_BITS * (level + 1)))) level++;
+
+    // Xa hơn tầng cao nhất: đặt ở ô xa nhất, lúc đổ xuống sẽ xếp lại theo expires thật
+    Uint32 at = n.expires;
+    Uint32 span = 1u << (SLOT_BITS * LEVELS);
+    if ((Uint32)delta >= span) at = current + span - 1;
+
+    int slot = (at >> (SLOT_BITS * level)) & (SLOTS - 1);
+    link(level * SLOTS + slot, index);
+}
+
+void TimerWheel::link(int head, int index) {
+    Node& n = nodes[index];
+    n.prev = nodes[head].prev;
+    n.next = head;
+    nodes[n.prev].next = index;
+    nodes[head].prev = index;
+}
+
+void TimerWheel::unlink(int index) {
+    Node& n = nodes[index];
+    nodes[n.prev].next = n.next;
+    nodes[n.next].prev = n.prev;
+    n.prev = n.next = index;
+}
+
+void TimerWheel::cascade(int level) {
+    int head = level * SLOTS + ((current >> (SLOT_BITS * level)) & (SLOTS - 1));
+    while (nodes[head].next != head) {
+        int index = nodes[head].next;
+        unlink(index);
+        place(index);
+        cascadedCount++;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef TIMER_WHEEL_H_INCLUDED
+#define TIMER_WHEEL_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+class TimerListener {
+public:
+    virtual ~TimerListener() {}
+    virtual void onTimer(int timerId) = 0;
+};
+
+// Handle tới một timer đã hẹn; generation cũ (timer đã chạy/huỷ) thì vô hiệu
+struct TimerHandle {
+    int node;
+    Uint32 generation;
+
+    TimerHandle() : node(-1), generation(0) {}
+};
+
+// Timer wheel phân cấp theo tick mô phỏng (1 tick = 1 frame gameplay):
+// 4 tầng x 64 ô, tầng 0 là 64 tick tới, tầng trên gộp dần và được đổ
+// xuống khi tầng dưới quay hết vòng. Mỗi ô là danh sách liên kết đôi trong
+// một pool node nên schedule/cancel O(1), advance O(1) + số timer chạy.
+// Timer cùng tick chạy theo thứ tự hẹn. Callback được phép hẹn/huỷ timer.
+class TimerWheel {
+public:
+    TimerWheel();
+
+    // Chạy sau đúng `ticks` lần advance() (tối thiểu 1)
+    TimerHandle schedule(Uint32 ticks, TimerListener* listener, int timerId);
+    bool cancel(TimerHandle& handle);
+    // Huỷ mọi timer của listener (khi hệ thống bị tạo lại); duyệt cả pool
+    int cancelAll(TimerListener* listener);
+    void clear();
+
+    void advance();
+
+    bool isPending(const TimerHandle& handle) const;
+    Uint32 getRemaining(const TimerHandle& handle) const;   // 0 nếu không còn hẹn
+    Uint32 getTick() const { return current; }
+    int getPendingCount() const { return pending; }
+    void logStats() const;
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int SENTINELS = LEVELS * SLOTS + 1;   // Các ô + danh sách đang chạy
+    static const int FIRING = LEVELS * SLOTS;
+
+    struct Node {
+        int prev, next;
+        Uint32 expires;
+        Uint32 generation;
+        TimerListener* listener;
+        int timerId;
+    };
+
+    int allocNode();
+    void freeNode(int index);
+    void place(int index);
+    void link(int head, int index);
+    void unlink(int index);
+    void cascade(int level);
+
+    std::vector<Node> nodes;   // [0, SENTINELS) là đầu danh sách
+    int freeList;
+    Uint32 current;            // Tick advance() kế tiếp sẽ xử lý
+    int pending;
+
+    Uint64 scheduledCount, firedCount, cancelledCount, cascadedCount;
+};
+
+#endif // TIMER_WHEEL_H_INCLUDED
@@ -0,0 +1,211 @@
+// Công cụ offline đóng gói asset thành assets.pak (xem asset_pack.h).
+//
+//   asset_packer [--rgba] [--pcm] <output.pak> <file>...
+//
+// Tên entry là đường dẫn đúng như game dùng, vd:
+//   asset_packer --rgba --pcm assets.pak NotoSans-Regular.ttf image/music.mp3 image/dino_base.png
+// Với --rgba, các file .png được decode sẵn thành RGBA32 để lúc chạy
+// không phải decode PNG nữa (đổi lại pack to hơn).
+// Với --pcm, nhạc .ogg/.mp3 được giải mã sẵn thành WAV PCM 16-bit
+// 44.1 kHz stereo (vẫn giữ tên cũ) để MusicStreamer đọc từng block thẳng
+// từ pack đã mmap thay vì giải mã cả bài vào RAM.
+//
+// Build: g++ -O2 -I.. asset_packer.cpp -lSDL2 -lSDL2_image -lSDL2_mixer -o asset_packer
+// Game.cbp build và chạy công cụ này (ra assets.pak) trước mỗi lần build game.
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include "asset_pack.h"
+
+struct PackSource {
+    std::string name;
+    std::vector<char> payload;
+    Uint32 kind;
+    Uint32 width, height;
+};
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static bool readFile(const std::string& path, std::vector<char>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    out.resize(static_cast<size_t>(size));
+    return size == 0 || static_cast<bool>(file.read(out.data(), size));
+}
+
+static bool decodeRGBA(const std::string& path, PackSource& src) {
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) return false;
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!rgba) return false;
+
+    src.kind = PACK_RGBA;
+    src.width = rgba->w;
+    src.height = rgba->h;
+    src.payload.resize((size_t)rgba->w * rgba->h * 4);
+    SDL_LockSurface(rgba);
+    for (int y = 0; y < rgba->h; y++) {
+        memcpy(&src.payload[(size_t)y * rgba->w * 4],
+               static_cast<const char*>(rgba->pixels) + (size_t)y * rgba->pitch, (size_t)rgba->w * 4);
+    }
+    SDL_UnlockSurface(rgba);
+    SDL_FreeSurface(rgba);
+    return true;
+}
+
+static void appendLE(std::vector<char>& out, Uint32 value, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((char)((value >> (8 * i)) & 0xFF));
+}
+
+// Giải mã bằng SDL_mixer (đã mở ở 44.1 kHz S16LE stereo) rồi bọc thành WAV
+static bool decodePCM(const std::string& path, PackSource& src) {
+    Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+    if (!chunk) return false;
+
+    const Uint32 rate = 44100, channels = 2;
+    std::vector<char>& out = src.payload;
+    out.clear();
+    out.reserve(44 + chunk->alen);
+    out.insert(out.end(), { 'R', 'I', 'F', 'F' });
+    appendLE(out, 36 + chunk->alen, 4);
+    out.insert(out.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    appendLE(out, 16, 4);
+    appendLE(out, 1, 2);                      // PCM
+    appendLE(out, channels, 2);
+    appendLE(out, rate, 4);
+    appendLE(out, rate * channels * 2, 4);    // byte/giây
+    appendLE(out, channels * 2, 2);           // block align
+    appendLE(out, 16, 2);                     // bit/mẫu
+    out.insert(out.end(), { 'd', 'a', 't', 'a' });
+    appendLE(out, chunk->alen, 4);
+    out.insert(out.end(), reinterpret_cast<const char*>(chunk->abuf),
+               reinterpret_cast<const char*>(chunk->abuf) + chunk->alen);
+    Mix_FreeChunk(chunk);
+    return true;
+}
+
+static Uint64 alignUp(Uint64 value) {
+    return (value + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+}
+
+int main(int argc, char* argv[]) {
+    bool predecode = false;
+    bool pcm = false;
+    int argi = 1;
+    for (; argi < argc && strncmp(argv[argi], "--", 2) == 0; argi++) {
+        if (strcmp(argv[argi], "--rgba") == 0) predecode = true;
+        else if (strcmp(argv[argi], "--pcm") == 0) pcm = true;
+        else break;
+    }
+    if (argc - argi < 2) {
+        std::cerr << "Usage: asset_packer [--rgba] [--pcm] <output.pak> <file>..." << std::endl;
+        return 1;
+    }
+    std::string outputPath = argv[argi++];
+
+    if (predecode && !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        std::cerr << "IMG_Init Error: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+    if (pcm) {
+        // Không cần loa thật, SDL_mixer chỉ dùng spec để đổi định dạng
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+        Mix_Init(MIX_INIT_OGG | MIX_INIT_MP3);
+        if (Mix_OpenAudio(44100, AUDIO_S16LSB, 2, 4096) < 0) {
+            std::cerr << "Mix_OpenAudio Error: " << Mix_GetError() << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<PackSource> sources;
+    for (; argi < argc; argi++) {
+        PackSource src;
+        src.name = argv[argi];
+        std::replace(src.name.begin(), src.name.end(), '\\', '/');
+        src.kind = PACK_RAW;
+        src.width = src.height = 0;
+
+        if (src.name.size() >= (size_t)PACK_NAME_LENGTH) {
+            std::cerr << "Name too long (max " << PACK_NAME_LENGTH - 1 << "): " << src.name << std::endl;
+            return 1;
+        }
+
+        bool music = endsWith(src.name, ".ogg") || endsWith(src.name, ".mp3");
+        bool ok = (predecode && endsWith(src.name, ".png")) ? decodeRGBA(argv[argi], src)
+                : (pcm && music) ? decodePCM(argv[argi], src)
+                : readFile(argv[argi], src.payload);
+        if (!ok) {
+            std::cerr << "Could not read " << argv[argi] << std::endl;
+            return 1;
+        }
+        sources.push_back(std::move(src));
+    }
+
+    // Runtime tìm nhị phân trên TOC nên phải sắp xếp theo tên
+    std::sort(sources.begin(), sources.end(), [](const PackSource& a, const PackSource& b) {
+        return strcmp(a.name.c_str(), b.name.c_str()) < 0;
+    });
+    for (size_t i = 1; i < sources.size(); i++) {
+        if (sources[i].name == sources[i - 1].name) {
+            std::cerr << "Duplicate entry: " << sources[i].name << std::endl;
+            return 1;
+        }
+    }
+
+    PackHeader header;
+    memcpy(header.magic, PACK_MAGIC, sizeof(header.magic));
+    header.version = PACK_VERSION;
+    header.entryCount = (Uint32)sources.size();
+    header.tocOffset = sizeof(PackHeader);
+
+    std::vector<PackEntry> toc(sources.size());
+    Uint64 offset = alignUp(header.tocOffset + sizeof(PackEntry) * toc.size());
+    for (size_t i = 0; i < sources.size(); i++) {
+        memset(&toc[i], 0, sizeof(PackEntry));
+        strncpy(toc[i].name, sources[i].name.c_str(), PACK_NAME_LENGTH - 1);
+        toc[i].offset = offset;
+        toc[i].size = sources[i].payload.size();
+        toc[i].kind = sources[i].kind;
+        toc[i].width = sources[i].width;
+        toc[i].height = sources[i].height;
+        offset = alignUp(offset + toc[i].size);
+    }
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Could not create " << outputPath << std::endl;
+        return 1;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(toc.data()), sizeof(PackEntry) * toc.size());
+
+    static const char zeros[PACK_ALIGNMENT] = {};
+    for (size_t i = 0; i < sources.size(); i++) {
+        Uint64 pos = (Uint64)out.tellp();
+        out.write(zeros, (std::streamsize)(toc[i].offset - pos));
+        out.write(sources[i].payload.data(), (std::streamsize)sources[i].payload.size());
+        std::cout << (toc[i].kind == PACK_RGBA ? "  rgba " : "  raw  ") << toc[i].name
+                  << " (" << toc[i].size / 1024 << " KB)" << std::endl;
+    }
+    out.close();
+
+    if (predecode) IMG_Quit();
+    if (pcm) {
+        Mix_CloseAudio();
+        Mix_Quit();
+    }
+    std::cout << "Wrote " << outputPath << ": " << sources.size() << " entries" << std::endl;
+    return out.fail() ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+#ifndef CONTENT_BUILDER_H_INCLUDED
+#define CONTENT_BUILDER_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <unordered_map>
+#include "content_db.h"
+
+// Ghép các def và chuỗi thành một image content.db cho tools/content_compiler.
+class ContentBuilder {
+public:
+    ContentBuilder() { strings.push_back('\0'); }   // Offset 0 = chuỗi rỗng
+
+    // Chuỗi trùng nhau dùng chung một offset
+    Uint32 addString(const std::string& text) {
+        auto it = stringIndex.find(text);
+        if (it != stringIndex.end()) return it->second;
+        Uint32 offset = (Uint32)strings.size();
+        strings.insert(strings.end(), text.begin(), text.end());
+        strings.push_back('\0');
+        stringIndex[text] = offset;
+        return offset;
+    }
+
+    void addQuest(const QuestDef& def) { quests.push_back(def); }
+    void addAchievement(const AchievementDef& def) { achievements.push_back(def); }
+    void addShopItem(const ShopItemDef& def) { shopItems.push_back(def); }
+
+    size_t questCount() const { return quests.size(); }
+    size_t achievementCount() const { return achievements.size(); }
+    size_t shopItemCount() const { return shopItems.size(); }
+
+    // Mọi def có kích thước là bội của 4 nên các bảng luôn thẳng hàng
+    void build(std::vector<char>& image) const {
+        ContentHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CONTENT_MAGIC, sizeof(header.magic));
+        header.version = CONTENT_VERSION;
+        header.questCount = (Uint32)quests.size();
+        header.questOffset = sizeof(ContentHeader);
+        header.achievementCount = (Uint32)achievements.size();
+        header.achievementOffset = header.questOffset + (Uint32)(sizeof(QuestDef) * quests.size());
+        header.shopItemCount = (Uint32)shopItems.size();
+        header.shopItemOffset = header.achievementOffset + (Uint32)(sizeof(AchievementDef) * achievements.size());
+        header.stringOffset = header.shopItemOffset + (Uint32)(sizeof(ShopItemDef) * shopItems.size());
+        header.stringSize = (Uint32)strings.size();
+
+        image.resize(header.stringOffset + strings.size());
+        memcpy(image.data(), &header, sizeof(header));
+        if (!quests.empty()) memcpy(image.data() + header.questOffset, quests.data(), sizeof(QuestDef) * quests.size());
+        if (!achievements.empty())
+            memcpy(image.data() + header.achievementOffset, achievements.data(), sizeof(AchievementDef) * achievements.size());
+        if (!shopItems.empty()) memcpy(image.data() + header.shopItemOffset, shopItems.data(), sizeof(ShopItemDef) * shopItems.size());
+        memcpy(image.data() + header.stringOffset, strings.data(), strings.size());
+    }
+
+private:
+    std::vector<QuestDef> quests;
+    std::vector<AchievementDef> achievements;
+    std::vector<ShopItemDef> shopItems;
+    std::vector<char> strings;
+    std::unordered_map<std::string, Uint32> stringIndex;
+};
+
+#endif // CONTENT_BUILDER_H_INCLUDED
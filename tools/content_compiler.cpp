@@ -0,0 +1,255 @@
+// Công cụ offline biên dịch nội dung game dạng text thành content.db (xem content_db.h).
+//
+//   content_compiler <input.txt> <output.db> [<builtin.inc>]
+//
+// <builtin.inc> (tuỳ chọn) là cùng image dưới dạng mảng C; ContentDB::openBuiltin
+// nhúng nó khi không có content.db. Game.cbp sinh cả hai trước mỗi lần build.
+//
+// Mỗi dòng một mục, '#' tới cuối dòng là chú thích, chuỗi có dấu cách đặt trong "":
+//
+//   quest daily 0 "Thu Thập Nhanh" "Thu thập 50 xu trong 1 lần chạy" collect_coins 50 50 25
+//   quest main 100 "Bước Đầu Tiên" "Hoàn thành 1 màn chơi" complete_level 1 75 50 accumulative
+//       # pool, id, tên, mô tả, loại, yêu cầu, xu thưởng, XP thưởng, [accumulative]
+//   achievement 0 "First Steps" "Score 50 points" score 50 20
+//       # id, tên, mô tả, loại, yêu cầu, xu thưởng
+//   shop 0 "Red Dragon" "Fierce red dragon" 100 "image/dino_base.png" 38,7,0,255 77,41,16,255 ...
+//       # id, tên, mô tả, giá, ảnh gốc xám, 5 màu palette r,g,b[,a]; skin đầu tiên là skin mặc định
+//
+// Build: g++ -O2 -I.. content_compiler.cpp -o content_compiler
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <set>
+#include <cstring>
+#include <cstdlib>
+#include "content_builder.h"
+#include "embedded_image.h"
+
+// Theo thứ tự enum của game (Quest::Type, Achievement::Type, QuestPool)
+static const char* QUEST_TYPE_NAMES[] = { "collect_coins", "reach_score", "complete_level", "collect_powerups",
+                                          "reach_combo", "survive_time", "jump_count", "no_damage" };
+static const char* ACHIEVEMENT_TYPE_NAMES[] = { "score", "coins", "combo", "level" };
+static const char* POOL_NAMES[] = { "daily", "main" };
+
+SDL_COMPILE_TIME_ASSERT(quest_type_names, sizeof(QUEST_TYPE_NAMES) / sizeof(QUEST_TYPE_NAMES[0]) == CONTENT_QUEST_TYPES);
+SDL_COMPILE_TIME_ASSERT(achievement_type_names, sizeof(ACHIEVEMENT_TYPE_NAMES) / sizeof(ACHIEVEMENT_TYPE_NAMES[0]) == CONTENT_ACHIEVEMENT_TYPES);
+SDL_COMPILE_TIME_ASSERT(pool_names, sizeof(POOL_NAMES) / sizeof(POOL_NAMES[0]) == QUEST_POOL_COUNT);
+
+static std::string sourcePath;
+static int lineNumber = 0;
+
+static bool fail(const std::string& message) {
+    std::cerr << sourcePath << ":" << lineNumber << ": " << message << std::endl;
+    return false;
+}
+
+// Tách dòng thành token; "..." là một token, '#' ngoài chuỗi bắt đầu chú thích
+static bool tokenize(const std::string& line, std::vector<std::string>& tokens) {
+    tokens.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        char c = line[i];
+        if (c == '#') break;
+        if (c == ' ' || c == '\t' || c == '\r') { i++; continue; }
+        if (c == '"') {
+            size_t end = line.find('"', i + 1);
+            if (end == std::string::npos) return fail("unterminated string");
+            tokens.push_back(line.substr(i + 1, end - i - 1));
+            i = end + 1;
+            continue;
+        }
+        size_t end = i;
+        while (end < line.size() && line[end] != ' ' && line[end] != '\t' && line[end] != '\r' && line[end] != '#') end++;
+        tokens.push_back(line.substr(i, end - i));
+        i = end;
+    }
+    return true;
+}
+
+static int findName(const char* const* names, int count, const std::string& name) {
+    for (int i = 0; i < count; i++) {
+        if (name == names[i]) return i;
+    }
+    return -1;
+}
+
+static bool parseInt(const std::string& text, long minValue, long maxValue, long& out) {
+    char* end = nullptr;
+    out = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || out < minValue || out > maxValue)
+        return fail("expected an integer in [" + std::to_string(minValue) + ", " + std::to_string(maxValue) + "], got '" + text + "'");
+    return true;
+}
+
+// "r,g,b" hoặc "r,g,b,a" (mặc định a = 255)
+static bool parseColor(const std::string& text, SDL_Color& out) {
+    std::vector<std::string> parts;
+    size_t start = 0, comma;
+    while ((comma = text.find(',', start)) != std::string::npos) {
+        parts.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+    parts.push_back(text.substr(start));
+    if (parts.size() != 3 && parts.size() != 4) return fail("expected a color r,g,b[,a], got '" + text + "'");
+
+    long channel[4] = { 0, 0, 0, 255 };
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (!parseInt(parts[i], 0, 255, channel[i])) return false;
+    }
+    out.r = (Uint8)channel[0];
+    out.g = (Uint8)channel[1];
+    out.b = (Uint8)channel[2];
+    out.a = (Uint8)channel[3];
+    return true;
+}
+
+static bool checkText(const std::string& text, const char* what) {
+    if (text.empty()) return fail(std::string(what) + " must not be empty");
+    if (text.find('\0') != std::string::npos) return fail(std::string(what) + " contains a NUL byte");
+    return true;
+}
+
+static bool parseQuest(const std::vector<std::string>& tokens, ContentBuilder& builder, std::set<long>& ids) {
+    if (tokens.size() != 9 && tokens.size() != 10) return fail("quest needs: pool id \"title\" \"description\" type requirement coins xp [accumulative]");
+    int pool = findName(POOL_NAMES, QUEST_POOL_COUNT, tokens[1]);
+    if (pool < 0) return fail("unknown quest pool '" + tokens[1] + "'");
+    int type = findName(QUEST_TYPE_NAMES, CONTENT_QUEST_TYPES, tokens[5]);
+    if (type < 0) return fail("unknown quest type '" + tokens[5] + "'");
+    long id, requirement, coins, xp;
+    if (!parseInt(tokens[2], 0, 0x7fffffff, id) || !parseInt(tokens[6], 1, 0x7fffffff, requirement) ||
+        !parseInt(tokens[7], 0, 0x7fffffff, coins) || !parseInt(tokens[8], 0, 0x7fffffff, xp)) return false;
+    if (tokens.size() == 10 && tokens[9] != "accumulative") return fail("expected 'accumulative', got '" + tokens[9] + "'");
+    if (!checkText(tokens[3], "quest title") || !checkText(tokens[4], "quest description")) return false;
+    // Tiến độ quest lưu theo id nên id phải duy nhất
+    if (!ids.insert(id).second) return fail("duplicate quest id " + std::to_string(id));
+
+    QuestDef def;
+    memset(&def, 0, sizeof(def));
+    def.id = (Sint32)id;
+    def.title = builder.addString(tokens[3]);
+    def.description = builder.addString(tokens[4]);
+    def.type = (Uint8)type;
+    def.pool = (Uint8)pool;
+    def.accumulative = tokens.size() == 10 ? 1 : 0;
+    def.requirement = (Sint32)requirement;
+    def.coinReward = (Sint32)coins;
+    def.xpReward = (Sint32)xp;
+    builder.addQuest(def);
+    return true;
+}
+
+static bool parseAchievement(const std::vector<std::string>& tokens, ContentBuilder& builder, std::set<long>& ids) {
+    if (tokens.size() != 7) return fail("achievement needs: id \"name\" \"description\" type requirement reward");
+    int type = findName(ACHIEVEMENT_TYPE_NAMES, CONTENT_ACHIEVEMENT_TYPES, tokens[4]);
+    if (type < 0) return fail("unknown achievement type '" + tokens[4] + "'");
+    long id, requirement, reward;
+    if (!parseInt(tokens[1], 0, 0x7fffffff, id) || !parseInt(tokens[5], 1, 0x7fffffff, requirement) ||
+        !parseInt(tokens[6], 0, 0x7fffffff, reward)) return false;
+    if (!checkText(tokens[2], "achievement name") || !checkText(tokens[3], "achievement description")) return false;
+    if (!ids.insert(id).second) return fail("duplicate achievement id " + std::to_string(id));
+
+    AchievementDef def;
+    memset(&def, 0, sizeof(def));
+    def.id = (Sint32)id;
+    def.name = builder.addString(tokens[2]);
+    def.description = builder.addString(tokens[3]);
+    def.type = (Uint32)type;
+    def.requirement = (Sint32)requirement;
+    def.reward = (Sint32)reward;
+    builder.addAchievement(def);
+    return true;
+}
+
+static bool parseShopItem(const std::vector<std::string>& tokens, ContentBuilder& builder) {
+    if (tokens.size() != 6 + (size_t)CONTENT_PALETTE_KEYS)
+        return fail("shop needs: id \"name\" \"description\" price \"base sprite\" and " +
+                    std::to_string(CONTENT_PALETTE_KEYS) + " palette colors");
+    long id, price;
+    if (!parseInt(tokens[1], 0, 0x7fffffff, id) || !parseInt(tokens[4], 0, 0x7fffffff, price)) return false;
+    if (!checkText(tokens[2], "shop item name") || !checkText(tokens[3], "shop item description") ||
+        !checkText(tokens[5], "base sprite")) return false;
+
+    ShopItemDef def;
+    memset(&def, 0, sizeof(def));
+    def.id = (Sint32)id;
+    def.name = builder.addString(tokens[2]);
+    def.description = builder.addString(tokens[3]);
+    def.baseSprite = builder.addString(tokens[5]);
+    def.price = (Sint32)price;
+    for (int k = 0; k < CONTENT_PALETTE_KEYS; k++) {
+        if (!parseColor(tokens[6 + k], def.palette[k])) return false;
+    }
+    builder.addShopItem(def);
+    return true;
+}
+
+static bool parseSource(std::istream& in, ContentBuilder& builder) {
+    std::string line;
+    std::vector<std::string> tokens;
+    std::set<long> questIds, achievementIds;
+
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!tokenize(line, tokens)) return false;
+        if (tokens.empty()) continue;
+
+        if (tokens[0] == "quest") {
+            if (!parseQuest(tokens, builder, questIds)) return false;
+        } else if (tokens[0] == "achievement") {
+            if (!parseAchievement(tokens, builder, achievementIds)) return false;
+        } else if (tokens[0] == "shop") {
+            if (!parseShopItem(tokens, builder)) return false;
+        } else {
+            return fail("expected 'quest', 'achievement' or 'shop'");
+        }
+    }
+    // Skin đầu tiên luôn được sở hữu nên shop không được rỗng
+    if (builder.shopItemCount() == 0) return fail("no shop items");
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: content_compiler <input.txt> <output.db> [<builtin.inc>]" << std::endl;
+        return 1;
+    }
+    sourcePath = argv[1];
+    std::string outputPath = argv[2];
+
+    std::ifstream in(sourcePath);
+    if (!in.is_open()) {
+        std::cerr << "Could not read " << sourcePath << std::endl;
+        return 1;
+    }
+    ContentBuilder builder;
+    if (!parseSource(in, builder)) return 1;
+
+    std::vector<char> image;
+    builder.build(image);
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Could not create " << outputPath << std::endl;
+        return 1;
+    }
+    out.write(image.data(), image.size());
+    out.close();
+    if (out.fail()) {
+        std::cerr << "Could not write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << outputPath << ": " << builder.questCount() << " quests, " << builder.achievementCount()
+              << " achievements, " << builder.shopItemCount() << " shop items, " << image.size() << " bytes" << std::endl;
+
+    if (argc == 4) {
+        if (!writeEmbeddedImage(argv[3], "CONTENT_BUILTIN", "content_compiler", sourcePath, image)) {
+            std::cerr << "Could not write " << argv[3] << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << argv[3] << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#ifndef EMBEDDED_IMAGE_H_INCLUDED
+#define EMBEDDED_IMAGE_H_INCLUDED
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+// Ghi image nhị phân (content.db, levels.lvp) thành file .inc để game nhúng
+// làm bản có sẵn khi không tìm thấy file:
+//   alignas(8) static const unsigned char <symbol>[] = { ... };
+// Công cụ ghi .inc cùng lúc với file nhị phân từ cùng một file text, nên bản
+// nhúng không bao giờ phải sửa tay.
+inline bool writeEmbeddedImage(const std::string& path, const char* symbol, const char* tool,
+                               const std::string& source, const std::vector<char>& image) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    out << "// Sinh bởi tools/" << tool << " từ " << source << "; không sửa tay.\n";
+    out << "alignas(8) static const unsigned char " << symbol << "[] = {\n";
+    char hex[8];
+    for (size_t i = 0; i < image.size(); i++) {
+        snprintf(hex, sizeof(hex), "0x%02x,", (unsigned char)image[i]);
+        out << (i % 16 == 0 ? "    " : " ") << hex;
+        if (i % 16 == 15 || i + 1 == image.size()) out << "\n";
+    }
+    out << "};\n";
+    out.close();
+    return !out.fail();
+}
+
+#endif // EMBEDDED_IMAGE_H_INCLUDED
@@ -0,0 +1,336 @@
+// Công cụ offline biên dịch level pack dạng text thành levels.lvp (xem level_pack.h).
+//
+//   level_compiler <input.txt> <output.lvp> [<builtin.inc>]
+//
+// <builtin.inc> (tuỳ chọn) là cùng image đó dưới dạng mảng C, LevelPack::openBuiltin
+// nhúng nó làm bản có sẵn khi không có levels.lvp. Game.cbp chạy bước này trước
+// mỗi lần build nên cả hai luôn khớp levels/main.txt.
+//
+// Mỗi dòng một lệnh, '#' tới cuối dòng là chú thích, chuỗi có dấu cách đặt trong "":
+//
+//   pack "Main Levels"
+//   level "Easy Valley"
+//       theme grassland                 # grassland | desert | forest | mountain | volcano
+//       target 50                       # Điểm để qua màn
+//       spawn 90                        # Khoảng spawn vật cản (frame), mặc định 90
+//       meteor 250                      # Khoảng thiên thạch (frame), mặc định 300
+//       speed 6 0.5 600 0               # base, tăng mỗi nấc, frame mỗi nấc, trần (0: không trần)
+//       obstacles cactus_small=40 bird=10   # Loại không ghi có trọng số 0; bỏ dòng: bảng mặc định
+//       coins normal=45 gold=15
+//       at 600 obstacle bird 140        # Sự kiện: frame, hành động, loại, [lift]
+//       at 900 coin gold
+//       at 1200 powerup shield
+//       at 1500 meteor
+//   end
+//
+// Build: g++ -O2 -I.. level_compiler.cpp -o level_compiler
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "level_pack.h"
+#include "alias_table.h"
+#include "DifficultyManager.h"
+#include "obstacle.h"
+#include "embedded_image.h"
+
+// Theo thứ tự enum của game (ObstacleType, CoinType, PowerUpType, MapThemeType)
+static const char* OBSTACLE_NAMES[] = { "cactus_small", "cactus_medium", "cactus_large", "cactus_group",
+                                        "bird", "meteor", "rock" };
+static const char* COIN_NAMES[] = { "normal", "silver", "gold", "xp" };
+static const char* POWERUP_NAMES[] = { "shield", "speed_boost", "magnet", "dash" };
+static const char* THEME_NAMES[] = { "grassland", "desert", "forest", "mountain", "volcano" };
+static const char* ACTION_NAMES[] = { "obstacle", "coin", "powerup", "meteor" };
+static const int OBSTACLE_COUNT = sizeof(OBSTACLE_NAMES) / sizeof(OBSTACLE_NAMES[0]);
+static const int COIN_COUNT = sizeof(COIN_NAMES) / sizeof(COIN_NAMES[0]);
+static const int POWERUP_COUNT = sizeof(POWERUP_NAMES) / sizeof(POWERUP_NAMES[0]);
+
+SDL_COMPILE_TIME_ASSERT(theme_names, sizeof(THEME_NAMES) / sizeof(THEME_NAMES[0]) == LEVEL_THEME_COUNT);
+SDL_COMPILE_TIME_ASSERT(action_names, sizeof(ACTION_NAMES) / sizeof(ACTION_NAMES[0]) == LEVEL_EVENT_ACTION_COUNT);
+SDL_COMPILE_TIME_ASSERT(obstacle_names, sizeof(OBSTACLE_NAMES) / sizeof(OBSTACLE_NAMES[0]) == OBSTACLE_TYPE_COUNT);
+
+struct LevelSource {
+    std::string name;
+    LevelIndexEntry entry;
+    LevelRecord record;
+    std::vector<LevelEvent> events;
+};
+
+static std::string sourcePath;
+static int lineNumber = 0;
+
+static bool fail(const std::string& message) {
+    std::cerr << sourcePath << ":" << lineNumber << ": " << message << std::endl;
+    return false;
+}
+
+// Tách dòng thành token; "..." là một token, '#' ngoài chuỗi bắt đầu chú thích
+static bool tokenize(const std::string& line, std::vector<std::string>& tokens) {
+    tokens.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        char c = line[i];
+        if (c == '#') break;
+        if (c == ' ' || c == '\t' || c == '\r') { i++; continue; }
+        if (c == '"') {
+            size_t end = line.find('"', i + 1);
+            if (end == std::string::npos) return fail("unterminated string");
+            tokens.push_back(line.substr(i + 1, end - i - 1));
+            i = end + 1;
+            continue;
+        }
+        size_t end = i;
+        while (end < line.size() && line[end] != ' ' && line[end] != '\t' && line[end] != '\r' && line[end] != '#') end++;
+        tokens.push_back(line.substr(i, end - i));
+        i = end;
+    }
+    return true;
+}
+
+static int findName(const char* const* names, int count, const std::string& name) {
+    for (int i = 0; i < count; i++) {
+        if (name == names[i]) return i;
+    }
+    return -1;
+}
+
+static bool parseInt(const std::string& text, long minValue, long maxValue, long& out) {
+    char* end = nullptr;
+    out = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || out < minValue || out > maxValue)
+        return fail("expected an integer in [" + std::to_string(minValue) + ", " + std::to_string(maxValue) + "], got '" + text + "'");
+    return true;
+}
+
+static bool parseFloat(const std::string& text, float& out) {
+    char* end = nullptr;
+    out = std::strtof(text.c_str(), &end);
+    if (text.empty() || *end != '\0') return fail("expected a number, got '" + text + "'");
+    return true;
+}
+
+// name=weight ... -> weights[] (loại không ghi = 0)
+static bool parseWeights(const std::vector<std::string>& tokens, const char* const* names, int count, Uint16* weights) {
+    for (size_t t = 1; t < tokens.size(); t++) {
+        size_t eq = tokens[t].find('=');
+        int kind = eq == std::string::npos ? -1 : findName(names, count, tokens[t].substr(0, eq));
+        if (kind < 0) return fail("unknown weight '" + tokens[t] + "'");
+        long weight;
+        if (!parseInt(tokens[t].substr(eq + 1), 0, 32767, weight)) return false;
+        weights[kind] = (Uint16)weight;
+    }
+    int check[LEVEL_MAX_WEIGHTS] = {};
+    for (int i = 0; i < count; i++) check[i] = weights[i];
+    if (!weightsValid(check)) return fail("weights must be >= 0 with a total in 1..32767");
+    return true;
+}
+
+static void resetLevel(LevelSource& level, const std::string& name) {
+    level.name = name;
+    memset(&level.entry, 0, sizeof(level.entry));
+    memset(&level.record, 0, sizeof(level.record));
+    SpeedCurve curve;
+    level.record.spawnInterval = 90;
+    level.record.meteorInterval = 300;
+    level.record.baseSpeed = curve.baseSpeed;
+    level.record.speedIncrement = curve.increment;
+    level.record.speedInterval = (Uint32)curve.interval;
+    level.record.maxSpeed = curve.maxSpeed;
+    level.entry.targetScore = 0;
+    level.entry.theme = 0;
+    level.events.clear();
+}
+
+static bool parseLevelLine(const std::vector<std::string>& tokens, LevelSource& level) {
+    const std::string& command = tokens[0];
+    LevelRecord& record = level.record;
+    long value;
+
+    if (command == "theme" && tokens.size() == 2) {
+        int theme = findName(THEME_NAMES, LEVEL_THEME_COUNT, tokens[1]);
+        if (theme < 0) return fail("unknown theme '" + tokens[1] + "'");
+        level.entry.theme = (Uint32)theme;
+    } else if (command == "target" && tokens.size() == 2) {
+        if (!parseInt(tokens[1], 1, 1000000000, value)) return false;
+        level.entry.targetScore = (Uint32)value;
+    } else if (command == "spawn" && tokens.size() == 2) {
+        if (!parseInt(tokens[1], 1, 100000, value)) return false;
+        record.spawnInterval = (Uint32)value;
+    } else if (command == "meteor" && tokens.size() == 2) {
+        if (!parseInt(tokens[1], 1, 100000, value)) return false;
+        record.meteorInterval = (Uint32)value;
+    } else if (command == "speed" && (tokens.size() == 4 || tokens.size() == 5)) {
+        if (!parseFloat(tokens[1], record.baseSpeed) || !parseFloat(tokens[2], record.speedIncrement) ||
+            !parseInt(tokens[3], 1, 1000000, value)) return false;
+        record.speedInterval = (Uint32)value;
+        record.maxSpeed = 0.0f;
+        if (tokens.size() == 5 && !parseFloat(tokens[4], record.maxSpeed)) return false;
+        // Game kiểm tra y hệt khi nạp; endless cần base dưới trần của nó
+        if (record.baseSpeed <= 0.0f || record.baseSpeed >= DifficultyManager::ENDLESS_MAX_SPEED)
+            return fail("base speed must be in (0, " + std::to_string((int)DifficultyManager::ENDLESS_MAX_SPEED) + ")");
+        if (record.speedIncrement < 0.0f) return fail("speed increment must be >= 0");
+        if (record.maxSpeed != 0.0f && record.maxSpeed <= record.baseSpeed) return fail("max speed must be 0 or above base speed");
+    } else if (command == "obstacles" && tokens.size() >= 2) {
+        if (!parseWeights(tokens, OBSTACLE_NAMES, OBSTACLE_COUNT, record.obstacleWeights)) return false;
+        record.flags |= LEVEL_OBSTACLE_WEIGHTS;
+    } else if (command == "coins" && tokens.size() >= 2) {
+        if (!parseWeights(tokens, COIN_NAMES, COIN_COUNT, record.coinWeights)) return false;
+        record.flags |= LEVEL_COIN_WEIGHTS;
+    } else if (command == "at" && tokens.size() >= 3) {
+        LevelEvent event;
+        if (!parseInt(tokens[1], 0, 0x7fffffff, value)) return false;
+        event.frame = (Uint32)value;
+        int action = findName(ACTION_NAMES, LEVEL_EVENT_ACTION_COUNT, tokens[2]);
+        if (action < 0) return fail("unknown event '" + tokens[2] + "'");
+        event.action = (Uint8)action;
+        event.kind = 0;
+        event.lift = -1;
+
+        size_t next = 3;
+        if (action != LEVEL_EVENT_METEOR) {
+            if (tokens.size() < 4) return fail(std::string(ACTION_NAMES[action]) + " event needs a type");
+            int kind = action == LEVEL_EVENT_OBSTACLE ? findName(OBSTACLE_NAMES, OBSTACLE_COUNT, tokens[3])
+                     : action == LEVEL_EVENT_COIN ? findName(COIN_NAMES, COIN_COUNT, tokens[3])
+                     : findName(POWERUP_NAMES, POWERUP_COUNT, tokens[3]);
+            if (kind < 0) return fail("unknown " + std::string(ACTION_NAMES[action]) + " type '" + tokens[3] + "'");
+            if (action == LEVEL_EVENT_OBSTACLE && kind == METEOR) return fail("use 'at <frame> meteor' for meteors");
+            event.kind = (Uint8)kind;
+            next = 4;
+        }
+        if (next < tokens.size()) {
+            if (action == LEVEL_EVENT_METEOR) return fail("meteor event takes no lift");
+            if (!parseInt(tokens[next], 0, 400, value)) return false;
+            event.lift = (Sint16)value;
+            next++;
+        }
+        if (next != tokens.size()) return fail("too many arguments");
+        if (level.events.size() >= LEVEL_MAX_EVENTS) return fail("too many events (max " + std::to_string(LEVEL_MAX_EVENTS) + ")");
+        level.events.push_back(event);
+    } else {
+        return fail("unknown or malformed line '" + command + "'");
+    }
+    return true;
+}
+
+static bool parseSource(std::istream& in, std::string& title, std::vector<LevelSource>& levels) {
+    std::string line;
+    std::vector<std::string> tokens;
+    LevelSource level;
+    bool inLevel = false;
+
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!tokenize(line, tokens)) return false;
+        if (tokens.empty()) continue;
+
+        if (tokens[0] == "pack" && tokens.size() == 2 && !inLevel) {
+            if (tokens[1].size() >= (size_t)LEVEL_PACK_TITLE_LENGTH)
+                return fail("pack title too long (max " + std::to_string(LEVEL_PACK_TITLE_LENGTH - 1) + ")");
+            title = tokens[1];
+        } else if (tokens[0] == "level" && tokens.size() == 2 && !inLevel) {
+            if (tokens[1].empty() || tokens[1].size() >= (size_t)LEVEL_NAME_LENGTH)
+                return fail("level name must be 1.." + std::to_string(LEVEL_NAME_LENGTH - 1) + " characters");
+            resetLevel(level, tokens[1]);
+            inLevel = true;
+        } else if (tokens[0] == "end" && tokens.size() == 1 && inLevel) {
+            if (level.entry.targetScore == 0) return fail("level '" + level.name + "' has no target");
+            // Game chạy sự kiện theo thứ tự frame; cùng frame giữ thứ tự trong file
+            std::stable_sort(level.events.begin(), level.events.end(),
+                             [](const LevelEvent& a, const LevelEvent& b) { return a.frame < b.frame; });
+            levels.push_back(level);
+            inLevel = false;
+        } else if (inLevel) {
+            if (!parseLevelLine(tokens, level)) return false;
+        } else {
+            return fail("expected 'pack', 'level' or 'end'");
+        }
+    }
+    if (inLevel) return fail("level '" + level.name + "' is missing 'end'");
+    if (levels.empty()) return fail("no levels");
+    return true;
+}
+
+static void append(std::vector<char>& image, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    image.insert(image.end(), bytes, bytes + size);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: level_compiler <input.txt> <output.lvp> [<builtin.inc>]" << std::endl;
+        return 1;
+    }
+    sourcePath = argv[1];
+    std::string outputPath = argv[2];
+
+    std::ifstream in(sourcePath);
+    if (!in.is_open()) {
+        std::cerr << "Could not read " << sourcePath << std::endl;
+        return 1;
+    }
+    std::string title;
+    std::vector<LevelSource> levels;
+    if (!parseSource(in, title, levels)) return 1;
+
+    LevelPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LEVEL_PACK_MAGIC, sizeof(header.magic));
+    header.version = LEVEL_PACK_VERSION;
+    header.levelCount = (Uint32)levels.size();
+    header.indexOffset = sizeof(LevelPackHeader);
+    strncpy(header.title, title.c_str(), LEVEL_PACK_TITLE_LENGTH - 1);
+
+    // Record nối tiếp ngay sau index; mọi kích thước là bội của 8 nên record luôn thẳng hàng
+    Uint64 offset = header.indexOffset + sizeof(LevelIndexEntry) * levels.size();
+    for (LevelSource& level : levels) {
+        level.record.eventCount = (Uint32)level.events.size();
+        strncpy(level.entry.name, level.name.c_str(), LEVEL_NAME_LENGTH - 1);
+        level.entry.recordOffset = (Uint32)offset;
+        level.entry.recordSize = (Uint32)(sizeof(LevelRecord) + sizeof(LevelEvent) * level.events.size());
+        offset += level.entry.recordSize;
+    }
+    if (offset > 0xffffffffULL) {
+        std::cerr << "Level pack too large" << std::endl;
+        return 1;
+    }
+
+    std::vector<char> image;
+    image.reserve((size_t)offset);
+    append(image, &header, sizeof(header));
+    for (const LevelSource& level : levels) {
+        append(image, &level.entry, sizeof(level.entry));
+    }
+    for (const LevelSource& level : levels) {
+        append(image, &level.record, sizeof(level.record));
+        if (!level.events.empty()) append(image, level.events.data(), sizeof(LevelEvent) * level.events.size());
+        std::cout << "  " << level.name << " (" << THEME_NAMES[level.entry.theme] << ", target "
+                  << level.entry.targetScore << ", " << level.events.size() << " events)" << std::endl;
+    }
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Could not create " << outputPath << std::endl;
+        return 1;
+    }
+    out.write(image.data(), image.size());
+    out.close();
+    if (out.fail()) {
+        std::cerr << "Could not write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << outputPath << ": " << levels.size() << " levels, " << image.size() << " bytes" << std::endl;
+
+    if (argc == 4) {
+        if (!writeEmbeddedImage(argv[3], "LEVELS_BUILTIN", "level_compiler", sourcePath, image)) {
+            std::cerr << "Could not write " << argv[3] << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << argv[3] << std::endl;
+    }
+    return 0;
+}
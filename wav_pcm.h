@@ -0,0 +1,52 @@
+#ifndef WAV_PCM_H_INCLUDED
+#define WAV_PCM_H_INCLUDED
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+// WAV PCM 16-bit (asset_packer --pcm giải mã sẵn nhạc thành dạng này) đọc
+// thẳng từ bộ nhớ, không qua SDL_mixer nên có thể xử lý từng block.
+
+inline Uint16 readLE16(const char* p) {
+    Uint16 value;
+    memcpy(&value, p, sizeof(value));
+    return SDL_SwapLE16(value);
+}
+
+inline Uint32 readLE32(const char* p) {
+    Uint32 value;
+    memcpy(&value, p, sizeof(value));
+    return SDL_SwapLE32(value);
+}
+
+// Tìm khối data (mẫu S16LE xen kẽ), trỏ thẳng vào data. false nếu không
+// phải WAV PCM 16-bit hoặc khối data lệch căn lề
+inline bool findWavPcm16(const char* data, size_t size, const char*& samples, Uint32& bytes,
+                         int& rate, int& channels) {
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) return false;
+
+    bool haveFormat = false;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const char* body = data + pos + 8;
+        Uint32 length = readLE32(data + pos + 4);
+        size_t available = size - pos - 8;
+        if (memcmp(data + pos, "fmt ", 4) == 0 && length >= 16 && available >= 16) {
+            channels = readLE16(body + 2);
+            rate = (int)readLE32(body + 4);
+            if (readLE16(body) != 1 || readLE16(body + 14) != 16 || channels < 1 || rate <= 0) return false;
+            haveFormat = true;
+        } else if (memcmp(data + pos, "data", 4) == 0) {
+            samples = body;
+            bytes = (Uint32)std::min<size_t>(length, available);
+            return haveFormat && reinterpret_cast<uintptr_t>(body) % sizeof(Sint16) == 0;
+        }
+        if (length > available) break;
+        pos += 8 + (size_t)length + (length & 1);
+    }
+    return false;
+}
+
+#endif // WAV_PCM_H_INCLUDED
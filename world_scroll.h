@@ -0,0 +1,37 @@
+#ifndef WORLD_SCROLL_H_INCLUDED
+#define WORLD_SCROLL_H_INCLUDED
+
+#include <cmath>
+
+// Vật cản, xu và power-up đứng yên trong toạ độ thế giới; chỉ có offset cuộn
+// tăng theo tốc độ mỗi frame. Toạ độ màn hình chỉ tính khi va chạm và vẽ.
+// offset là double để chạy lâu vẫn giữ được phần lẻ của pixel; chơi không
+// giới hạn (endless) thì Game dời gốc định kỳ để offset luôn nhỏ.
+class WorldScroll {
+public:
+    // Dời gốc khi offset vượt mốc này (~1M px, vài chục phút ở tốc độ trần)
+    static constexpr double REBASE_DISTANCE = 1048576.0;
+
+    WorldScroll() : offset(0.0), speed(0.0f) {}
+
+    void reset() { offset = 0.0; }
+    void setSpeed(float pixelsPerFrame) { speed = pixelsPerFrame; }
+    void advance() { offset += speed; }
+    // Dời gốc toạ độ thế giới lùi shift px (shift nguyên: phần lẻ giữ nguyên)
+    void rebase(double shift) { offset -= shift; }
+
+    double getOffset() const { return offset; }
+    bool needsRebase() const { return offset >= REBASE_DISTANCE; }
+    float getSpeed() const { return speed; }
+
+    int toScreen(double worldX) const { return (int)std::floor(worldX - offset); }
+    double toWorld(int screenX) const { return screenX + offset; }
+    // Vật rộng `width` bắt đầu ở worldX đã trôi hết qua mép trái
+    bool isBehind(double worldX, int width) const { return worldX + width < offset; }
+
+private:
+    double offset;
+    float speed;
+};
+
+#endif // WORLD_SCROLL_H_INCLUDED